@@ -51,13 +51,31 @@
 #ifndef SCA_AC_NOISE_START_H_
 #define SCA_AC_NOISE_START_H_
 
+/*
+ * Implementation-defined: the noise contributions are calculated by default
+ * for all noise sources with one pass over the factorized equation system
+ * per block of sources (SCA_NOISE_DIRECT). With SCA_NOISE_ADJOINT one solution
+ * of the transposed equation system per traced signal is calculated instead,
+ * which is faster, if the number of noise sources exceeds the number of
+ * traced signals. The contributions of the traced signals are the same, the
+ * untraced signals are not calculated. If a module is traced, the direct
+ * method is used.
+ */
+
 namespace sca_ac_analysis
 {
 
+enum sca_ac_noise_method
+{
+	SCA_NOISE_DIRECT, SCA_NOISE_ADJOINT
+};
+
 void sca_ac_noise_start(double start_freq, double stop_freq,
-		unsigned long npoints, sca_ac_analysis::sca_ac_scale scale = sca_ac_analysis::SCA_LOG);
+		unsigned long npoints, sca_ac_analysis::sca_ac_scale scale = sca_ac_analysis::SCA_LOG,
+		sca_ac_analysis::sca_ac_noise_method method = sca_ac_analysis::SCA_NOISE_DIRECT);
 
-void sca_ac_noise_start(const sca_util::sca_vector<double>& frequencies);
+void sca_ac_noise_start(const sca_util::sca_vector<double>& frequencies,
+		sca_ac_analysis::sca_ac_noise_method method = sca_ac_analysis::SCA_NOISE_DIRECT);
 
 } // namespace sca_ac
 
@@ -64,6 +64,34 @@ void sca_ac_start(double start_freq, double stop_freq, unsigned long npoints,
 
 void sca_ac_start(const sca_util::sca_vector<double>& frequencies);
 
+/*
+ * Implementation-defined: adaptive small-signal frequency-domain simulation.
+ * The simulation starts with npoints frequencies between start_freq and
+ * stop_freq distributed as for sca_ac_start. Each interval between two
+ * neighbouring frequencies, where the magnitude of a traced quantity changes
+ * relatively more than mag_tol or its phase more than phase_tol (in degree),
+ * is bisected (logarithmically for sca_ac::SCA_LOG, otherwise linear). The
+ * bisection is repeated until all intervals are within the tolerances or
+ * max_points frequencies have been calculated - the intervals with the largest
+ * change are bisected first. The results are written to the traces in
+ * ascending frequency order.
+ */
+void sca_ac_start_adaptive(double start_freq, double stop_freq,
+		unsigned long npoints, unsigned long max_points,
+		sca_ac_analysis::sca_ac_scale scale = sca_ac_analysis::SCA_LOG,
+		double mag_tol = 0.05, double phase_tol = 5.0);
+
+/*
+ * Implementation-defined: sets the number of threads, which solve the
+ * frequency points of sca_ac_start and sca_ac_noise_start. The value zero
+ * selects the number of hardware threads, the value one the sequential
+ * calculation. The equation setup and the tracing are performed in frequency
+ * order, thus the results do not depend on the number of threads. The
+ * setting is ignored, if the library has been built without parallel ac
+ * analysis support.
+ */
+void sca_ac_set_number_of_threads(unsigned long n_threads = 0);
+
 } // namespace sca_ac
 
 #endif /* SCA_AC_START_H_ */
@@ -58,8 +58,10 @@ sca_ac_domain_db::sca_ac_domain_db()
     current_x=NULL;
     current_y=NULL;
     current_w=0.0;
+    frequency_accessed=false;
     initialized=false;
     elaborated=false;
+    number_of_threads=0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -99,14 +99,28 @@ public:
 
     inline double get_current_freq()
     {
+        frequency_accessed=true;
         return current_w/(2.0*M_PI);
     }
 
     inline double get_current_w()
     {
+        frequency_accessed=true;
         return current_w;
     }
 
+    //signs whether the current frequency was requested since the last reset
+    // -> used to detect frequency independent ac entities
+    inline void reset_frequency_access()
+    {
+        frequency_accessed=false;
+    }
+
+    inline bool is_frequency_accessed()
+    {
+        return frequency_accessed;
+    }
+
     inline bool is_ac_domain()
     {
         return ac_domain;
@@ -153,6 +167,17 @@ public:
     	elaborated=true;
     }
 
+    //number of threads for the frequency sweeps (0 - hardware threads)
+    unsigned long get_number_of_threads()
+    {
+    	return number_of_threads;
+    }
+
+    void set_number_of_threads(unsigned long n_threads)
+    {
+    	number_of_threads=n_threads;
+    }
+
 
     long get_arc_id(const sc_core::sc_interface* arc) const;
     long get_port_id(const sc_core::sc_port_base* port);
@@ -165,6 +190,7 @@ public:
 private:
 
     double current_w;
+    bool   frequency_accessed;
 
     sca_util::sca_vector<sca_util::sca_complex >* current_x;
     sca_util::sca_vector<sca_util::sca_complex >* current_y;
@@ -208,6 +234,8 @@ private:
     bool initialized;
 
     bool elaborated;
+
+    unsigned long number_of_threads;
 };
 
 
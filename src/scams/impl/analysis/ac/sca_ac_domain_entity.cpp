@@ -77,7 +77,9 @@ sca_ac_domain_entity::sca_ac_domain_entity(sc_core::sc_module* mod) :
         qe( NULL ),
         module( mod ),
         solver( NULL ),
-        obj( dynamic_cast<sca_ac_analysis::sca_ac_module*>(mod) )
+        obj( dynamic_cast<sca_ac_analysis::sca_ac_module*>(mod) ),
+        stamp_state( STAMPS_UNKNOWN ),
+        record_stamps( false )
 {
 	//shoulb never happen
 	if(obj==NULL)
@@ -105,7 +107,9 @@ sca_ac_domain_entity::sca_ac_domain_entity(sca_core::sca_implementation::sca_sol
         qe( NULL ),
         module( NULL ),
         solver( solv ),
-        obj( dynamic_cast<sca_ac_analysis::sca_ac_object*>(solv) )
+        obj( dynamic_cast<sca_ac_analysis::sca_ac_object*>(solv) ),
+        stamp_state( STAMPS_UNKNOWN ),
+        record_stamps( false )
 {
 	//shoulb never happen
 	if(obj==NULL)
@@ -502,11 +506,16 @@ void sca_ac_domain_entity::computeAB_insert( sca_util::sca_matrix<sca_util::sca_
             long outport_eq = outport_arcs[opc];
 
             Ag(outport_eq, outport_eq) = -1.0;	//outport "variable"
+            record(sca_ac_stamp::AG_ASSIGN,outport_eq,outport_eq,-1.0);
 
             for(unsigned long ipc=0; ipc<inport_arcs.size(); ++ipc)
+            {
                 Ag(inport_arcs[ipc],outport_eq) += A(ipc,opc);
+                record(sca_ac_stamp::AG_ADD,inport_arcs[ipc],outport_eq,A(ipc,opc));
+            }
 
             Bg(outport_eq) = -B[opc];
+            record(sca_ac_stamp::BG_ASSIGN,outport_eq,0,-B[opc]);
         }
     }
 }
@@ -562,6 +571,8 @@ void sca_ac_domain_entity::setup_add_eqs(
     	while(next_entry) //real contribution
     	{
     		Ag(start_of_add_eqs+y_pos,start_of_add_eqs+x_pos) = sca_util::sca_complex(*next_entry,0.0);
+    		record(sca_ac_stamp::AG_ASSIGN,start_of_add_eqs+y_pos,start_of_add_eqs+x_pos,
+    				sca_util::sca_complex(*next_entry,0.0));
     		next_entry=sparse_get_next_entry(sm,&x_pos,&y_pos,&actual_index);
     	}
 
@@ -575,12 +586,15 @@ void sca_ac_domain_entity::setup_add_eqs(
     	{
     		sca_util::sca_complex tmp=Ag(start_of_add_eqs+y_pos,start_of_add_eqs+x_pos);
     		Ag(start_of_add_eqs+y_pos,start_of_add_eqs+x_pos) = sca_util::sca_complex(tmp.real(),*next_entry*w);
+    		record(sca_ac_stamp::AG_IMAG_JW,start_of_add_eqs+y_pos,start_of_add_eqs+x_pos,
+    				*next_entry);
     		next_entry=sparse_get_next_entry(sm,&x_pos,&y_pos,&actual_index);
     	}
 
     	for (unsigned long i=0, eqnr=start_of_add_eqs; i<number_of_add_eqs; ++i, ++eqnr)
     	{
     		Bg(eqnr) = -cb[i];	// only real input data! (real qe)
+    		record(sca_ac_stamp::BG_ASSIGN,eqnr,0,-cb[i]);
     	}
 
     }
@@ -593,8 +607,11 @@ void sca_ac_domain_entity::setup_add_eqs(
     		{   // attention on order of dimensions!
     			Ag(start_of_add_eqs+j,eqnr) =
     					sca_util::sca_complex((*Be)(i,j),w * (*Ae)(i,j));
+    			record(sca_ac_stamp::AG_ASSIGN_JW,start_of_add_eqs+j,eqnr,
+    					sca_util::sca_complex((*Be)(i,j),(*Ae)(i,j)));
     		}
     		Bg(eqnr) = -cb[i];	// only real input data! (real qe)
+    		record(sca_ac_stamp::BG_ASSIGN,eqnr,0,-cb[i]);
     	}
     }
 /*
@@ -629,7 +646,10 @@ void sca_ac_domain_entity::setup_add_eqs(
 
         //ignore contribution of -B
         for(unsigned long j=0, eqnr=start_of_add_eqs; j<number_of_add_eqs; ++j, ++eqnr)
+        {
             Ag(inport_eq,eqnr) += Bg(eqnr) + cb[j];
+            record(sca_ac_stamp::AG_ADD,inport_eq,eqnr,Bg(eqnr) + cb[j]);
+        }
     }
 
 
@@ -639,15 +659,100 @@ void sca_ac_domain_entity::setup_add_eqs(
         unsigned long outport_eq = outport_arcs[i];
 
         Ag(outport_eq,outport_eq) = -1.0;	//outport "variable"
+        record(sca_ac_stamp::AG_ASSIGN,outport_eq,outport_eq,-1.0);
 
         if(out_con_matrix)
             for(unsigned long j=0; j<number_of_add_eqs; ++j)
+            {
                 Ag(start_of_add_eqs+j,outport_eq) = (*out_con_matrix)(j,i);
+                record(sca_ac_stamp::AG_ASSIGN,start_of_add_eqs+j,outport_eq,
+                		(*out_con_matrix)(j,i));
+            }
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void sca_ac_domain_entity::insert_equations(
+		sca_util::sca_matrix<sca_util::sca_complex >& Ag,
+		sca_util::sca_vector<sca_util::sca_complex >& Bg,
+		sca_util::sca_vector<sca_util::sca_complex >& Bgnoise,
+        double w )
+{
+	if(stamp_state==STAMPS_VALID)
+	{
+		//replay the writes of the first frequency point in the same order
+		for(std::vector<sca_ac_stamp>::iterator sit=stamps.begin();
+		    sit!=stamps.end(); ++sit)
+		{
+			switch(sit->kind)
+			{
+			case sca_ac_stamp::AG_ASSIGN:
+				Ag(sit->x,sit->y) = sit->value;
+				break;
+			case sca_ac_stamp::AG_ADD:
+				Ag(sit->x,sit->y) += sit->value;
+				break;
+			case sca_ac_stamp::AG_ASSIGN_JW:
+				Ag(sit->x,sit->y) =
+						sca_util::sca_complex(sit->value.real(),w * sit->value.imag());
+				break;
+			case sca_ac_stamp::AG_IMAG_JW:
+			{
+				sca_util::sca_complex tmp=Ag(sit->x,sit->y);
+				Ag(sit->x,sit->y) = sca_util::sca_complex(tmp.real(),sit->value.real()*w);
+				break;
+			}
+			case sca_ac_stamp::BG_ASSIGN:
+				Bg(sit->x) = sit->value;
+				break;
+			case sca_ac_stamp::BGNOISE_ASSIGN:
+				Bgnoise(sit->x) = sit->value;
+				break;
+			}
+		}
+		return;
+	}
+
+	//an entity is frequency dependent if it accesses the current frequency
+	//(sca_ac_f, sca_ac_w, sca_ac_s, sca_ac_z, sca_ac_delay, ...)
+	record_stamps=(stamp_state==STAMPS_UNKNOWN);
+	ac_db->reset_frequency_access();
+
+    //first setup additional equations
+	setup_add_eqs(Ag, Bg, w);
+
+    //then setup node contributions
+	computeAB_insert(Ag, Bg, w);
+
+	if(record_stamps)
+	{
+		//noise sources are assigned to the outports of the entity
+		for(unsigned long opc=0; opc<outport_arcs.size(); ++opc)
+		{
+			if(Bgnoise(outport_arcs[opc])!=0.0)
+			{
+				record(sca_ac_stamp::BGNOISE_ASSIGN,outport_arcs[opc],0,
+						Bgnoise(outport_arcs[opc]));
+			}
+		}
+
+		record_stamps=false;
+
+		if(ac_db->is_frequency_accessed())
+		{
+			stamp_state=STAMPS_FREQUENCY_DEPENDENT;
+			stamps.clear();
+		}
+		else
+		{
+			stamp_state=STAMPS_VALID;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 
 } // namespace sca_implementation
 } // namespace sca_ac_analysis
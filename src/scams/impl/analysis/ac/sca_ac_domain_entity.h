@@ -59,6 +59,31 @@ namespace sca_implementation
 {
 class sca_ac_domain_db;
 
+//write of an entity to the global equation system, the writes of entities
+//which don't access the frequency are recorded and replayed in the same
+//order for the following frequency points
+struct sca_ac_stamp
+{
+    enum kinds
+    {
+        AG_ASSIGN,     //Ag(x,y)  = value
+        AG_ADD,        //Ag(x,y) += value
+        AG_ASSIGN_JW,  //Ag(x,y)  = value.real() + jw * value.imag()
+        AG_IMAG_JW,    //imaginary part of Ag(x,y) = w * value.real()
+        BG_ASSIGN,     //Bg(x)    = value
+        BGNOISE_ASSIGN //Bgnoise(x) = value
+    };
+
+    kinds                 kind;
+    unsigned long         x;
+    unsigned long         y;
+    sca_util::sca_complex value;
+
+    sca_ac_stamp(kinds kind_, unsigned long x_, unsigned long y_,
+                 const sca_util::sca_complex& value_) :
+        kind(kind_), x(x_), y(y_), value(value_) {}
+};
+
 class sca_ac_domain_entity
 {
     // wrapper for callback methods
@@ -84,6 +109,26 @@ public:
     		           sca_util::sca_vector<sca_util::sca_complex >& Bg,
                        double w);
 
+    // setup additional equations and node contributions - if the entity
+    // doesn't access the frequency, the writes of the first call are replayed
+    // by the following calls without evaluating the entity again
+    void insert_equations(sca_util::sca_matrix<sca_util::sca_complex >& Ag,
+    		              sca_util::sca_vector<sca_util::sca_complex >& Bg,
+    		              sca_util::sca_vector<sca_util::sca_complex >& Bgnoise,
+                          double w);
+
+    // the entity is evaluated again by the next insert_equations
+    void invalidate_stamps()
+    {
+        stamp_state=STAMPS_UNKNOWN;
+        stamps.clear();
+    }
+
+    bool is_frequency_dependent() const
+    {
+        return stamp_state==STAMPS_FREQUENCY_DEPENDENT;
+    }
+
     // initializes all ports of the entity (solver / module)
     void initialize();
 
@@ -136,6 +181,24 @@ private:
     sca_core::sca_implementation::sca_solver_base*  solver;
 
     sca_ac_analysis::sca_ac_object* obj;
+
+    // recorded writes of a frequency independent entity
+    enum stamp_states
+    {
+        STAMPS_UNKNOWN,              //evaluate and record
+        STAMPS_VALID,                //replay
+        STAMPS_FREQUENCY_DEPENDENT   //evaluate for each frequency point
+    };
+
+    stamp_states              stamp_state;
+    bool                      record_stamps;
+    std::vector<sca_ac_stamp> stamps;
+
+    void record(sca_ac_stamp::kinds kind, unsigned long x, unsigned long y,
+                const sca_util::sca_complex& value)
+    {
+        if(record_stamps) stamps.push_back(sca_ac_stamp(kind,x,y,value));
+    }
 };
 
 
@@ -122,15 +122,12 @@ void sca_ac_domain_eq::setup_equations(double w)
   Bg.reset();
   Bgnoise.reset();
 
-  //calculate instance matrices and insert in global eq
+  //calculate instance matrices and insert in global eq - entities, which
+  //don't access the frequency, are evaluated at the first point only
   for(std::vector<sca_ac_domain_entity*>::iterator iit=ac_data.entities.begin();
       iit<ac_data.entities.end(); ++iit)
   {
-    //first setup additional equations
-    (*iit)->setup_add_eqs(Ag, Bg, w);
-
-    //then setup node contributions
-    (*iit)->computeAB_insert(Ag, Bg, w);
+    (*iit)->insert_equations(Ag, Bg, Bgnoise, w);
   }
 }
 
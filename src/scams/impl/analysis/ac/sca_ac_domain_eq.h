@@ -40,6 +40,7 @@
 #define SCA_AC_DOMAIN_EQ_H_
 
 #include "scams/impl/analysis/ac/sca_ac_domain_db.h"
+#include "scams/impl/analysis/ac/sca_ac_domain_entity.h"
 
 namespace sca_ac_analysis
 {
@@ -95,6 +96,25 @@ public:
 
   void setup_equations(double w);
 
+  //forces the evaluation of all entities at the next frequency point -
+  //must be called before each frequency sweep
+  void invalidate_frequency_independent_part()
+  {
+	  for(std::vector<sca_ac_domain_entity*>::iterator iit=ac_data.entities.begin();
+	      iit<ac_data.entities.end(); ++iit)
+		  (*iit)->invalidate_stamps();
+  }
+
+  //number of entities which are re-evaluated for each frequency point
+  unsigned long get_number_of_frequency_dependent_entities()
+  {
+	  unsigned long cnt=0;
+	  for(std::vector<sca_ac_domain_entity*>::iterator iit=ac_data.entities.begin();
+	      iit<ac_data.entities.end(); ++iit)
+		  if((*iit)->is_frequency_dependent()) cnt++;
+	  return cnt;
+  }
+
 private:
 
   sca_ac_domain_db& ac_data;
@@ -49,6 +49,15 @@
 #include "scams/impl/solver/linear/sca_linear_solver.h"
 #include "scams/impl/analysis/ac/sca_ac_domain_globals.h"
 
+#include <set>
+#include <map>
+#include <algorithm>
+
+#ifndef DISABLE_PARALLEL_AC_ANALYSIS
+#include <thread>
+#include <memory>
+#endif
+
 
 namespace sca_ac_analysis
 {
@@ -58,76 +67,130 @@ namespace sca_implementation
 
 
 
-int solve_linear_complex_eq_system::solve(sca_util::sca_matrix<sca_util::sca_complex >& Ac,
-        sca_util::sca_vector<sca_util::sca_complex >& Bc,
-        sca_util::sca_vector<sca_util::sca_complex >& Xc)
+solve_linear_complex_eq_system::solve_linear_complex_eq_system()
 {
 	critical_row=-1;
 	critical_column=-1;
+	sdata=NULL;
+}
 
-    unsigned long dimb=Bc.length();
-    sca_util::sca_vector<double> b(2*dimb);
+solve_linear_complex_eq_system::~solve_linear_complex_eq_system()
+{
+	sca_solve_ac_linear_free(&sdata);
+}
 
-    for(unsigned long i=0; i<dimb; i++)
-    {
-        b(2*i)     =Bc(i).real();      // |  Real(B) |
-        b(2*i+1)   =Bc(i).imag();      // |  Imag(B) |
-    }
 
+void solve_linear_complex_eq_system::store_error_position(unsigned long dim)
+{
+	long row=-1, column=-1;
+	sca_solve_ac_get_error_position(sdata,&row,&column);
 
-    sca_util::sca_vector<double> sigs(2*dimb);
-    sca_solve_ac_linear_data* sdata = NULL;
-    int errc=sca_solve_ac_linear_init((sparse*)Ac.get_sparse_matrix(),&sdata);
+	//if error in imaginary part -> normalize
+	if(row>=long(dim))    row-=dim;
+	if(column>=long(dim)) column-=dim;
 
-    if(errc!=0)
-    {
-    	if(errc==2)
-    	{
-    		long row=-1, column=-1;
-    		sca_solve_ac_get_error_position(sdata,&row,&column);
+	critical_row=row;
+	critical_column=column;
+}
 
-    		//if error in imaginary part -> normalize
-    		if(row>=long(dimb))    row-=dimb;
-    		if(column>=long(dimb)) column-=dimb;
 
-    		critical_row=row;
-    		critical_column=column;
-    	}
+int solve_linear_complex_eq_system::init(sca_util::sca_matrix<sca_util::sca_complex >& Ac)
+{
+	critical_row=-1;
+	critical_column=-1;
 
+    int errc=sca_solve_ac_linear_init((sparse*)Ac.get_sparse_matrix(),&sdata);
+
+    //after an error the next init starts with a new code generation
+    if(errc==2) store_error_position(Ac.n_cols());
+
+    return errc;
+}
 
-        sca_solve_ac_linear_free(&sdata);
-    	return errc;
-    }
 
-    //solving the real equation system
-    errc=sca_solve_ac_linear(b.get_flat(), sigs.get_flat(),&sdata);
+int solve_linear_complex_eq_system::solve(sca_util::sca_vector<double>& b,
+		sca_util::sca_vector<double>& x)
+{
+    //solving the equation system - the complex matrix is decomposed directly,
+    //the real system of double dimension is only used as fallback
+    int errc=sca_solve_ac_linear(b.get_flat(), x.get_flat(),&sdata);
 
     //an error at this stage means the result is may inaccurate
-	if(errc==5)
-	{
-		long row=-1, column=-1;
-		sca_solve_ac_get_error_position(sdata,&row,&column);
+	if(errc==5) store_error_position(b.length()/2);
+
+	return errc;
+}
 
-		//if error in imaginary part -> normalize
-		if(row>=long(dimb))    row-=dimb;
-		if(column>=long(dimb)) column-=dimb;
 
-		critical_row=row;
-		critical_column=column;
-	}
+int solve_linear_complex_eq_system::solve_multi(sca_util::sca_vector<double>& b,
+		sca_util::sca_vector<double>& x, unsigned long nrhs, unsigned long& n_failed)
+{
+	long n_rhs_failed=0;
+    int errc=sca_solve_ac_linear_multi(b.get_flat(), x.get_flat(), long(nrhs),
+    		&n_rhs_failed, &sdata);
+    n_failed=(unsigned long)n_rhs_failed;
+
+	if(errc==5) store_error_position(b.length()/(2*nrhs));
+
+	return errc;
+}
+
+
+int solve_linear_complex_eq_system::solve_transposed(sca_util::sca_vector<double>& b,
+		sca_util::sca_vector<double>& x)
+{
+	return sca_solve_ac_linear_transposed(b.get_flat(), x.get_flat(), &sdata);
+}
+
+
+void solve_linear_complex_eq_system::get_statistics(long& codegen_cnt, long& reuse_cnt)
+{
+	codegen_cnt=0;
+	reuse_cnt=0;
+
+	if(sdata!=NULL) sca_solve_ac_get_statistics(sdata,&codegen_cnt,&reuse_cnt);
+}
 
 
+int solve_linear_complex_eq_system::solve(
+		sca_util::sca_vector<sca_util::sca_complex >& Bc,
+        sca_util::sca_vector<sca_util::sca_complex >& Xc)
+{
+    unsigned long dimb=Bc.length();
+    sca_util::sca_vector<double> b(2*dimb);
+
+    for(unsigned long i=0; i<dimb; i++)
+    {
+        b(2*i)     =Bc(i).real();      // |  Real(B) |
+        b(2*i+1)   =Bc(i).imag();      // |  Imag(B) |
+    }
+
+
+    sca_util::sca_vector<double> sigs(2*dimb);
+
+    int errc=this->solve(b,sigs);
+
     //converting result to complex
     for(unsigned long i=0; i<dimb; i++)
     {
         Xc(i)=sca_util::sca_complex(sigs(2*i),sigs(2*i+1));
     }
 
-    sca_solve_ac_linear_free(&sdata);
     return errc;
 }
 
 
+int solve_linear_complex_eq_system::solve(sca_util::sca_matrix<sca_util::sca_complex >& Ac,
+        sca_util::sca_vector<sca_util::sca_complex >& Bc,
+        sca_util::sca_vector<sca_util::sca_complex >& Xc)
+{
+    int errc=this->init(Ac);
+    if(errc!=0) return errc;
+
+    return this->solve(Bc,Xc);
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 
@@ -136,6 +199,10 @@ sca_ac_domain_solver::sca_ac_domain_solver(sca_ac_domain_db& ac_db,bool noise_do
         ac_data(ac_db),
         equations(ac_db)
 {
+    parallel_codegen_cnt=0;
+    parallel_reuse_cnt=0;
+    noise_adjoint=false;
+
 
     if(!(sca_core::sca_implementation::sca_get_curr_simcontext()->initialized()))
     {
@@ -183,10 +250,16 @@ void sca_ac_domain_solver::solve_complex_eq_system(
     sca_util::sca_vector<sca_util::sca_complex >& Xc
 )
 {
-	solve_linear_complex_eq_system solver;
+	int err=ac_solver.solve(Ac,Bc,Xc);
 
-	int err=solver.solve(Ac,Bc,Xc);
+	report_solve_error(err,ac_solver.critical_row,ac_solver.critical_column);
+}
 
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+void sca_ac_domain_solver::report_solve_error(int err,long row,long column)
+{
     if(err!=0)
     {
         std::ostringstream str;
@@ -198,8 +271,8 @@ void sca_ac_domain_solver::solve_complex_eq_system(
         else if((err==2) || (err==5))
         {
         	//currently only for signals and nodes
-        	sc_core::sc_object* row_obj=this->ac_data.find_object_for_id(solver.critical_row);
-        	sc_core::sc_object* col_obj=this->ac_data.find_object_for_id(solver.critical_column);
+        	sc_core::sc_object* row_obj=this->ac_data.find_object_for_id(row);
+        	sc_core::sc_object* col_obj=this->ac_data.find_object_for_id(column);
 
         	if(err==2)
         	{
@@ -244,12 +317,36 @@ void sca_ac_domain_solver::solve_complex_eq_system(
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 
+//number of noise sources solved in one pass over the factorization
+static const std::size_t SCA_NOISE_RHS_BLOCK=32;
+
 void sca_ac_domain_solver::ac_noise_solver(
     sca_util::sca_matrix<sca_util::sca_complex >& Ac,
     sca_util::sca_vector<sca_util::sca_complex >& Bc,
     std::vector<bool>&                 noise_src_flags,
     sca_util::sca_matrix<sca_util::sca_complex >& result
 )
+{
+	unsigned long n_failed=0;
+
+	int errc=noise_solve(ac_solver,Ac,Bc,noise_src_flags,
+			noise_adjoint ? &noise_output_ids : NULL,result,n_failed);
+
+	report_noise_error(errc,ac_solver.critical_row,ac_solver.critical_column,n_failed);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+int sca_ac_domain_solver::noise_solve(
+    solve_linear_complex_eq_system&               solver,
+    sca_util::sca_matrix<sca_util::sca_complex >& Ac,
+    sca_util::sca_vector<sca_util::sca_complex >& Bc,
+    std::vector<bool>&                 noise_src_flags,
+    const std::vector<long>*           output_ids,
+    sca_util::sca_matrix<sca_util::sca_complex >& result,
+    unsigned long&                     n_failed
+)
 {
     //noise analysis - assumption all b!=0 are independent noise sources
     //for those sources there contribution has to be calculated seperately
@@ -258,12 +355,109 @@ void sca_ac_domain_solver::ac_noise_solver(
     unsigned long dima=Ac.n_cols();
     unsigned long n_equations=dima;
 
+    n_failed=0;
+
     //reset overall noise vector
     for(unsigned long i=0;i<n_equations;i++)
         result(i,0)=0.0;
 
-    sca_solve_ac_linear_data* sdata = NULL;
-    int errc=sca_solve_ac_linear_init((sparse*)Ac.get_sparse_matrix(),&sdata);
+    int errc=solver.init(Ac);
+    if(errc!=0) return errc;
+
+    sca_util::sca_vector<double> b;
+    sca_util::sca_vector<double> xnoise;
+
+    if(output_ids!=NULL)
+    {
+    	//adjoint analysis - the contribution of source i to output o is
+    	//x(o)=(A^-1)(o,i)*Bc(i)=y(i)*Bc(i) with A^T*y=e(o), thus one solution
+    	//of the transposed system is required for each output
+        b.resize(2*n_equations);
+        xnoise.resize(2*n_equations);
+
+        for(std::size_t j=0; j<output_ids->size(); ++j)
+        {
+        	unsigned long o=(unsigned long)((*output_ids)[j]);
+
+            b.reset();
+            b(2*o)=1.0;
+
+            if(solver.solve_transposed(b,xnoise)!=0) n_failed++;
+
+            long n_src=1; //start with row 1 (the first is used for the sum)
+            for(unsigned long i=0; i<n_equations; ++i)
+            {
+                if(noise_src_flags[i])
+                {
+                    sca_util::sca_complex res(xnoise(2*i),xnoise(2*i+1));
+                    res*=Bc(i);
+                    result(o,0)+=norm(res); //the first row is used for the sum
+                    result(o,n_src)=res;
+                    n_src++;
+                }
+            }
+        }
+    }
+    else
+    {
+    	//all sources are solved in blocks with one pass over the factorization
+        std::vector<unsigned long> srcs;
+        for(unsigned long i=0; i<n_equations; ++i)
+        {
+            if(noise_src_flags[i]) srcs.push_back(i);
+        }
+
+        for(std::size_t first=0; first<srcs.size(); first+=SCA_NOISE_RHS_BLOCK)
+        {
+            std::size_t nrhs=srcs.size()-first;
+            if(nrhs>SCA_NOISE_RHS_BLOCK) nrhs=SCA_NOISE_RHS_BLOCK;
+
+            //the right hand sides are stored by lines
+            b.resize(2*n_equations*nrhs);
+            xnoise.resize(2*n_equations*nrhs);
+            b.reset();
+
+            for(std::size_t m=0; m<nrhs; ++m)
+            {
+                unsigned long i=srcs[first+m];
+                b(2*(i*nrhs+m))   = Bc(i).real();
+                b(2*(i*nrhs+m)+1) = Bc(i).imag();
+            }
+
+            //the real fallback counts the failed sources of the block
+            unsigned long n_block_failed=0;
+            solver.solve_multi(b,xnoise,(unsigned long)nrhs,n_block_failed);
+            n_failed+=n_block_failed;
+
+            for(std::size_t m=0; m<nrhs; ++m)
+            {
+                long n_src=(long)(first+m)+1; //the first row is used for the sum
+                for(unsigned long k=0; k<n_equations; ++k)
+                {
+                    sca_util::sca_complex res(xnoise(2*(k*nrhs+m)),
+                                              xnoise(2*(k*nrhs+m)+1));
+                    result(k,0)+=norm(res);
+                    result(k,n_src)=res;
+                }
+            }
+        }
+    }
+
+    //square root of arithmetic sum
+    for(unsigned long j=0; j<n_equations; ++j)
+    {
+        result(j,0)=sqrt(result(j,0).real());
+    }
+
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+void sca_ac_domain_solver::report_noise_error(int errc,long row,long column,
+		unsigned long n_failed)
+{
     if(errc!=0)
     {
         std::ostringstream str;
@@ -274,16 +468,6 @@ void sca_ac_domain_solver::ac_noise_solver(
         }
         else
         {
-            str << " Creation of SparseCode failed for frequency: "
-            << sca_ac_analysis::sca_ac_f() << " Hz"<< std::endl;
-
-        	long row=-1, column=-1;
-        	sca_solve_ac_get_error_position(sdata,&row,&column);
-
-        	//if error in imaginary part -> normalize
-        	if(row>=long(dima))    row-=dima;
-        	if(column>=long(dima)) column-=dima;
-
         	//currently only for signals and nodes
         	sc_core::sc_object* row_obj=this->ac_data.find_object_for_id(row);
         	sc_core::sc_object* col_obj=this->ac_data.find_object_for_id(column);
@@ -313,63 +497,223 @@ void sca_ac_domain_solver::ac_noise_solver(
         }
         SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
     }
-    else
+
+    //one warning for each noise source, which could not be solved
+    for(unsigned long i=0;i<n_failed;i++)
     {
-        sca_util::sca_vector<double> b;
-        sca_util::sca_vector<double> xnoise;
+        std::ostringstream str;
+        str << "Equation solver failed for frequency: "
+        << sca_ac_analysis::sca_ac_f() << " Hz"<< std::endl;
+        SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+    }
+}
 
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
 
-        b.resize(2*n_equations);
-        xnoise.resize(2*n_equations);
+void sca_ac_domain_solver::print_solver_statistics()
+{
+	unsigned long& info_mask(
+	            sca_core::sca_implementation::sca_get_curr_simcontext()->
+	            get_information_mask());
 
-        long n_src=1; //start with row 1 (the first is used for the sum)
-        for(unsigned long i=0; i<n_equations; ++i)
+	if(!(info_mask & (sca_util::sca_info::sca_eln_solver.mask |
+                      sca_util::sca_info::sca_lsf_solver.mask))) return;
+
+	long codegen_cnt, reuse_cnt;
+	ac_solver.get_statistics(codegen_cnt,reuse_cnt);
+
+	//points solved by the threads of a parallel sweep
+	codegen_cnt+=parallel_codegen_cnt;
+	reuse_cnt+=parallel_reuse_cnt;
+
+	if(codegen_cnt+reuse_cnt<=0) return;
+
+	std::ostringstream str;
+	str << std::endl;
+	str << "\tAC solver: " << codegen_cnt+reuse_cnt << " frequency points were";
+	str << " solved, the factorization code was " << codegen_cnt;
+	str << " times generated and for " << reuse_cnt;
+	str << " points the symbolic factorization was reused" << std::endl;
+	str << "\tAC assembly: " << equations.get_number_of_frequency_dependent_entities();
+	str << " of " << equations.get_number_of_entities() << " entities were";
+	str << " evaluated for each frequency point" << std::endl;
+
+	SC_REPORT_INFO("SystemC-AMS",str.str().c_str());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DISABLE_PARALLEL_AC_ANALYSIS
+
+//number of frequency points per thread, which are set up before solving
+static const unsigned long SCA_AC_POINTS_PER_THREAD=16;
+
+unsigned long sca_ac_domain_solver::get_number_of_threads(unsigned long n_points)
+{
+	unsigned long n_threads=ac_data.get_number_of_threads();
+
+	if(n_threads==0) n_threads=std::thread::hardware_concurrency();
+	if(n_threads>n_points) n_threads=n_points;
+	if(n_threads==0) n_threads=1;
+
+	return n_threads;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+//the equation setup calls the modules and thus remains sequential - the
+//equation systems of a batch of frequency points are copied and solved
+//by the threads, each thread keeps its own solver data over the batches
+//to reuse the code generation - the results are reported and traced in
+//frequency order, thus the output is the same as for the sequential sweep
+void sca_ac_domain_solver::calculate_parallel(
+    std::vector<double>&                           omegas,
+    unsigned long                                  n_threads,
+    std::vector<bool>&                             noise_src_flags,
+    sca_util::sca_matrix<sca_util::sca_complex >&  results
+)
+{
+    bool noise=ac_data.noise_domain;
+
+    sca_util::sca_vector<sca_util::sca_complex >& result(ac_data.get_result_vector_ref());
+
+    std::unique_ptr<solve_linear_complex_eq_system[]>
+                      solvers(new solve_linear_complex_eq_system[n_threads]);
+
+    std::size_t n_batch=n_threads*SCA_AC_POINTS_PER_THREAD;
+
+    std::vector<sca_util::sca_matrix<sca_util::sca_complex > > Abatch(n_batch);
+    std::vector<sca_util::sca_vector<sca_util::sca_complex > > Bbatch(n_batch);
+    std::vector<sca_util::sca_vector<sca_util::sca_complex > > Xbatch(n_batch);
+    std::vector<sca_util::sca_matrix<sca_util::sca_complex > > Rbatch(n_batch);
+
+    //std::vector<bool> can't be written concurrently
+    std::vector<int>           errc(n_batch);
+    std::vector<int>           solved(n_batch);
+    std::vector<long>          rows(n_batch);
+    std::vector<long>          columns(n_batch);
+    std::vector<unsigned long> n_failed(n_batch);
+
+    for(std::size_t first=0; first<omegas.size(); first+=n_batch)
+    {
+        std::size_t n=omegas.size()-first;
+        if(n>n_batch) n=n_batch;
+
+        for(std::size_t k=0; k<n; ++k)
         {
-        	//solve for each noise source
-            if((noise_src_flags[i]) )
+            if(noise) equations.get_Bgnoise().reset();
+
+            equations.setup_equations(omegas[first+k]);
+
+            Abatch[k]=equations.get_Ag();
+
+            if(noise)
             {
-                b.reset(); //sca_solvelinearc destroys the right-hand-vector !!!!
-                b(2*i)      = Bc(i).real();
-                b(2*i+1)    = Bc(i).imag();
+                Bbatch[k]=equations.get_Bgnoise();
+                Rbatch[k].resize(results.n_rows(),results.n_cols());
+                Rbatch[k].unset_auto_resizable();
+            }
+            else
+            {
+                Bbatch[k]=equations.get_Bg();
+                Xbatch[k].resize(result.length());
+            }
+        }
 
-                errc=sca_solve_ac_linear(b.get_flat(), xnoise.get_flat(),&sdata);
+        std::vector<std::thread> threads;
+        for(unsigned long t=0; t<n_threads; ++t)
+        {
+            threads.push_back(std::thread([&,t,n]()
+            {
+                solve_linear_complex_eq_system& solver(solvers[t]);
 
-                if(errc!=0)
+                for(std::size_t k=t; k<n; k+=n_threads)
                 {
-                    std::ostringstream str;
-                    str << "Equation solver failed for frequency: "
-                    << sca_ac_analysis::sca_ac_f() << " Hz"<< std::endl;
-                    SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+                    if(noise)
+                    {
+                        errc[k]=noise_solve(solver,Abatch[k],Bbatch[k],noise_src_flags,
+                                            noise_adjoint ? &noise_output_ids : NULL,
+                                            Rbatch[k],n_failed[k]);
+                    }
+                    else
+                    {
+                        errc[k]=solver.init(Abatch[k]);
+                        solved[k]=(errc[k]==0);
+                        if(solved[k]) errc[k]=solver.solve(Bbatch[k],Xbatch[k]);
+                    }
+
+                    rows[k]=solver.critical_row;
+                    columns[k]=solver.critical_column;
                 }
+            }));
+        }
 
+        for(std::size_t t=0; t<threads.size(); ++t) threads[t].join();
 
+        for(std::size_t k=0; k<n; ++k)
+        {
+            double w=omegas[first+k];
 
-                for(unsigned long k=0; k<n_equations; ++k)
+            //the frequency of the point for the reports
+            ac_data.current_w=w;
+
+            if(noise)
+            {
+                report_noise_error(errc[k],rows[k],columns[k],n_failed[k]);
+
+                if(errc[k]==0)
                 {
-                    sca_util::sca_complex res(xnoise(2*k),xnoise(2*k+1));
-                    result(k,0)+=norm(res); //the first row is used for the sum
-                    result(k,n_src)=res;
+                    for(unsigned long i=0; i<results.n_rows(); ++i)
+                        for(unsigned long j=0; j<results.n_cols(); ++j)
+                            results(i,j)=Rbatch[k](i,j);
                 }
-                n_src++;
+                else //only the sum has been reset
+                {
+                    for(unsigned long i=0; i<results.n_rows(); ++i)
+                        results(i,0)=0.0;
+                }
+
+                trace_noise(w,results);
             }
-        }
+            else
+            {
+                report_solve_error(errc[k],rows[k],columns[k]);
 
-        //square root of arithmetic sum
-        for(unsigned long j=0; j<n_equations; ++j)
-        {
-            result(j,0)=sqrt(result(j,0).real());
+                if(solved[k])
+                {
+                    for(unsigned long i=0; i<result.length(); ++i)
+                        result(i)=Xbatch[k](i);
+                }
+
+                trace(w,result);
+            }
         }
     }
+
+    for(unsigned long t=0; t<n_threads; ++t)
+    {
+        long codegen_cnt, reuse_cnt;
+        solvers[t].get_statistics(codegen_cnt,reuse_cnt);
+        parallel_codegen_cnt+=codegen_cnt;
+        parallel_reuse_cnt+=reuse_cnt;
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 
+#endif
+
 void sca_ac_domain_solver::calculate(std::vector<double> omegas)
 {
     ac_data.ac_domain    = true;
     ac_data.noise_domain = false;
 
+    equations.invalidate_frequency_independent_part();
+
     sca_core::sca_implementation::sca_get_curr_simcontext()->set_no_time_domain_simulation();
 
     sca_util::sca_vector<sca_util::sca_complex >& result(ac_data.get_result_vector_ref());
@@ -383,6 +727,16 @@ void sca_ac_domain_solver::calculate(std::vector<double> omegas)
 
     trace_init();
 
+#ifndef DISABLE_PARALLEL_AC_ANALYSIS
+    unsigned long n_threads=get_number_of_threads((unsigned long)omegas.size());
+    if(n_threads>1)
+    {
+        std::vector<bool> no_noise_src;
+        sca_util::sca_matrix<sca_util::sca_complex > no_results;
+        calculate_parallel(omegas,n_threads,no_noise_src,no_results);
+    }
+    else
+#endif
     for(std::vector<double>::iterator wi=omegas.begin(); wi<omegas.end(); ++wi)
     {
         equations.setup_equations(*wi);
@@ -406,6 +760,8 @@ void sca_ac_domain_solver::calculate(std::vector<double> omegas)
         trace(*wi,result);
     }
 
+    print_solver_statistics();
+
     sca_core::sca_implementation::sca_get_curr_simcontext()->set_time_domain_simulation();
 
     ac_data.ac_domain = false;
@@ -414,13 +770,180 @@ void sca_ac_domain_solver::calculate(std::vector<double> omegas)
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 
-void sca_ac_domain_solver::calculate_noise(std::vector<double> omegas)
+//returns the maximum violation of the tolerances between the traced values
+//of two neighbouring frequency points, values below mag_floor are ignored
+double sca_ac_domain_solver::adaptive_violation(
+		const std::vector<std::vector<sca_util::sca_complex > >& va,
+		const std::vector<std::vector<sca_util::sca_complex > >& vb,
+		const std::vector<double>& mag_floor,
+		double mag_tol, double phase_tol)
+{
+    double violation=0.0;
+    unsigned long idx=0;
+
+    for(unsigned long i=0;i<va.size();i++)
+    {
+        for(unsigned long j=0;j<va[i].size();j++,idx++)
+        {
+            double mag_a=std::abs(va[i][j]);
+            double mag_b=std::abs(vb[i][j]);
+            double mag_max=(mag_a>mag_b)?mag_a:mag_b;
+
+            if((mag_max<=0.0) || (mag_max<=mag_floor[idx])) continue;
+
+            double v=std::fabs(mag_a-mag_b)/mag_max/mag_tol;
+            if(v>violation) violation=v;
+
+            if((mag_a>0.0) && (mag_b>0.0))
+            {
+                //phase difference wrapped to [-180,180] degree
+                double dphase=std::arg(vb[i][j]*std::conj(va[i][j]))*180.0/M_PI;
+                v=std::fabs(dphase)/phase_tol;
+                if(v>violation) violation=v;
+            }
+        }
+    }
+
+    return violation;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+void sca_ac_domain_solver::calculate_adaptive(std::vector<double> omegas,
+		bool log_scale, unsigned long max_points, double mag_tol, double phase_tol)
+{
+    ac_data.ac_domain    = true;
+    ac_data.noise_domain = false;
+
+    equations.invalidate_frequency_independent_part();
+
+    sca_core::sca_implementation::sca_get_curr_simcontext()->set_no_time_domain_simulation();
+
+    sca_util::sca_vector<sca_util::sca_complex >& result(ac_data.get_result_vector_ref());
+    result.reset();
+
+    if(result.length()<=0)
+    {
+    	SC_REPORT_WARNING("SystemC-AMS","No AC equations in System - skip AC analysis");
+    	return;
+    }
+
+    trace_init();
+
+    adaptive_points_t points;
+
+    //frequencies of the current refinement level in ascending order
+    std::vector<double> wlevel(omegas);
+    std::sort(wlevel.begin(),wlevel.end());
+
+    while(!wlevel.empty())
+    {
+        for(std::vector<double>::iterator wi=wlevel.begin(); wi<wlevel.end(); ++wi)
+        {
+            if(points.find(*wi)!=points.end()) continue;
+
+            equations.setup_equations(*wi);
+            solve_complex_eq_system(equations.get_Ag(),equations.get_Bg(),result);
+
+            //the result of modules may depend on the frequency
+            ac_data.current_w=*wi;
+            get_trace_values(result,points[*wi]);
+        }
+
+        wlevel.clear();
+
+        if((points.size()<2) || (points.size()>=max_points)) break;
+
+        //magnitudes below 1e-12 of the maximum of a traced value are
+        //considered as numerical noise
+        std::vector<double> mag_floor;
+        for(adaptive_points_t::iterator pit=points.begin();pit!=points.end();++pit)
+        {
+            unsigned long idx=0;
+            for(unsigned long i=0;i<pit->second.size();i++)
+            {
+                for(unsigned long j=0;j<pit->second[i].size();j++,idx++)
+                {
+                    double mag=1e-12*std::abs(pit->second[i][j]);
+                    if(idx>=mag_floor.size())  mag_floor.push_back(mag);
+                    else if(mag>mag_floor[idx]) mag_floor[idx]=mag;
+                }
+            }
+        }
+
+        //bisect the intervals violating the tolerances - the worst first
+        std::vector<std::pair<double,double> > candidates;
+        adaptive_points_t::iterator pa=points.begin();
+        adaptive_points_t::iterator pb=pa;
+        for(++pb;pb!=points.end();++pa,++pb)
+        {
+            double wa=pa->first;
+            double wb=pb->first;
+
+            //interval can't be resolved further
+            if((wb-wa)<=1e-9*std::fabs(wb)) continue;
+
+            double violation=adaptive_violation(pa->second,pb->second,
+            		mag_floor,mag_tol,phase_tol);
+            if(violation<=1.0) continue;
+
+            double wm;
+            if(log_scale && (wa>0.0)) wm=std::sqrt(wa*wb);
+            else                      wm=0.5*(wa+wb);
+
+            candidates.push_back(std::pair<double,double>(-violation,wm));
+        }
+
+        std::sort(candidates.begin(),candidates.end());
+
+        unsigned long n_new=(unsigned long)(candidates.size());
+        if(n_new>max_points-points.size()) n_new=max_points-(unsigned long)(points.size());
+
+        for(unsigned long i=0;i<n_new;i++) wlevel.push_back(candidates[i].second);
+        std::sort(wlevel.begin(),wlevel.end());
+    }
+
+    //write the results in ascending frequency order
+    for(adaptive_points_t::iterator pit=points.begin();pit!=points.end();++pit)
+    {
+        write_trace_values(pit->first,pit->second);
+    }
+
+    unsigned long& info_mask(
+                sca_core::sca_implementation::sca_get_curr_simcontext()->
+                get_information_mask());
+
+    if(info_mask & (sca_util::sca_info::sca_eln_solver.mask |
+                    sca_util::sca_info::sca_lsf_solver.mask))
+    {
+    	std::ostringstream str;
+    	str << std::endl;
+    	str << "\tAdaptive AC analysis: " << points.size() << " frequency points";
+    	str << " were calculated starting with " << omegas.size() << " points";
+    	str << " (maximum " << max_points << ")" << std::endl;
+    	SC_REPORT_INFO("SystemC-AMS",str.str().c_str());
+    }
+
+    print_solver_statistics();
+
+    sca_core::sca_implementation::sca_get_curr_simcontext()->set_time_domain_simulation();
+
+    ac_data.ac_domain = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+void sca_ac_domain_solver::calculate_noise(std::vector<double> omegas, bool adjoint)
 {
     ac_data.ac_domain    = true;
     ac_data.noise_domain = true;
     ac_data.equations=&equations; //set reference to be able to access
     //from global routines->required for noise
 
+    equations.invalidate_frequency_independent_part();
+
     sca_core::sca_implementation::sca_get_curr_simcontext()->set_no_time_domain_simulation();
 
     sca_util::sca_vector<sca_util::sca_complex >& result(ac_data.get_result_vector_ref());
@@ -458,10 +981,30 @@ void sca_ac_domain_solver::calculate_noise(std::vector<double> omegas)
 
     trace_init_noise(src_names);
 
+    noise_adjoint=false;
+    if(adjoint)
+    {
+        noise_adjoint=get_traced_equations(noise_output_ids);
+        if(!noise_adjoint)
+        {
+            SC_REPORT_INFO("SystemC-AMS","Adjoint noise analysis not possible for "
+                "traced modules - all noise sources are solved");
+        }
+    }
+
 
     sca_util::sca_matrix<sca_util::sca_complex > results;
     results.resize(result.length(),n_src+1);
     results.unset_auto_resizable();
+
+#ifndef DISABLE_PARALLEL_AC_ANALYSIS
+    unsigned long n_threads=get_number_of_threads((unsigned long)omegas.size());
+    if(n_threads>1)
+    {
+        calculate_parallel(omegas,n_threads,noise_src_flags,results);
+    }
+    else
+#endif
     for(std::vector<double>::iterator wi=omegas.begin(); wi<omegas.end(); ++wi)
     {
         equations.get_Bgnoise().reset();
@@ -472,6 +1015,8 @@ void sca_ac_domain_solver::calculate_noise(std::vector<double> omegas)
         trace_noise(*wi,results);
     }
 
+    print_solver_statistics();
+
     sca_core::sca_implementation::sca_get_curr_simcontext()->set_time_domain_simulation();
 
     ac_data.ac_domain    = false;
@@ -626,25 +1171,130 @@ void sca_ac_domain_solver::trace_noise(double w, sca_util::sca_matrix<sca_util::
 /////////////////////////////////
 
 
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+//collects the equations required by the noise traces - returns false, if
+//a module is traced, since the equations used by the module are unknown
+bool sca_ac_domain_solver::get_traced_equations(std::vector<long>& ids)
+{
+    std::vector<sca_util::sca_implementation::sca_trace_file_base*>* tr_list=
+    	sca_core::sca_implementation::sca_get_curr_simcontext()->get_trace_list();
+
+    std::set<long> id_set;
+
+    for(std::vector<sca_util::sca_implementation::sca_trace_file_base*>::iterator tr_it  = tr_list->
+            begin();
+            tr_it != tr_list->end();
+            ++tr_it )
+    {
+        if((*tr_it)->trace_disabled()) continue;
+
+        if(!(*tr_it)->is_ac_enabled()) continue;
+
+        for(std::vector<sca_util::sca_implementation::sca_trace_object_data>::iterator
+                tr_objit =  (*tr_it)->
+                            traces.begin();
+                tr_objit != (*tr_it)->traces.end();
+                ++tr_objit
+           )
+        {
+        	sca_util::sca_traceable_object* tobj = (*tr_objit).trace_object;
+
+            if(tobj==NULL) continue;
+
+            sc_core::sc_interface* sca_if;
+            sc_core::sc_port_base* port = dynamic_cast<sc_core::sc_port_base*>(tobj);
+            if(port)
+                sca_if  = dynamic_cast<sc_core::sc_interface*>(port->get_interface());
+            else
+                sca_if  = dynamic_cast<sc_core::sc_interface*>(tobj);
+
+            if(sca_if)
+            {
+                long id = ac_data.get_arc_id(sca_if);
+                if(id>=0) id_set.insert(id);
+            }
+            else //tracing for modules
+            {
+                sca_core::sca_module* mod;
+                mod = dynamic_cast<sca_core::sca_module*>(tobj);
+                if(mod==NULL) continue;
+
+                sca_core::sca_implementation::sca_solver_base* solv=mod->get_sync_domain();
+                if(solv==NULL) continue;
+
+                if(ac_data.get_start_of_add_equations(solv)>=0) return false;
+            }
+        }
+    }
+
+    ids.assign(id_set.begin(),id_set.end());
+
+    return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 
 void sca_ac_domain_solver::trace(double w, sca_util::sca_vector<sca_util::sca_complex >& result)
+{
+    std::vector<std::vector<sca_util::sca_complex > > tr_values;
+
+    get_trace_values(result,tr_values);
+    write_trace_values(w,tr_values);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+//writes the values collected by get_trace_values to the ac enabled traces
+void sca_ac_domain_solver::write_trace_values(double w,
+		std::vector<std::vector<sca_util::sca_complex > >& tr_values)
 {
     std::vector<sca_util::sca_implementation::sca_trace_file_base*>* tr_list=
     	sca_core::sca_implementation::sca_get_curr_simcontext()->get_trace_list();
 
+    std::vector<std::vector<sca_util::sca_complex > >::iterator tv_it=tr_values.begin();
     for(std::vector<sca_util::sca_implementation::sca_trace_file_base*>::iterator tr_it  =
     	tr_list->begin();
-            tr_it != tr_list->end();
+            (tr_it != tr_list->end()) && (tv_it != tr_values.end());
             ++tr_it )
     {
         if((*tr_it)->trace_disabled()) continue;
 
         if(!(*tr_it)->is_ac_enabled()) continue;
 
+        (*tr_it)->write_ac_domain_stamp(w,*tv_it);
+        ++tv_it;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+//collects the traced values of the solution vector result - one vector for
+//each ac enabled trace file
+void sca_ac_domain_solver::get_trace_values(
+		sca_util::sca_vector<sca_util::sca_complex >& result,
+		std::vector<std::vector<sca_util::sca_complex > >& tr_values)
+{
+    std::vector<sca_util::sca_implementation::sca_trace_file_base*>* tr_list=
+    	sca_core::sca_implementation::sca_get_curr_simcontext()->get_trace_list();
+
+    tr_values.clear();
+
+    for(std::vector<sca_util::sca_implementation::sca_trace_file_base*>::iterator tr_it  =
+    	tr_list->begin();
+            tr_it != tr_list->end();
+            ++tr_it )
+    {
+        if((*tr_it)->trace_disabled()) continue;
+
+        if(!(*tr_it)->is_ac_enabled()) continue;
 
-        std::vector<sca_util::sca_complex > tr_vec;
+        tr_values.push_back(std::vector<sca_util::sca_complex >());
+        std::vector<sca_util::sca_complex >& tr_vec(tr_values.back());
         const sc_core::sc_interface* sca_if(NULL);
 
         for(std::vector<sca_util::sca_implementation::sca_trace_object_data>::iterator
@@ -714,7 +1364,6 @@ void sca_ac_domain_solver::trace(double w, sca_util::sca_vector<sca_util::sca_co
                 }
             }
         }
-        (*tr_it)->write_ac_domain_stamp(w,tr_vec);
     }
 }
 /////////////////////////////////////////////////////////////////////////////
@@ -43,6 +43,8 @@
 
 #include "scams/impl/analysis/ac/sca_ac_domain_eq.h"
 
+struct sca_solve_ac_linear_data;
+
 namespace sca_ac_analysis
 {
 namespace sca_implementation
@@ -52,12 +54,49 @@ class solve_linear_complex_eq_system
 {
 public:
 
+	solve_linear_complex_eq_system();
+	~solve_linear_complex_eq_system();
+
 	int solve(sca_util::sca_matrix<sca_util::sca_complex >& Ac,
 	        sca_util::sca_vector<sca_util::sca_complex >& Bc,
 	        sca_util::sca_vector<sca_util::sca_complex >& Xc);
 
+	//decomposes Ac - the pivot order of the previous call is reused, if
+	//the structure of Ac has not changed (e.g. for the next frequency point)
+	int init(sca_util::sca_matrix<sca_util::sca_complex >& Ac);
+
+	//solves for the right hand side b with interleaved real and imaginary
+	//parts for the matrix of the last init, b is destroyed
+	int solve(sca_util::sca_vector<double>& b,sca_util::sca_vector<double>& x);
+
+	//solves for nrhs right hand sides stored by lines (the real part of line i
+	//of the right hand side m is b(2*(i*nrhs+m))), b is destroyed - n_failed
+	//is the number of right hand sides which couldn't be solved
+	int solve_multi(sca_util::sca_vector<double>& b,sca_util::sca_vector<double>& x,
+			unsigned long nrhs, unsigned long& n_failed);
+
+	//solves the transposed (not conjugated) system for the right hand side b
+	int solve_transposed(sca_util::sca_vector<double>& b,sca_util::sca_vector<double>& x);
+
+	//solves for the right hand side Bc for the matrix of the last init
+	int solve(sca_util::sca_vector<sca_util::sca_complex >& Bc,
+	        sca_util::sca_vector<sca_util::sca_complex >& Xc);
+
+	//number of code generations and of numeric reuses of the code
+	void get_statistics(long& codegen_cnt, long& reuse_cnt);
+
 	long critical_row;
 	long critical_column;
+
+private:
+
+	void store_error_position(unsigned long dim);
+
+	::sca_solve_ac_linear_data* sdata;
+
+	//not copyable due the internal solver data
+	solve_linear_complex_eq_system(const solve_linear_complex_eq_system&);
+	solve_linear_complex_eq_system& operator=(const solve_linear_complex_eq_system&);
 };
 
 class sca_ac_domain_solver
@@ -70,8 +109,15 @@ public:
     //calculate signals for given frequency (omegas)
     void calculate(std::vector<double> omegas);
 
-    //calculate signals for given frequency (omegas)
-    void calculate_noise(std::vector<double> omegas);
+    //calculate signals starting with the frequencies omegas and bisects the
+    //intervals, where a traced value changes more than mag_tol (relative) or
+    //phase_tol (degree), until max_points frequencies are calculated
+    void calculate_adaptive(std::vector<double> omegas, bool log_scale,
+    		unsigned long max_points, double mag_tol, double phase_tol);
+
+    //calculate signals for given frequency (omegas) - if adjoint is set,
+    //the noise contributions are only calculated for the traced signals
+    void calculate_noise(std::vector<double> omegas, bool adjoint=false);
 
     void solve_complex_eq_system(
         sca_util::sca_matrix<sca_util::sca_complex >& Ac,
@@ -94,12 +140,55 @@ private:
     void trace_init();
     void trace_init_noise(sca_util::sca_vector<std::string>& src_names);
     void trace(double w, sca_util::sca_vector<sca_util::sca_complex >& result);
+    void get_trace_values(sca_util::sca_vector<sca_util::sca_complex >& result,
+    		std::vector<std::vector<sca_util::sca_complex > >& tr_values);
+    void write_trace_values(double w,
+    		std::vector<std::vector<sca_util::sca_complex > >& tr_values);
     void trace_noise(double w, sca_util::sca_matrix<sca_util::sca_complex >& result);
 
     sca_ac_domain_db& ac_data;
 
     sca_ac_domain_eq  equations;
 
+    //keeps the code generation over the frequency points
+    solve_linear_complex_eq_system ac_solver;
+
+    void print_solver_statistics();
+
+    //traced values of the frequency points of an adaptive sweep
+    typedef std::map<double,std::vector<std::vector<sca_util::sca_complex > > >
+    		adaptive_points_t;
+
+    //returns the maximum violation of the tolerances between two
+    //neighbouring points (>1.0 -> the interval has to be bisected)
+    static double adaptive_violation(
+    		const std::vector<std::vector<sca_util::sca_complex > >& va,
+    		const std::vector<std::vector<sca_util::sca_complex > >& vb,
+    		const std::vector<double>& mag_floor,
+    		double mag_tol, double phase_tol);
+
+    void report_solve_error(int err,long row,long column);
+    void report_noise_error(int errc,long row,long column,unsigned long n_failed);
+
+    //statistics of the solvers of parallel sweeps
+    long parallel_codegen_cnt;
+    long parallel_reuse_cnt;
+
+#ifndef DISABLE_PARALLEL_AC_ANALYSIS
+
+    //number of threads for a sweep over n_points frequencies
+    unsigned long get_number_of_threads(unsigned long n_points);
+
+    //solves the frequency points by n_threads threads
+    void calculate_parallel(
+        std::vector<double>&                           omegas,
+        unsigned long                                  n_threads,
+        std::vector<bool>&                             noise_src_flags,
+        sca_util::sca_matrix<sca_util::sca_complex >&  results
+    );
+
+#endif
+
 
     //noise analysis
     void ac_noise_solver(
@@ -109,6 +198,22 @@ private:
         sca_util::sca_matrix<sca_util::sca_complex >& result
     );
 
+    static int noise_solve(
+        solve_linear_complex_eq_system&               solver,
+        sca_util::sca_matrix<sca_util::sca_complex >& Ac,
+        sca_util::sca_vector<sca_util::sca_complex >& Bc,
+        std::vector<bool>&                 noise_src_flags,
+        const std::vector<long>*           output_ids,
+        sca_util::sca_matrix<sca_util::sca_complex >& result,
+        unsigned long&                     n_failed
+    );
+
+    //adjoint noise analysis - only the traced equations are calculated
+    bool              noise_adjoint;
+    std::vector<long> noise_output_ids;
+
+    bool get_traced_equations(std::vector<long>& ids);
+
 };
 
 } // namespace sca_implementation
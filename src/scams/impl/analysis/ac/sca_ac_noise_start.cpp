@@ -47,7 +47,8 @@ namespace sca_ac_analysis
 {
 
 //////////////////////////////////////////////////////////////////////////////
-void sca_ac_noise_start(const sca_util::sca_vector<double>& frequencies)
+void sca_ac_noise_start(const sca_util::sca_vector<double>& frequencies,
+		sca_ac_analysis::sca_ac_noise_method method)
 {
     std::vector<double> omegas;
     for(unsigned long i=0;i<frequencies.length();i++)
@@ -56,14 +57,14 @@ void sca_ac_noise_start(const sca_util::sca_vector<double>& frequencies)
 
     sca_ac_analysis::sca_implementation::sca_ac_domain_solver
 							ac_solver(sca_ac_analysis::sca_implementation::get_ac_database(),true);
-    ac_solver.calculate_noise(omegas);
+    ac_solver.calculate_noise(omegas,method==sca_ac_analysis::SCA_NOISE_ADJOINT);
 }
 
 
 //////////////////////////////////////////////////////////////////////////////
 
 void sca_ac_noise_start(double start_freq, double stop_freq, unsigned long npoints,
-		sca_ac_analysis::sca_ac_scale scale)
+		sca_ac_analysis::sca_ac_scale scale, sca_ac_analysis::sca_ac_noise_method method)
 {
     sca_util::sca_vector<double> freqs;
     sca_ac_noise_start(
@@ -72,7 +73,8 @@ void sca_ac_noise_start(double start_freq, double stop_freq, unsigned long npoin
     				start_freq,
     				stop_freq,
     				npoints,
-    				scale));
+    				scale),
+    		method);
 }
 
 
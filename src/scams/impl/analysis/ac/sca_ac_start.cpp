@@ -77,6 +77,46 @@ void sca_ac_start(double start_freq, double stop_freq, unsigned long npoints,
 }
 
 
+//////////////////////////////////////////////////////////////////////////////
+
+void sca_ac_start_adaptive(double start_freq, double stop_freq,
+		unsigned long npoints, unsigned long max_points,
+		sca_ac_analysis::sca_ac_scale scale, double mag_tol, double phase_tol)
+{
+	if((mag_tol<=0.0) || (phase_tol<=0.0))
+	{
+		std::ostringstream str;
+		str << "The tolerances of sca_ac_start_adaptive must be greater than zero"
+			<< " (mag_tol: " << mag_tol << " phase_tol: " << phase_tol << ")";
+		SC_REPORT_ERROR("SystemC-AMS",str.str().c_str());
+		return;
+	}
+
+    sca_util::sca_vector<double> freqs;
+    sca_ac_analysis::sca_implementation::generate_frequencies(
+    		freqs, start_freq, stop_freq, npoints, scale);
+
+    std::vector<double> omegas;
+    for(unsigned long i=0;i<freqs.length();i++)
+        omegas.push_back(2.0*M_PI*freqs(i));
+
+    sca_ac_analysis::sca_implementation::sca_ac_domain_solver
+							ac_solver(sca_ac_analysis::sca_implementation::get_ac_database(),
+									false);
+    ac_solver.calculate_adaptive(omegas, scale==sca_ac_analysis::SCA_LOG,
+    		max_points, mag_tol, phase_tol);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+
+void sca_ac_set_number_of_threads(unsigned long n_threads)
+{
+	sca_ac_analysis::sca_implementation::get_ac_database().
+											set_number_of_threads(n_threads);
+}
+
+
 } // namespace sca_ac_analysis
 
 
@@ -178,6 +178,13 @@ void sca_module::set_solver_parameter(const std::string& par,const std::string&
 
 std::string sca_module::get_solver_parameter(const std::string& name) const
 {
+	//parameter provided by the solver e.g. acceptable_timestep
+	std::string val;
+	if((sync_domain!=NULL) && sync_domain->get_solver_parameter(name,val))
+	{
+		return val;
+	}
+
 	for(std::size_t i=0;i<solver_parameter.size();++i)
 	{
 		if(solver_parameter[i]==name)
@@ -181,6 +181,13 @@ void sca_solver_base::set_solver_parameter(
 	SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
 }
 
+bool sca_solver_base::get_solver_parameter(
+		  const std::string& par,
+		  std::string& val) const
+{
+	return false;
+}
+
 long sca_solver_base::get_cluster_id()
 {
 	return solver_object_data.cluster_id;
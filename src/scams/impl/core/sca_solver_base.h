@@ -92,6 +92,12 @@ class sca_solver_base :  public sca_synchronization_obj_if,
 		  const std::string& par,
 		  const std::string& val);
 
+  /** method for reading implementation defined solver states, returns
+   *  false if the solver does not provide the parameter */
+  virtual bool get_solver_parameter(
+		  const std::string& par,
+		  std::string& val) const;
+
 
   long get_cluster_id();
 
@@ -336,7 +336,10 @@ bool sca_conservative_module::set_pre_solve_methods(double last_slope, double cu
 	bool test = diff_test(last_slope, curr_slope, relerr);
 
 	if (!test || (fabs(curr_slope) < relerr)){
-		request_reinit(1,curr_slope);
+		//no Woodbury update possible - a jump restarts with the Euler method,
+		//a continuous change keeps the trapezoidal method
+		if (jump)	request_reinit(1,curr_slope);
+		else 	request_reinit(2,curr_slope);
 	}
 	else
 	{
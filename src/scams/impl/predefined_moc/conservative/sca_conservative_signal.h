@@ -41,6 +41,14 @@
 #ifndef SCA_CONSERVATIVE_SIGNAL_H_
 #define SCA_CONSERVATIVE_SIGNAL_H_
 
+namespace sca_eln
+{
+namespace sca_implementation
+{
+class sca_eln_view;
+}
+}
+
 namespace sca_core
 {
 namespace sca_implementation
@@ -74,6 +82,7 @@ class sca_conservative_signal :
 
 
     friend class sca_conservative_view;
+    friend class sca_eln::sca_implementation::sca_eln_view;
 
     long node_number;
     long equation_id;
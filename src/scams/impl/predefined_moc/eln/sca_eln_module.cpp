@@ -128,6 +128,11 @@ double& sca_module::A(long a, long b)
 }
 
 double& sca_module::B_wr(long a, long b)
+{
+	return B_wr(a,b,true);
+}
+
+double& sca_module::B_wr(long a, long b, bool request_reinitialization)
 {
 	if(enable_b_change)
 	{
@@ -135,7 +140,11 @@ double& sca_module::B_wr(long a, long b)
 		{
 			B_change->add_change(a,b,&((*Bi)(a, b)),continous);
 
-			if(continous)
+			if(!request_reinitialization)
+			{
+				//reinitialization or Woodbury requested by the module
+			}
+			else if(continous)
 			{
 				request_reinit(2);
 			}
@@ -0,0 +1,232 @@
+/*****************************************************************************
+
+    Copyright 2010
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+    Copyright 2015-2020
+    COSEDA Technologies GmbH
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+ sca_eln_netlist_reduction.cpp - description
+
+ Original Author: Karsten Einwich COSEDA Technologies GmbH
+
+ *****************************************************************************/
+
+/*****************************************************************************/
+
+#include "scams/impl/predefined_moc/eln/sca_eln_netlist_reduction.h"
+#include <algorithm>
+
+namespace sca_eln
+{
+namespace sca_implementation
+{
+
+sca_eln_netlist_reduction::sca_eln_netlist_reduction(long nnodes_) :
+	nnodes(nnodes_), neliminated(0), fixed(nnodes_,false), root(nnodes_),
+	number(nnodes_,-1)
+{
+	for(long i=0;i<nnodes;++i) root[i]=i;
+}
+
+////////////////////////////////////////////////////////////////
+
+void sca_eln_netlist_reduction::set_fixed(long node)
+{
+	if((node>=0) && (node<nnodes)) fixed[node]=true;
+}
+
+////////////////////////////////////////////////////////////////
+
+void sca_eln_netlist_reduction::add_wire(long node_a, long node_b)
+{
+	wires.push_back(std::make_pair(node_a,node_b));
+}
+
+////////////////////////////////////////////////////////////////
+
+void sca_eln_netlist_reduction::add_conductance(long node_a, long node_b,
+		double value)
+{
+	conductance c;
+	c.node_a=node_a;
+	c.node_b=node_b;
+	c.value=value;
+	added.push_back(c);
+}
+
+////////////////////////////////////////////////////////////////
+
+//root of a node merged by ideal wires (-1: reference node)
+long sca_eln_netlist_reduction::root_of(long node)
+{
+	if(node<0) return node;
+
+	while(root[node]!=node)
+	{
+		root[node]=root[root[node]];
+		node=root[node];
+	}
+
+	return node;
+}
+
+////////////////////////////////////////////////////////////////
+
+void sca_eln_netlist_reduction::reduce(std::size_t max_degree)
+{
+	//ideal wires merge their nodes, the node with the lowest number remains
+	for(std::size_t i=0;i<wires.size();++i)
+	{
+		long ra=root_of(wires[i].first);
+		long rb=root_of(wires[i].second);
+
+		if(ra!=rb)
+		{
+			if(rb<ra) std::swap(ra,rb);
+			root[rb]=ra;
+			fixed[ra]=fixed[ra] || fixed[rb];
+		}
+	}
+
+	//conductances between the remaining nodes, parallel conductances are summed
+	std::vector<std::map<long,double> > adj(nnodes);
+	for(std::size_t i=0;i<added.size();++i)
+	{
+		long ra=root_of(added[i].node_a);
+		long rb=root_of(added[i].node_b);
+
+		//shorted by ideal wires
+		if(ra==rb) continue;
+
+		if(ra>=0) adj[ra][rb]+=added[i].value;
+		if(rb>=0) adj[rb][ra]+=added[i].value;
+	}
+
+	//elimination of internal nodes by the star-mesh transformation
+	//(Schur complement of the node equation)
+	std::vector<bool> eliminated(nnodes,false);
+	bool changed=true;
+	while(changed)
+	{
+		changed=false;
+		for(long i=0;i<nnodes;++i)
+		{
+			if(fixed[i] || eliminated[i] || (root[i]!=i)) continue;
+			if(adj[i].size()>max_degree) continue;
+
+			std::vector<std::pair<long,double> > star(adj[i].begin(),adj[i].end());
+
+			double gsum=0.0;
+			for(std::size_t k=0;k<star.size();++k)
+			{
+				gsum+=star[k].second;
+				if(star[k].first>=0) adj[star[k].first].erase(i);
+			}
+
+			for(std::size_t k=0;k<star.size();++k)
+			{
+				for(std::size_t l=k+1;l<star.size();++l)
+				{
+					long a=star[k].first;
+					long b=star[l].first;
+					double g=star[k].second*star[l].second/gsum;
+
+					if(a>=0) adj[a][b]+=g;
+					if(b>=0) adj[b][a]+=g;
+				}
+			}
+
+			adj[i].clear();
+			eliminated[i]=true;
+			neliminated++;
+			changed=true;
+		}
+	}
+
+	//renumbering of the remaining nodes
+	for(long i=0;i<nnodes;++i)
+	{
+		if((root[i]!=i) || eliminated[i]) continue;
+
+		number[i]=(long)(original.size());
+		original.push_back(i);
+	}
+
+	//each conductance is stored once
+	for(long i=0;i<nnodes;++i)
+	{
+		if(number[i]<0) continue;
+
+		for(std::map<long,double>::iterator it=adj[i].begin();it!=adj[i].end();++it)
+		{
+			if((it->first>=0) && (it->first<i)) continue;
+
+			conductance c;
+			c.node_a=number[i];
+			c.node_b=(it->first<0) ? -1 : number[it->first];
+			c.value=it->second;
+			conductances.push_back(c);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////
+
+long sca_eln_netlist_reduction::get_node_number(long node) const
+{
+	if((node<0) || (node>=nnodes)) return -1;
+
+	while(root[node]!=node) node=root[node];
+
+	return number[node];
+}
+
+////////////////////////////////////////////////////////////////
+
+long sca_eln_netlist_reduction::get_original_node(long reduced_node) const
+{
+	return original[reduced_node];
+}
+
+////////////////////////////////////////////////////////////////
+
+long sca_eln_netlist_reduction::get_number_of_nodes() const
+{
+	return (long)(original.size());
+}
+
+////////////////////////////////////////////////////////////////
+
+unsigned long sca_eln_netlist_reduction::get_number_of_eliminated_nodes() const
+{
+	return neliminated;
+}
+
+////////////////////////////////////////////////////////////////
+
+const std::vector<sca_eln_netlist_reduction::conductance>&
+sca_eln_netlist_reduction::get_conductances() const
+{
+	return conductances;
+}
+
+} // namespace sca_implementation
+} // namespace sca_eln
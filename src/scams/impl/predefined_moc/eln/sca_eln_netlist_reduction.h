@@ -0,0 +1,113 @@
+/*****************************************************************************
+
+    Copyright 2010
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+    Copyright 2015-2020
+    COSEDA Technologies GmbH
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+ sca_eln_netlist_reduction.h - description
+
+ Original Author: Karsten Einwich COSEDA Technologies GmbH
+
+ *****************************************************************************/
+
+/*****************************************************************************/
+
+#ifndef SCA_ELN_NETLIST_REDUCTION_H_
+#define SCA_ELN_NETLIST_REDUCTION_H_
+
+#include <vector>
+#include <map>
+#include <cstddef>
+
+namespace sca_eln
+{
+namespace sca_implementation
+{
+
+/**
+ * Reduction of the resistive part of an ELN netlist - ideal wires merge
+ * their nodes, internal nodes with few neighbors are eliminated by the
+ * star-mesh transformation. Node numbers <0 denote the reference node.
+ * The class does not depend on SystemC (see sca_eln_view::reduce_netlist).
+ */
+class sca_eln_netlist_reduction
+{
+public:
+
+	//conductance between two nodes of the reduced netlist (-1: reference)
+	struct conductance
+	{
+		long   node_a;
+		long   node_b;
+		double value;
+	};
+
+	sca_eln_netlist_reduction(long nnodes);
+
+	//the node remains (connected to other modules, traced ...)
+	void set_fixed(long node);
+
+	//ideal wire between two nodes - the nodes are merged
+	void add_wire(long node_a, long node_b);
+
+	//conductance between two nodes
+	void add_conductance(long node_a, long node_b, double value);
+
+	//merges the wires and eliminates the not fixed nodes with up to
+	//max_degree neighbors
+	void reduce(std::size_t max_degree);
+
+	//node number in the reduced netlist (-1: eliminated) - the merged
+	//nodes get the number of the remaining node
+	long get_node_number(long node) const;
+
+	//original number of the node with the number in the reduced netlist
+	long get_original_node(long reduced_node) const;
+
+	long get_number_of_nodes() const;
+
+	unsigned long get_number_of_eliminated_nodes() const;
+
+	//each conductance of the reduced netlist is stored once
+	const std::vector<conductance>& get_conductances() const;
+
+private:
+
+	long root_of(long node);
+
+	long nnodes;
+	unsigned long neliminated;
+
+	std::vector<bool> fixed;
+	std::vector<long> root;
+	std::vector<long> number;
+	std::vector<long> original;
+
+	std::vector<std::pair<long,long> > wires;
+	std::vector<conductance> added;
+	std::vector<conductance> conductances;
+};
+
+} // namespace sca_implementation
+} // namespace sca_eln
+
+#endif /* SCA_ELN_NETLIST_REDUCTION_H_ */
@@ -126,6 +126,9 @@ double* sca_node::get_result_ref()
 
 	if(connected_eln_module==NULL) return NULL;
 
+	//node eliminated by the netlist reduction
+	if(node_number<0) return NULL;
+
 	return &(connected_eln_module->x(node_number));
 }
 
@@ -144,6 +147,15 @@ bool sca_node::trace_init(
 	//initialize connected eln module pointer
 	this->get_connected_eln_module();
 
+	//node eliminated by the netlist reduction
+	if((connected_eln_module != NULL) && !reference_node && (node_number<0))
+	{
+		std::ostringstream str;
+		str << "The node: " << this->name() << " has been eliminated by the"
+			<< " netlist reduction and can not be traced" << std::endl;
+		SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+		return false;
+	}
 
 	if (connected_eln_module != NULL)
 	{
@@ -189,7 +201,7 @@ void sca_node::trace_interactive()
 		this->get_connected_eln_module();
 	}
 
-	if(connected_eln_module!=NULL)
+	if((connected_eln_module!=NULL) && (node_number>=0))
 	{
 		trd->store_value(connected_eln_module->x(node_number));
 	}
@@ -41,9 +41,56 @@
 #include "scams/predefined_moc/eln/sca_eln_r.h"
 #include "scams/impl/core/sca_solver_base.h"
 #include "scams/impl/predefined_moc/conservative/sca_con_interactive_trace_data.h"
+#include "scams/impl/predefined_moc/conservative/sca_conservative_signal.h"
 
 namespace sca_eln
 {
+
+//node of the terminal eliminated by the netlist reduction
+static bool sca_r_terminal_eliminated(const sca_eln::sca_terminal& t)
+{
+	const sca_core::sca_implementation::sca_conservative_signal* ch=
+		dynamic_cast<const sca_core::sca_implementation::sca_conservative_signal*>(
+				t.sca_get_interface());
+
+	return (ch!=NULL) && !ch->is_reference_node() && (ch->get_node_number()<0);
+}
+
+//the netlist reduction merges the nodes of ideal wires and eliminates
+//internal nodes of resistive networks (see sca_eln_view::reduce_netlist) -
+//the current of such a resistor can't be calculated
+static bool sca_r_current_eliminated(const sca_r& r, long nadd)
+{
+	//before the equation setup or with own equation
+	if((r.get_sync_domain()==NULL) || (nadd>=0)) return false;
+
+	if(sca_r_terminal_eliminated(r.p) || sca_r_terminal_eliminated(r.n))
+	{
+		return true;
+	}
+
+	const sca_core::sca_implementation::sca_conservative_signal* chp=
+		dynamic_cast<const sca_core::sca_implementation::sca_conservative_signal*>(
+				r.p.sca_get_interface());
+	const sca_core::sca_implementation::sca_conservative_signal* chn=
+		dynamic_cast<const sca_core::sca_implementation::sca_conservative_signal*>(
+				r.n.sca_get_interface());
+
+	//ideal wire with merged nodes
+	return (r.value.get()==0.0) && (chp!=NULL) && (chn!=NULL) &&
+			(chp!=chn) && (chp->get_node_number()==chn->get_node_number());
+}
+
+static void sca_r_report_current_eliminated(const sca_r& r)
+{
+	std::ostringstream str;
+	str << "The current of: " << r.name() << " can't be accessed, the"
+		<< " resistor has been removed by the netlist reduction"
+		<< " - set the solver parameter netlist_reduction of the module"
+		<< " to false" << std::endl;
+	SC_REPORT_ERROR("SystemC-AMS",str.str().c_str());
+}
+
 sca_r::sca_r(sc_core::sc_module_name, double value_) :
 		p("p"), n("n"), value("value", value_)
 {
@@ -91,6 +138,15 @@ void sca_r::matrix_stamps()
 
 bool sca_r::trace_init(sca_util::sca_implementation::sca_trace_object_data& data)
 {
+	if(sca_r_current_eliminated(*this,nadd))
+	{
+		std::ostringstream str;
+		str << "The resistor: " << this->name() << " has been removed by the"
+			<< " netlist reduction and can not be traced" << std::endl;
+		SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+		return false;
+	}
+
     //trace will be activated after every complete cluster calculation
     //by teh synchronization layer
     return get_sync_domain()->add_solver_trace(data);
@@ -119,6 +175,12 @@ void sca_r::trace_interactive()
 {
 	if(this->trd==NULL) return;
 
+	if(sca_r_current_eliminated(*this,nadd))
+	{
+		sca_r_report_current_eliminated(*this);
+		return;
+	}
+
     double through_value;
 
     if(nadd<0)
@@ -137,6 +199,12 @@ void sca_r::trace_interactive()
 
 sca_util::sca_complex sca_r::calculate_ac_result(sca_util::sca_complex* res_vec)
 {
+	if(sca_r_current_eliminated(*this,nadd))
+	{
+		sca_r_report_current_eliminated(*this);
+		return 0.0;
+	}
+
     //if reference node return 0.0
     sca_util::sca_complex rp = long(p) < 0 ? 0.0 : res_vec[p];
     sca_util::sca_complex rn = long(n) < 0 ? 0.0 : res_vec[n];
@@ -150,6 +218,11 @@ sca_util::sca_complex sca_r::calculate_ac_result(sca_util::sca_complex* res_vec)
 
 const double& sca_r::get_typed_trace_value() const
 {
+	if(sca_r_current_eliminated(*this,nadd))
+	{
+		sca_r_report_current_eliminated(*this);
+	}
+
 	if(this->trd==NULL)
 	{
 		this->trd=new sca_core::sca_implementation::sca_con_interactive_trace_data(this);
@@ -176,6 +249,12 @@ const std::string& sca_r::get_trace_value() const
 
 bool sca_r::register_trace_callback(sca_trace_callback cb,void* cb_arg)
 {
+	if(sca_r_current_eliminated(*this,nadd))
+	{
+		sca_r_report_current_eliminated(*this);
+		return false;
+	}
+
 	if(this->trd==NULL)
 	{
 		this->trd=new sca_core::sca_implementation::sca_con_interactive_trace_data(this);
@@ -191,6 +270,12 @@ bool sca_r::register_trace_callback(sca_trace_callback cb,void* cb_arg)
 
 bool sca_r::register_trace_callback(sca_util::sca_traceable_object::callback_functor_base& func)
 {
+	if(sca_r_current_eliminated(*this,nadd))
+	{
+		sca_r_report_current_eliminated(*this);
+		return false;
+	}
+
 	if(this->trd==NULL)
 	{
 		this->trd=new sca_core::sca_implementation::sca_con_interactive_trace_data(this);
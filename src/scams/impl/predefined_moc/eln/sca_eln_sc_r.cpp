@@ -95,7 +95,9 @@ void sca_r::read_rval()
     	enable_b_change=true;
     	continous=true;
 
-    	B_wr(nadd, nadd) = -inval;
+    	//a single diagonal entry changes - low-rank update
+    	B_wr(nadd, nadd, false) = -inval;
+    	set_pre_solve_methods(-curr_value, -inval, 3, nadd, nadd, -1, false);
     	curr_value=inval;
     }
 
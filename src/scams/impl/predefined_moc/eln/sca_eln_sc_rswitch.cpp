@@ -113,17 +113,21 @@ void sca_rswitch::update_rval()
 		enable_b_change = true;
 		continous       = false;
 
+		//the switch changes one entry or the four entries of its
+		//conductance only - thus a low-rank update is requested
 		if (short_cut)
 		{
-			B_wr(nadd, nadd) = -r_val;
+			B_wr(nadd, nadd, false) = -r_val;
+			set_pre_solve_methods(-r_old, -r_val, 3, nadd, nadd, -1, true);
 		}
 		else
 		{
 			double diff_val=1.0 / r_old - 1.0 / r_val;
-			B_wr(p, p) = B(p, p) - diff_val;
-			B_wr(p, n) = B(p, n) + diff_val;
-			B_wr(n, p) = B(n, p) + diff_val;
-			B_wr(n, n) = B(n, n) - diff_val;
+			B_wr(p, p, false) = B(p, p) - diff_val;
+			B_wr(p, n, false) = B(p, n) + diff_val;
+			B_wr(n, p, false) = B(n, p) + diff_val;
+			B_wr(n, n, false) = B(n, n) - diff_val;
+			set_pre_solve_methods(1.0 / r_old, 1.0 / r_val, 6, p, n, -1, true);
 		}
 
 		r_old = r_val;
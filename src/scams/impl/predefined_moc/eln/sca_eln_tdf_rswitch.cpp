@@ -102,16 +102,20 @@ void sca_rswitch::update_rval()
 		enable_b_change = true;
 		continous       = false;
 
+		//the switch changes one entry or the four entries of its
+		//conductance only - thus a low-rank update is requested
 		if (short_cut)
 		{
-			B_wr(nadd, nadd) = -r_val;
+			B_wr(nadd, nadd, false) = -r_val;
+			set_pre_solve_methods(-r_old, -r_val, 3, nadd, nadd, -1, true);
 		}
 		else
 		{
-			B_wr(p, p) = B(p, p) - 1.0 / r_old + 1.0 / r_val;
-			B_wr(p, n) = B(p, n) + 1.0 / r_old - 1.0 / r_val;
-			B_wr(n, p) = B(n, p) + 1.0 / r_old - 1.0 / r_val;
-			B_wr(n, n) = B(n, n) - 1.0 / r_old + 1.0 / r_val;
+			B_wr(p, p, false) = B(p, p) - 1.0 / r_old + 1.0 / r_val;
+			B_wr(p, n, false) = B(p, n) + 1.0 / r_old - 1.0 / r_val;
+			B_wr(n, p, false) = B(n, p) + 1.0 / r_old - 1.0 / r_val;
+			B_wr(n, n, false) = B(n, n) - 1.0 / r_old + 1.0 / r_val;
+			set_pre_solve_methods(1.0 / r_old, 1.0 / r_val, 6, p, n, -1, true);
 		}
 
 		r_old = r_val;
@@ -45,6 +45,14 @@
 #include "scams/impl/solver/linear/sca_linear_equation_if.h"
 #include "scams/impl/solver/linear/sca_linear_solver.h"
 #include "scams/impl/solver/user_solver/sca_generic_user_solver.h"
+#include "scams/impl/core/sca_simcontext.h"
+#include "scams/impl/core/sca_object_manager.h"
+#include "scams/impl/util/tracing/sca_trace_file_base.h"
+#include "scams/impl/util/tracing/sca_trace_object_data.h"
+#include <set>
+#include <map>
+#include <cstring>
+#include <algorithm>
 
 namespace sca_eln
 {
@@ -90,8 +98,23 @@ void lin_eqs_cluster::reinit_equations()
 	{
 		sca_eln::sca_module* lmod = dynamic_cast<sca_eln::sca_module*> (*mit);
 		lmod->add_equations.resize(0);
+
+		//part of the reduced conductances
+		if(reduced_modules.count(lmod)>0) continue;
+
 		lmod->matrix_stamps();
 	}
+
+	//negative node numbers (reference node) are ignored by the matrix
+	for(std::size_t i=0;i<reduced_conductances.size();++i)
+	{
+		const reduced_conductance& rc(reduced_conductances[i]);
+
+		eqs->B(rc.node_a,rc.node_a) +=  rc.value;
+		eqs->B(rc.node_a,rc.node_b) += -rc.value;
+		eqs->B(rc.node_b,rc.node_a) += -rc.value;
+		eqs->B(rc.node_b,rc.node_b) +=  rc.value;
+	}
 }
 
 ////////////////////////////////////////////////////////////////
@@ -171,6 +194,13 @@ void sca_eln_view::setup_equations()
 			}
 		}
 
+		//the reduction renumbers the channels, thus it must be performed
+		//before the solver is created
+		if((user_solver==NULL) && netlist_reduction_requested(lcl))
+		{
+			reduce_netlist(lcl);
+		}
+
 		//store all channels to a vector
 		std::vector<sca_core::sca_interface*> tmp_chan;
 		for(unsigned long i=0;i<lcl->channels.size();i++) tmp_chan.push_back(lcl->channels[i]);
@@ -421,5 +451,172 @@ void sca_eln_view::setup_equations()
 
 }
 
+////////////////////////////////////////////////////////////////
+
+//maximum number of neighbors of an eliminated node - the elimination of a
+//node with n neighbors creates up to n*(n-1)/2 conductances, for n<=3 the
+//number of conductances does not increase (no fill in)
+static const std::size_t NETLIST_REDUCTION_MAX_DEGREE = 3;
+
+////////////////////////////////////////////////////////////////
+
+bool sca_eln_view::netlist_reduction_requested(lin_eqs_cluster* lcl)
+{
+	//the solver parameter of the modules are assigned to the solver after
+	//its creation, however the reduction must be performed before - an
+	//explicit value of a module (true or false) overrides the default
+	for (sca_core::sca_implementation::sca_conservative_cluster::iterator
+			mit = lcl->begin(); mit != lcl->end(); ++mit)
+	{
+		sca_core::sca_module* mod=*mit;
+		for(std::size_t i=0;i<mod->solver_parameter.size();++i)
+		{
+			if(mod->solver_parameter[i]=="netlist_reduction")
+			{
+				return mod->solver_parameter_values[i]=="true";
+			}
+		}
+	}
+
+	std::string val=sca_core::sca_implementation::sca_get_curr_simcontext()->
+			get_sca_object_manager()->get_default_solver_parameter(
+					"sca_linear_solver","netlist_reduction");
+
+	return val=="true";
+}
+
+////////////////////////////////////////////////////////////////
+
+void sca_eln_view::reduce_netlist(lin_eqs_cluster* lcl)
+{
+	long nnodes=(long)(lcl->channels.size());
+	if(nnodes==0) return;
+
+	//traced objects must remain accessible
+	std::set<const sca_util::sca_traceable_object*> traced;
+	std::vector<sca_util::sca_implementation::sca_trace_file_base*>* tfl;
+	tfl=sca_core::sca_implementation::sca_get_curr_simcontext()->get_trace_list();
+	for(std::size_t i=0;(tfl!=NULL) && (i<tfl->size());++i)
+	{
+		sca_util::sca_implementation::sca_trace_file_base* tf=(*tfl)[i];
+		for(std::size_t j=0;j<tf->traces.size();++j)
+		{
+			traced.insert(tf->traces[j].trace_object);
+		}
+	}
+
+	//nodes connected to other views, traced nodes and nodes connected to
+	//other modules than resistors remain
+	sca_eln_netlist_reduction reduction(nnodes);
+	for(long i=0;i<nnodes;++i)
+	{
+		sca_core::sca_implementation::sca_conservative_signal* ch=lcl->channels[i];
+		const sca_util::sca_traceable_object* tobj=
+				dynamic_cast<const sca_util::sca_traceable_object*>(ch);
+
+		if(ch->connects_cviews || ((tobj!=NULL) && (traced.count(tobj)>0)))
+		{
+			reduction.set_fixed(i);
+		}
+	}
+
+	std::vector<sca_eln::sca_r*> resistors;
+	std::vector<sca_eln::sca_r*> wires;
+
+	for (sca_core::sca_implementation::sca_conservative_cluster::iterator
+			mit = lcl->begin(); mit != lcl->end(); ++mit)
+	{
+		sca_eln::sca_r* res=dynamic_cast<sca_eln::sca_r*>(*mit);
+
+		//derived classes may overload the stamps
+		if((res!=NULL) && (std::strcmp(res->kind(),"sca_eln::sca_r")!=0))
+		{
+			res=NULL;
+		}
+
+		const sca_util::sca_traceable_object* tobj=
+				dynamic_cast<const sca_util::sca_traceable_object*>(res);
+
+		if((res!=NULL) && ((tobj==NULL) || (traced.count(tobj)==0)))
+		{
+			long np=res->p.get_node_number();
+			long nn=res->n.get_node_number();
+			double val=res->value.get();
+
+			//conductance stamps (see sca_r::matrix_stamps)
+			if((val>1e-4) && (np!=nn))
+			{
+				resistors.push_back(res);
+				continue;
+			}
+
+			//ideal wire between two nodes
+			if((val==0.0) && (np>=0) && (nn>=0) && (np!=nn))
+			{
+				wires.push_back(res);
+				continue;
+			}
+		}
+
+		for(sca_core::sca_module::sca_port_base_list_iteratorT pit=
+				(*mit)->get_port_list().begin();
+				pit!=(*mit)->get_port_list().end(); ++pit)
+		{
+			sca_core::sca_implementation::sca_conservative_signal* ch=
+				dynamic_cast<sca_core::sca_implementation::sca_conservative_signal*>(
+						(*pit)->sca_get_interface());
+
+			if(ch!=NULL) reduction.set_fixed(ch->get_node_number());
+		}
+	}
+
+	for(std::size_t i=0;i<wires.size();++i)
+	{
+		reduction.add_wire(wires[i]->p.get_node_number(),
+				wires[i]->n.get_node_number());
+		lcl->reduced_modules.insert(wires[i]);
+	}
+
+	for(std::size_t i=0;i<resistors.size();++i)
+	{
+		reduction.add_conductance(resistors[i]->p.get_node_number(),
+				resistors[i]->n.get_node_number(),1.0/resistors[i]->value.get());
+		lcl->reduced_modules.insert(resistors[i]);
+	}
+
+	reduction.reduce(NETLIST_REDUCTION_MAX_DEGREE);
+
+	//merged channels get the number of the remaining node, eliminated
+	//channels the number -1 (the solution is not available)
+	std::vector<sca_core::sca_implementation::sca_conservative_signal*> channels;
+	for(long i=0;i<reduction.get_number_of_nodes();++i)
+	{
+		channels.push_back(lcl->channels[reduction.get_original_node(i)]);
+	}
+
+	for(long i=0;i<nnodes;++i)
+	{
+		lcl->channels[i]->node_number=reduction.get_node_number(i);
+	}
+
+	lcl->channels.swap(channels);
+	lcl->reduced_conductances=reduction.get_conductances();
+
+	unsigned long& info_mask(
+			sca_core::sca_implementation::sca_get_curr_simcontext()->get_information_mask());
+	if(info_mask & sca_util::sca_info::sca_eln_solver.mask)
+	{
+		std::ostringstream str;
+		str << "ELN netlist reduction of cluster with " << nnodes << " nodes: "
+			<< wires.size() << " ideal wires merged, "
+			<< reduction.get_number_of_eliminated_nodes()
+			<< " internal nodes eliminated, "
+			<< resistors.size() << " resistors replaced by "
+			<< lcl->reduced_conductances.size() << " conductances, "
+			<< lcl->channels.size() << " nodes remain" << std::endl;
+		SC_REPORT_INFO("SystemC-AMS",str.str().c_str());
+	}
+}
+
 }
 }
@@ -44,6 +44,8 @@
 #include "scams/impl/solver/linear/sca_linear_equation_if.h"
 #include "scams/impl/predefined_moc/conservative/sca_conservative_view.h"
 #include "scams/impl/synchronization/sca_synchronization_obj_if.h"
+#include "scams/impl/predefined_moc/eln/sca_eln_netlist_reduction.h"
+#include <set>
 
 namespace sca_core
 {
@@ -65,6 +67,15 @@ public:
 	sca_core::sca_implementation::sca_linear_equation_system* eqs;
 	sca_core::sca_implementation::request_parameters view_params;
 
+	//conductance between two nodes of the reduced netlist (-1: reference)
+	typedef sca_eln_netlist_reduction::conductance reduced_conductance;
+
+	//stamped instead of the resistors with reduced stamps
+	std::vector<reduced_conductance> reduced_conductances;
+
+	//modules whose stamps are replaced by the reduced conductances
+	std::set<const sca_core::sca_module*> reduced_modules;
+
 	friend class sca_linnet_view;
 
 public:
@@ -107,6 +118,16 @@ public:
 	{
 		return view_params.request_store_coefficients;
 	}
+
+	sc_dt::uint64& get_solver_state_idx()
+	{
+		return view_params.solver_state_idx;
+	}
+
+	unsigned int& get_number_of_solver_states()
+	{
+		return view_params.number_of_solver_states;
+	}
 };
 
 //////////////////////////
@@ -128,6 +149,14 @@ public:
 	/** Overwritten (virtual) method for equation setup */
 	virtual void setup_equations();
 
+	/** netlist reduction requested by solver parameter of a module or
+	 * by the default solver parameter */
+	bool netlist_reduction_requested(lin_eqs_cluster* lcl);
+
+	/** merges ideal wires and parallel resistors and eliminates internal
+	 * nodes of resistive subnetworks, the channels are renumbered */
+	void reduce_netlist(lin_eqs_cluster* lcl);
+
 private:
 
 	sca_core::sca_implementation::sca_linear_equation_system* eqs;
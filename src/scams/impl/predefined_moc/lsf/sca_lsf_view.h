@@ -96,6 +96,16 @@ public:
 	{
 		return view_params.request_store_coefficients;
 	}
+
+	sc_dt::uint64& get_solver_state_idx()
+	{
+		return view_params.solver_state_idx;
+	}
+
+	unsigned int& get_number_of_solver_states()
+	{
+		return view_params.number_of_solver_states;
+	}
 };
 
 //////////////////////////
@@ -0,0 +1,137 @@
+/*****************************************************************************
+
+    Copyright 2010-2013
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+  sca_ct_solver_pool.cpp - description
+
+  Original Author: Karsten Einwich Fraunhofer IIS/EAS Dresden
+
+  Created on: Feb 20, 2010
+
+ *****************************************************************************/
+
+/*****************************************************************************/
+
+#include <systemc-ams>
+#include "sca_ct_solver_pool.h"
+#include "scams/impl/solver/util/sparse_library/linear_analog_solver.h"
+#include <cstddef>
+#include <cctype>
+#include <algorithm>
+
+namespace sca_tdf
+{
+namespace sca_implementation
+{
+
+sca_ct_solver_pool::sca_ct_solver_pool()
+{
+}
+
+//the pool is never deleted, due proxies may be destroyed after static objects
+sca_ct_solver_pool& sca_ct_solver_pool::get_pool()
+{
+	static sca_ct_solver_pool* pool=new sca_ct_solver_pool;
+	return *pool;
+}
+
+
+sca_ct_solver_pool::entry* sca_ct_solver_pool::acquire(
+		const key_type& key, double h)
+{
+	group_map_t::iterator it=groups.find(std::make_pair(h,key));
+	if(it==groups.end()) return NULL;
+
+	it->second->users++;
+	return it->second;
+}
+
+
+sca_ct_solver_pool::entry* sca_ct_solver_pool::create(
+		const key_type& key, double h)
+{
+	entry* group=new entry;
+	group->key=key;
+	group->h=h;
+	group->sdata=NULL;
+	group->users=1;
+	group->euler_valid=false;
+
+	groups[std::make_pair(h,key)]=group;
+
+	return group;
+}
+
+
+void sca_ct_solver_pool::change_key(entry* group, const key_type& key, double h)
+{
+	groups.erase(std::make_pair(group->h,group->key));
+
+	group->key=key;
+	group->h=h;
+
+	groups[std::make_pair(h,key)]=group;
+}
+
+
+void sca_ct_solver_pool::release(entry*& group, sca_solv_instance* inst)
+{
+	if(group==NULL) return;
+
+	if(inst!=NULL) ana_detach_solver_instance(group->sdata,inst);
+
+	group->users--;
+	if(group->users==0)
+	{
+		groups.erase(std::make_pair(group->h,group->key));
+		ana_free_solver_data(&group->sdata);
+		delete group;
+	}
+
+	group=NULL;
+}
+
+
+unsigned long sca_ct_solver_pool::get_number_of_groups() const
+{
+	return (unsigned long)groups.size();
+}
+
+
+bool sca_ct_solver_pool::exact_discretization_requested() const
+{
+	std::string par=sca_core::sca_get_default_solver_parameter("sca_tdf", "exact_discretization");
+
+	std::transform(par.begin(), par.end(), par.begin(),
+	    [](unsigned char c){ return (char)std::tolower(c); });
+
+	if(par.empty() || (par=="false") || (par=="0")) return false;
+	if((par=="true") || (par=="1"))                 return true;
+
+	std::ostringstream str;
+	str << "solver parameter for solver sca_tdf and parameter exact_discretization set to unknown value: " << par;
+	SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+
+	return false;
+}
+
+}
+}
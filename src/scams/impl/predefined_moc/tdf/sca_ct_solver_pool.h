@@ -0,0 +1,112 @@
+/*****************************************************************************
+
+    Copyright 2010-2013
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+  sca_ct_solver_pool.h - description
+
+  Original Author: Karsten Einwich Fraunhofer IIS/EAS Dresden
+
+  Created on: Feb 20, 2010
+
+ *****************************************************************************/
+
+/*****************************************************************************/
+
+
+#ifndef SCA_CT_SOLVER_POOL_H_
+#define SCA_CT_SOLVER_POOL_H_
+
+#include <vector>
+#include <map>
+
+struct sca_solv_data;
+struct sca_solv_instance;
+
+namespace sca_tdf
+{
+namespace sca_implementation
+{
+
+/**
+ * Pool of the solver data of the continuous time proxies (sca_ltf_nd,
+ * sca_ltf_zp, sca_ss). Proxies with identical equation systems and time
+ * steps share one group - the matrices and factorizations exist only once,
+ * each proxy keeps only its state (state vector and derivative, see
+ * ana_attach_solver_instance). The proxies are evaluated within the
+ * processing of their modules and solve their instance by ana_solv, callers
+ * with the inputs of all instances of a group can solve the group in one
+ * sweep by ana_solv_batch.
+ */
+class sca_ct_solver_pool
+{
+public:
+
+	typedef std::vector<double> key_type;
+
+	struct entry
+	{
+		key_type       key;     //coefficients describing the equation system
+		double         h;       //time step
+		sca_solv_data* sdata;   //shared solver data
+		unsigned long  users;   //number of proxies using the group
+		bool           euler_valid; //Euler factorization valid for h
+	};
+
+	static sca_ct_solver_pool& get_pool();
+
+	/** returns the group for the equation system and time step or NULL,
+	 * the user count of the group is incremented */
+	entry* acquire(const key_type& key, double h);
+
+	/** creates a new group with one user - the solver data must be
+	 * initialized by the caller */
+	entry* create(const key_type& key, double h);
+
+	/** changes the key of a group, which has only one user - the solver
+	 * data must be reinitialized by the caller */
+	void change_key(entry* group, const key_type& key, double h);
+
+	/** releases the group, the solver data are removed with the last user */
+	void release(entry*& group, sca_solv_instance* inst);
+
+	unsigned long get_number_of_groups() const;
+
+	/** returns true if the exact discretization of small systems is
+	 * enabled by the default solver parameter exact_discretization of the
+	 * solver sca_tdf (default false) - the exact discretization assumes a
+	 * first order hold input and differs from the trapezoidal rule by the
+	 * discretization error of the trapezoidal rule */
+	bool exact_discretization_requested() const;
+
+private:
+
+	sca_ct_solver_pool();
+
+	typedef std::map<std::pair<double,key_type>,entry*> group_map_t;
+
+	group_map_t groups;
+};
+
+}
+}
+
+
+#endif /* SCA_CT_SOLVER_POOL_H_ */
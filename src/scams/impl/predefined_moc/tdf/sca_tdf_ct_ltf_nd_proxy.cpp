@@ -52,6 +52,8 @@ sca_ct_ltf_nd_proxy::sca_ct_ltf_nd_proxy(::sc_core::sc_object* object)
 {
 	num_old_ref = NULL;
 	den_old_ref = NULL;
+	num_old_version = 0;
+	den_old_version = 0;
 	reinit_request = true;
 	q = NULL;
 	q2 = NULL;
@@ -60,6 +62,8 @@ sca_ct_ltf_nd_proxy::sca_ct_ltf_nd_proxy(::sc_core::sc_object* object)
 	first_step = true;
 	time_interval = sc_core::SC_ZERO_TIME;
 	sdata = NULL;
+	solver_group = NULL;
+	solver_instance = NULL;
 	last_h = -1.0;
 	module_activations = -1;
 	pending_calculation = false;
@@ -135,6 +139,11 @@ sca_ct_ltf_nd_proxy::sca_ct_ltf_nd_proxy(::sc_core::sc_object* object)
 
 sca_ct_ltf_nd_proxy::~sca_ct_ltf_nd_proxy()
 {
+	//the instance may refer to a pending checkpoint
+	sca_ct_solver_pool::get_pool().release(solver_group,solver_instance);
+	ana_free_solver_instance(&solver_instance);
+	sdata = NULL;
+
 	free_checkpoint_data(&s_intern_module_backup);
 	free_checkpoint_data(&s_intern_tstep_module_backup);
 	free_checkpoint_data(&s_intern_tstep_backup);
@@ -166,68 +175,30 @@ void sca_ct_ltf_nd_proxy::set_max_delay(sca_core::sca_time mdelay)
 inline bool sca_ct_ltf_nd_proxy::coeff_changed(const sca_util::sca_vector<
 		double>& num, const sca_util::sca_vector<double>& den)
 {
-	//was there a write access or has the object changed since the last call
-	if (num.get_access_flag() || &num != num_old_ref)
-	{
-		num_old_ref = &num;
-
-		//has the dimension changed since the last call
-		if (num.length() != num_old.length())
-		{
-			num_old = num;
-			den_old = den;
-			den_old_ref = &den;
-
-			const_cast<sca_util::sca_vector<double>*> (&num)->reset_access_flag();
-			const_cast<sca_util::sca_vector<double>*> (&den)->reset_access_flag();
-
-			return true;
-		}
-
-		//has a value changed since the last call
-		for (unsigned int i = 0; i < num.length(); i++)
-			if (num[i] != num_old[i])
-			{
-				num_old = num;
-				den_old = den;
-				den_old_ref = &den;
-
-				const_cast<sca_util::sca_vector<double>*> (&num)->reset_access_flag();
-				const_cast<sca_util::sca_vector<double>*> (&den)->reset_access_flag();
-
-				return true;
-			}
-	}
+	//the version changes with every non-const access - if the objects and
+	//the versions are unchanged the coefficients are unchanged
+	unsigned long long num_version = num.get_version();
+	unsigned long long den_version = den.get_version();
 
-	//the same for the denumerator
-	if (den.get_access_flag() || &den != den_old_ref)
+	if ((&num == num_old_ref) && (num_version == num_old_version) &&
+		(&den == den_old_ref) && (den_version == den_old_version))
 	{
-		den_old_ref = &den;
-
-		if (den.length() != den_old.length())
-		{
-			num_old = num;
-			den_old = den;
-			num_old_ref = &num;
-
-			const_cast<sca_util::sca_vector<double>*> (&num)->reset_access_flag();
-			const_cast<sca_util::sca_vector<double>*> (&den)->reset_access_flag();
-
-			return true;
-		}
+		return false;
+	}
 
-		for (unsigned int i = 0; i < den.length(); i++)
-			if (den[i] != den_old[i])
-			{
-				num_old = num;
-				den_old = den;
-				num_old_ref = &num;
+	num_old_ref = &num;
+	den_old_ref = &den;
+	num_old_version = num_version;
+	den_old_version = den_version;
 
-				const_cast<sca_util::sca_vector<double>*> (&num)->reset_access_flag();
-				const_cast<sca_util::sca_vector<double>*> (&den)->reset_access_flag();
+	//has the dimension or a value changed since the last call
+	if ((num.length() != num_old.length()) || (den.length() != den_old.length())
+			|| (num != num_old) || (den != den_old))
+	{
+		num_old = num;
+		den_old = den;
 
-				return true;
-			}
+		return true;
 	}
 
 	return false;
@@ -365,9 +336,63 @@ inline void sca_ct_ltf_nd_proxy::initialize_equation_system(int init_mode,
 
 	if(number_of_all_equations > 0)
 	{
+		join_solver_group(init_mode,h);
+	}
+}
+
+
+//the equation system is defined by the denominator and the numerator length
+inline void sca_ct_ltf_nd_proxy::get_solver_key(sca_ct_solver_pool::key_type& key)
+{
+	key.resize(2+den_size);
+
+	key[0]=double(den_size);
+	key[1]=double(num_size);
+	for(unsigned long i=0;i<den_size;i++) key[2+i]=den_ltf[i];
+}
+
+
+//use the solver data of a proxy with the same equation system and timestep
+//or (re-)initialize the solver data
+inline void sca_ct_ltf_nd_proxy::join_solver_group(int init_mode, double h)
+{
+	sca_ct_solver_pool& pool=sca_ct_solver_pool::get_pool();
+	sca_ct_solver_pool::key_type key;
+
+	//the key changes only if the coefficients have been changed
+	if(reinit_request || (solver_group==NULL)) get_solver_key(key);
+	else                                      key=solver_group->key;
+
+	//the instance state must match the size of the equation system
+	if((solver_instance!=NULL) &&
+	   ((unsigned long)ana_get_dimension(solver_group->sdata)!=number_of_all_equations))
+	{
+		pool.release(solver_group,solver_instance);
+		ana_free_solver_instance(&solver_instance);
+	}
+
+	sca_ct_solver_pool::entry* group=pool.acquire(key,h);
+
+	if(group==NULL)
+	{
+		if((solver_group!=NULL) && (solver_group->users==1))
+		{
+			//the proxy is the only user - the solver data are re-initialized
+			pool.change_key(solver_group,key,h);
+			ana_attach_solver_instance(solver_group->sdata,solver_instance);
+		}
+		else
+		{
+			pool.release(solver_group,solver_instance);
+			solver_group=pool.create(key,h);
+		}
+
+		//the Euler factorization is not updated if only h changes
+		solver_group->euler_valid= (init_mode<2) || (solver_group->sdata==NULL) ||
+				(ana_get_algorithm(solver_group->sdata)==1);
 
 		int err=ana_reinit_sparse(A.get_sparse_matrix(), B.get_sparse_matrix(),
-				                                                h, &sdata, init_mode);
+				                                h, &solver_group->sdata, init_mode);
 
 		if (err)
 		{
@@ -380,7 +405,58 @@ inline void sca_ct_ltf_nd_proxy::initialize_equation_system(int init_mode,
 
 
 		}
+
+		//if requested, small systems with constant step size are solved by
+		//the exact discretization - if not possible the trapezoidal method
+		//is used
+		if(pool.exact_discretization_requested())
+		{
+			ana_init_exact_sparse(A.get_sparse_matrix(), B.get_sparse_matrix(),
+					                                     h, solver_group->sdata);
+		}
+	}
+	else if(group!=solver_group)
+	{
+		pool.release(solver_group,solver_instance);
+		solver_group=group;
+	}
+	else
+	{
+		//already a member of the group
+		pool.release(group,NULL);
+	}
+
+	sdata=solver_group->sdata;
+
+	bool restart=(init_mode<2);
+	if(solver_instance==NULL)
+	{
+		if(ana_allocate_solver_instance(number_of_all_equations,&solver_instance))
+		{
+			std::ostringstream str;
+			str << "Can't allocate enough memory for: " << ltf_object->name();
+			SC_REPORT_ERROR("SystemC-AMS",str.str().c_str());
+		}
+		restart=true;
 	}
+
+	if(restart) ana_restart_solver_instance(sdata,solver_instance);
+	else        ana_attach_solver_instance(sdata,solver_instance);
+
+	//the Euler factorization is required for the first steps
+	if(!solver_group->euler_valid && (ana_get_algorithm(sdata)==1))
+	{
+		ana_reinit_sparse(A.get_sparse_matrix(), B.get_sparse_matrix(),
+				                                             h, &sdata, 1);
+		solver_group->euler_valid=true;
+	}
+}
+
+
+inline sca_solv_data* sca_ct_ltf_nd_proxy::get_solver_data()
+{
+	if(solver_instance!=NULL) ana_attach_solver_instance(sdata,solver_instance);
+	return sdata;
 }
 
 
@@ -388,6 +464,10 @@ inline void sca_ct_ltf_nd_proxy::initialize()
 {
 	unsigned long s_size=0;
 
+	//a pending checkpoint refers to the internal state - it must be copied
+	//before the state is removed
+	ana_resolve_solver_check_point(get_solver_data());
+
 	//if internal S is used it will be reset for
 	//every re-initialization
 	s_intern.remove();
@@ -432,7 +512,9 @@ inline void sca_ct_ltf_nd_proxy::initialize()
 		SC_REPORT_ERROR("SystemC-AMS", str.str().c_str());
 	}
 
-	if(first_step)
+	//the backup vectors are only required for restoring the state, they are
+	//allocated by the first store otherwise
+	if(first_step && (module_is_dynamic || iterations_enabled))
 	{
 		//allocate memory for backup vectors
 		ana_allocate_solver_check_point(state_size,&s_intern_module_backup);
@@ -477,7 +559,7 @@ inline double sca_ct_ltf_nd_proxy::calculate(double invalue)
 	{
 		if(!dc_init)
 		{
-			ana_solv(q, s, sdata);
+			ana_solv(q, s, get_solver_data());
 		}
 	}
 
@@ -487,6 +569,9 @@ inline double sca_ct_ltf_nd_proxy::calculate(double invalue)
 	{
 		if(dc_init)
 		{
+			//the state is changed without solver step
+			ana_resolve_solver_check_point(get_solver_data());
+
 			//algebraic connection
 			s[number_of_equations]=-q2[0];
 		}
@@ -693,7 +778,7 @@ inline void sca_ct_ltf_nd_proxy::register_nd_common(
 
 					//reset the internal state vector to the module backup vector
 					//s_intern=s_intern_module_backup;
-					if(s_intern.length()>0) ana_restore_solver_check_point(sdata,s_intern.get_flat(),&s_intern_module_backup);
+					if(s_intern.length()>0) ana_swap_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_module_backup);
 
 					//reset the last calculated time to the module backup value
 					//(corresponds to the state vector)
@@ -745,7 +830,7 @@ inline void sca_ct_ltf_nd_proxy::register_nd_common(
 
 					//backup state vector
 					//s_intern_module_backup=s_intern;
-					if(s_intern.length()>0) ana_store_solver_check_point(sdata,s_intern.get_flat(),&s_intern_module_backup);
+					if(s_intern.length()>0) ana_flip_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_module_backup);
 					last_in_time_module_backup=last_calculated_in_time;
 					last_out_time_module_backup=last_out_time;
 					last_calculated_time_module_backup=last_calculated_time;
@@ -778,7 +863,7 @@ inline void sca_ct_ltf_nd_proxy::register_nd_common(
 				{
 					//reset statevector to value before last calculation
 					//s_intern=s_intern_tstep_backup;
-					if(s_intern.length()>0) ana_restore_solver_check_point(sdata,s_intern.get_flat(),&s_intern_tstep_backup);
+					if(s_intern.length()>0) ana_swap_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_tstep_backup);
 					last_calculated_in_time=last_in_time_tstep_backup;
 					last_out_time=last_out_time_tstep_backup;
 					last_calculated_time=last_calculated_time_tstep_backup;
@@ -804,7 +889,7 @@ inline void sca_ct_ltf_nd_proxy::register_nd_common(
 				{
 					//backup current calculation state
 					//s_intern_tstep_backup=s_intern;
-					if(s_intern.length()>0) ana_store_solver_check_point(sdata,s_intern.get_flat(),&s_intern_tstep_backup);
+					if(s_intern.length()>0) ana_flip_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_tstep_backup);
 					last_in_time_tstep_backup=last_calculated_in_time;
 					last_out_time_tstep_backup=last_out_time;
 					last_calculated_time_tstep_backup=last_calculated_time;
@@ -830,7 +915,7 @@ inline void sca_ct_ltf_nd_proxy::register_nd_common(
 				{
 					//restore state vector and time
 					//s_intern=s_intern_tstep_backup;
-					if(s_intern.length()>0) ana_restore_solver_check_point(sdata,s_intern.get_flat(),&s_intern_tstep_backup);
+					if(s_intern.length()>0) ana_swap_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_tstep_backup);
 					last_calculated_in_time=last_in_time_tstep_backup;
 					last_out_time=last_out_time_tstep_backup;
 					last_calculated_time=last_calculated_time_tstep_backup;
@@ -862,7 +947,7 @@ inline void sca_ct_ltf_nd_proxy::register_nd_common(
 
 					//restore state vector and time
 					//s_intern=s_intern_tstep_backup;
-					if(s_intern.length()>0) ana_restore_solver_check_point(sdata,s_intern.get_flat(),&s_intern_tstep_backup);
+					if(s_intern.length()>0) ana_swap_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_tstep_backup);
 					last_calculated_in_time=last_in_time_tstep_backup;
 					last_out_time=last_out_time_tstep_backup;
 					last_calculated_time=last_calculated_time_tstep_backup;
@@ -881,7 +966,7 @@ inline void sca_ct_ltf_nd_proxy::register_nd_common(
 			{
 				//backup tstep
 				//s_intern_tstep_backup=s_intern;
-				if(s_intern.length()>0) ana_store_solver_check_point(sdata,s_intern.get_flat(),&s_intern_tstep_backup);
+				if(s_intern.length()>0) ana_flip_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_tstep_backup);
 				last_in_time_tstep_backup=last_calculated_in_time;
 				last_out_time_tstep_backup=last_out_time;
 				last_calculated_time_tstep_backup=last_calculated_time;
@@ -1615,6 +1700,104 @@ inline void sca_ct_ltf_nd_proxy::calculate_timeinterval(
 	} //else delay_buffer!=NULL
 }
 
+/////////////////////////////////////////////////////////////////////////////
+
+//block calculation for multirate ports (e.g. decimation filter chains) - the
+//in samples are read directly from the port instead of searching each sample
+//in the delay buffer, the results are identical to calculate_timeinterval -
+//the in rate must be equal or a multiple of the out rate (decimation), each
+//out sample time must be an in sample time
+inline bool sca_ct_ltf_nd_proxy::calculate_block(
+		long current_out_index,
+		sca_core::sca_implementation::sca_signed_time& next_out_time,
+		sca_core::sca_time& out_time_step,
+		unsigned long port_rate)
+{
+	if((port_rate==0) || (number_of_in_values<2))         return false;
+	if((number_of_in_values%port_rate)!=0)                return false;
+	if((intype!=IN_SCA_PORT) && (intype!=IN_SC_PORT))     return false;
+	if(first_step || reinit_request || dc_init || dc_init_interval) return false;
+	if(module_is_dynamic || iterations_enabled)           return false;
+	if((ct_in_delay!=sc_core::SC_ZERO_TIME) || (delay_buffer==NULL)) return false;
+	if(current_out_index!=0) return false;
+
+	//decimation factor
+	unsigned long dec=number_of_in_values/port_rate;
+	if(out_time_step.value()!=in_time_step.value()*dec)   return false;
+
+	//the out samples must start at the first in sample, the last out
+	//sample is followed by dec-1 in samples
+	sca_core::sca_implementation::sca_signed_time first_time=next_out_time;
+	sca_core::sca_implementation::sca_signed_time last_out=
+			next_out_time+out_time_step*(port_rate-1);
+
+	if(next_out_time.value()!=module_current_time.value()) return false;
+	if((last_out+in_time_step*(dec-1)).value()!=
+			last_available_in_time.value()) return false;
+
+	//remaining in samples of the previous module activation (after the last
+	//out sample) must be followed by the first in sample of this activation
+	double value;
+	sca_core::sca_implementation::sca_signed_time ntime;
+	sca_core::sca_implementation::sca_signed_time ptime=last_calculated_time;
+	bool no_value;
+	while(!(no_value=delay_buffer->get_next_value_after(ntime,value,ptime)) &&
+			(ntime<next_out_time))
+	{
+		ptime=ntime;
+	}
+	if(no_value || (ntime.value()!=next_out_time.value())) return false;
+
+
+	if (!pending_calculation)
+	{
+		std::ostringstream str;
+		str << "The the ltf_nd proxy object is may assigned twice for: "
+				<< ltf_object->name();
+		SC_REPORT_ERROR("SystemC-AMS",str.str().c_str());
+	}
+	pending_calculation = false;
+
+	//integrate the remaining in samples of the previous activation
+	while(!delay_buffer->get_next_value_after(ntime,value,last_calculated_time) &&
+			(ntime<next_out_time))
+	{
+		double h = (ntime - last_calculated_time).to_seconds();
+
+		//if required (h changed) re-initialize equation system
+		initialize_equation_system(2, h);
+		calculate(value);
+
+		last_calculated_time = ntime;
+	}
+
+	//the in samples after the last out sample remain in the delay buffer
+	//for the next activation
+	unsigned long n_in=(port_rate-1)*dec+1;
+	sca_core::sca_implementation::sca_signed_time in_time=first_time;
+	for(unsigned long i=0;i<n_in;i++)
+	{
+		double h = (in_time - last_calculated_time).to_seconds();
+
+		//if required (h changed) re-initialize equation system
+		initialize_equation_system(2, h);
+
+		double outp = calculate(get_in_value_by_index(i));
+		if((i%dec)==0) write_out_value_by_index(outp, (long)(i/dec));
+
+		last_calculated_time = in_time;
+		in_time += in_time_step;
+	}
+
+	next_out_time = last_out+out_time_step;
+
+	last_calculated_in_time=last_calculated_time;
+	last_out_time=last_calculated_time;
+	delay_buffer->set_time_reached(last_calculated_time);
+
+	return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
@@ -1665,6 +1848,9 @@ inline void sca_ct_ltf_nd_proxy::convert_to_port(
 	//timestep after first step - equals to propagated step
 	sca_core::sca_time next_in_time_step = in_time_step;
 
+	//the whole module time interval is calculated with this call
+	bool whole_interval = calculate_to_end;
+
 	//enforce causality if out rate > in rate
 	if (calculate_to_end)
 	{
@@ -1695,6 +1881,13 @@ inline void sca_ct_ltf_nd_proxy::convert_to_port(
 		calculate_to_end = false;
 	}
 
+	//aligned multirate in/out ports are calculated as block
+	if(whole_interval &&
+	   calculate_block(current_out_index,next_out_time,out_time_step,port_rate))
+	{
+		return;
+	}
+
 	calculate_timeinterval(current_in_index, current_out_index,
 			port_rate, next_in_time, next_out_time, next_in_time_step,
 			out_time_step);
@@ -1853,7 +2046,7 @@ double sca_ct_ltf_nd_proxy::estimate_next_value()
 
 		double h=time_interval.to_seconds();
 
-		ana_store_solver_check_point(sdata,statep->get_flat(),&estimate_cp_data);
+		ana_store_solver_check_point(get_solver_data(),statep->get_flat(),&estimate_cp_data);
 		initialize_equation_system(2, h);
 		double tmp=last_calculated_in;
 
@@ -1861,7 +2054,7 @@ double sca_ct_ltf_nd_proxy::estimate_next_value()
 
 		//ignore this calculation
 		last_calculated_in=tmp;
-		ana_restore_solver_check_point(sdata,statep->get_flat(),&estimate_cp_data);
+		ana_restore_solver_check_point(get_solver_data(),statep->get_flat(),&estimate_cp_data);
 	}
 	else
 	{
@@ -41,9 +41,11 @@
 #include "systemc-ams"
 #include "scams/predefined_moc/tdf/sca_tdf_ct_proxy.h"
 #include "scams/impl/predefined_moc/tdf/sca_ct_delay_buffer.h"
+#include "scams/impl/predefined_moc/tdf/sca_ct_solver_pool.h"
 
 struct sca_solv_data;
 struct sca_solv_checkpoint_data;
+struct sca_solv_instance;
 
 namespace sca_tdf
 {
@@ -161,6 +163,8 @@ protected:
 
 	const sca_util::sca_vector<double>* num_old_ref;
 	const sca_util::sca_vector<double>* den_old_ref;
+	unsigned long long num_old_version;
+	unsigned long long den_old_version;
 
 	sca_util::sca_vector<double> num_old;
 	sca_util::sca_vector<double> den_old;
@@ -218,6 +222,17 @@ protected:
 
 	sca_solv_data   *sdata;
 	unsigned long memsize;
+
+	//the solver data are shared by all proxies with the same equation
+	//system and time step - the proxy keeps only its instance state
+	sca_ct_solver_pool::entry* solver_group;
+	sca_solv_instance* solver_instance;
+
+	void get_solver_key(sca_ct_solver_pool::key_type& key);
+	void join_solver_group(int init_mode, double h);
+
+	//attaches the instance state to the shared solver data
+	sca_solv_data* get_solver_data();
 	unsigned long dn, nn;
 
 
@@ -344,6 +359,14 @@ protected:
 			         sca_core::sca_time& next_in_time_step,
 			         sca_core::sca_time& out_time_step);
 
+	//calculates all samples of a multirate port activation in one loop,
+	//if in and out samples are aligned - returns false if not applicable
+	bool calculate_block(
+			long current_out_index,
+			sca_core::sca_implementation::sca_signed_time& next_out_time,
+			sca_core::sca_time& out_time_step,
+			unsigned long port_rate);
+
 	bool causal_warning_reported;
 
 	sca_core::sca_time ct_in_delay;
@@ -51,6 +51,8 @@ sca_ct_ltf_zp_proxy::sca_ct_ltf_zp_proxy(sc_core::sc_object* object):sca_ct_ltf_
 {
 	zeros_old_ref=NULL;
 	poles_old_ref=NULL;
+	zeros_old_version=0;
+	poles_old_version=0;
 }
 
 //quick check for coefficient change
@@ -58,68 +60,31 @@ inline bool sca_ct_ltf_zp_proxy::coeff_changed(
 		const sca_util::sca_vector<sca_util::sca_complex>& zeros,
 		const sca_util::sca_vector<sca_util::sca_complex>& poles)
 {
-	//was there a write access or has the object changed since the last call
-	if (zeros.get_access_flag() || &zeros != zeros_old_ref)
-	{
-		zeros_old_ref = &zeros;
-
-		//has the dimension changed since the last call
-		if( (zeros.length() != zeros_old.length()) || zeros.length()==0)
-		{
-			zeros_old = zeros;
-			poles_old = poles;
-			poles_old_ref = &poles;
-
-			const_cast<sca_util::sca_vector<sca_util::sca_complex>*> (&zeros)->reset_access_flag();
-			const_cast<sca_util::sca_vector<sca_util::sca_complex>*> (&poles)->reset_access_flag();
-
-			return true;
-		}
-
-		//has a value changed since the last call
-		for (unsigned int i = 0; i < zeros.length(); i++)
-			if (zeros[i] != zeros_old[i])
-			{
-				zeros_old = zeros;
-				poles_old = poles;
-				poles_old_ref = &poles;
-
-				const_cast<sca_util::sca_vector<sca_util::sca_complex>*> (&zeros)->reset_access_flag();
-				const_cast<sca_util::sca_vector<sca_util::sca_complex>*> (&poles)->reset_access_flag();
-
-				return true;
-			}
-	}
+	//the version changes with every non-const access - if the objects and
+	//the versions are unchanged the coefficients are unchanged
+	unsigned long long zeros_version = zeros.get_version();
+	unsigned long long poles_version = poles.get_version();
 
-	//the same for the denumerator
-	if (poles.get_access_flag() || &poles != poles_old_ref)
+	if ((&zeros == zeros_old_ref) && (zeros_version == zeros_old_version) &&
+		(&poles == poles_old_ref) && (poles_version == poles_old_version))
 	{
-		poles_old_ref = &poles;
-
-		if ((poles.length() != poles_old.length()) || poles.length()==0)
-		{
-			zeros_old = zeros;
-			poles_old = poles;
-			zeros_old_ref = &zeros;
-
-			const_cast<sca_util::sca_vector<sca_util::sca_complex>*> (&zeros)->reset_access_flag();
-			const_cast<sca_util::sca_vector<sca_util::sca_complex>*> (&poles)->reset_access_flag();
-
-			return true;
-		}
+		return false;
+	}
 
-		for (unsigned int i = 0; i < poles.length(); i++)
-			if (poles[i] != poles_old[i])
-			{
-				zeros_old = zeros;
-				poles_old = poles;
-				zeros_old_ref = &zeros;
+	zeros_old_ref = &zeros;
+	poles_old_ref = &poles;
+	zeros_old_version = zeros_version;
+	poles_old_version = poles_version;
 
-				const_cast<sca_util::sca_vector<sca_util::sca_complex>*> (&zeros)->reset_access_flag();
-				const_cast<sca_util::sca_vector<sca_util::sca_complex>*> (&poles)->reset_access_flag();
+	//has the dimension or a value changed since the last call
+	if ((zeros.length() != zeros_old.length()) || zeros.length()==0 ||
+		(poles.length() != poles_old.length()) || poles.length()==0 ||
+		(zeros != zeros_old) || (poles != poles_old))
+	{
+		zeros_old = zeros;
+		poles_old = poles;
 
-				return true;
-			}
+		return true;
 	}
 
 	return false;
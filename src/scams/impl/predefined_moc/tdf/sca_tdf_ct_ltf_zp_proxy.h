@@ -97,6 +97,8 @@ private:
 
 	const sca_util::sca_vector<sca_util::sca_complex>* zeros_old_ref;
 	const sca_util::sca_vector<sca_util::sca_complex>* poles_old_ref;
+	unsigned long long zeros_old_version;
+	unsigned long long poles_old_version;
 
 	sca_util::sca_vector<sca_util::sca_complex> zeros_old;
 	sca_util::sca_vector<sca_util::sca_complex> poles_old;
@@ -51,6 +51,10 @@ sca_ct_vector_ss_proxy::sca_ct_vector_ss_proxy(::sc_core::sc_object* object)
 	b_old_ref = NULL;
 	c_old_ref = NULL;
 	d_old_ref = NULL;
+	a_old_version = 0;
+	b_old_version = 0;
+	c_old_version = 0;
+	d_old_version = 0;
 
 	reinit_request = true;
 
@@ -62,6 +66,8 @@ sca_ct_vector_ss_proxy::sca_ct_vector_ss_proxy(::sc_core::sc_object* object)
 	first_step = true;
 	time_interval = sc_core::SC_ZERO_TIME;
 	sdata = NULL;
+	solver_group = NULL;
+	solver_instance = NULL;
 	last_h = -1.0;
 	module_activations = -1;
 	pending_calculation = false;
@@ -124,6 +130,11 @@ sca_ct_vector_ss_proxy::sca_ct_vector_ss_proxy(::sc_core::sc_object* object)
 
 sca_ct_vector_ss_proxy::~sca_ct_vector_ss_proxy()
 {
+	//the instance may refer to a pending checkpoint
+	sca_ct_solver_pool::get_pool().release(solver_group,solver_instance);
+	ana_free_solver_instance(&solver_instance);
+	sdata = NULL;
+
 	free_checkpoint_data(&s_intern_module_backup);
 	free_checkpoint_data(&s_intern_tstep_module_backup);
 	free_checkpoint_data(&s_intern_tstep_backup);
@@ -152,29 +163,30 @@ void sca_ct_vector_ss_proxy::set_max_delay(sca_core::sca_time mdelay)
 
 inline bool sca_ct_vector_ss_proxy::matrix_changed(const sca_util::sca_matrix<
 		double>& matrix, sca_util::sca_matrix<double>& matrix_old,
-		const sca_util::sca_matrix<double>*& matrix_old_ref)
+		const sca_util::sca_matrix<double>*& matrix_old_ref,
+		unsigned long long& matrix_old_version)
 {
-	//was there a write access or has the object changed since the last call
-	if (matrix.get_access_flag() || (&matrix_old != matrix_old_ref))
+	//the version changes with every non-const access - if the object and
+	//the version are unchanged the matrix is unchanged
+	unsigned long long version = matrix.get_version();
+
+	if ((&matrix == matrix_old_ref) && (version == matrix_old_version))
 	{
-		//has the dimension changed since the last call
-		if ((matrix.n_cols() != matrix_old.n_cols()) || (matrix.n_rows()
-				!= matrix_old.n_rows()))
-		{
-			return true;
-		}
+		return false;
+	}
 
-		//has a value changed since the last call
-		for (unsigned int i = 0; i < matrix.n_cols(); i++)
-			for (unsigned int j = 0; j < matrix.n_rows(); j++)
-			{
-				if (matrix(j, i) != matrix_old(j, i))
-					return true;
-			}
+	matrix_old_ref = &matrix;
+	matrix_old_version = version;
 
+	//has the dimension changed since the last call
+	if ((matrix.n_cols() != matrix_old.n_cols()) || (matrix.n_rows()
+			!= matrix_old.n_rows()))
+	{
+		return true;
 	}
 
-	return false;
+	//has a value changed since the last call
+	return matrix != matrix_old;
 }
 
 //quick check for coefficient change
@@ -183,25 +195,19 @@ inline bool sca_ct_vector_ss_proxy::coeff_changed(const sca_util::sca_matrix<
 		const sca_util::sca_matrix<double>& c, const sca_util::sca_matrix<
 				double>& d)
 {
-	if (matrix_changed(a, a_old, a_old_ref) || matrix_changed(b, b_old,
-			b_old_ref) || matrix_changed(c, c_old, c_old_ref)
-			|| matrix_changed(d, d_old, d_old_ref))
+	//all matrices are checked to update the versions
+	bool changed = matrix_changed(a, a_old, a_old_ref, a_old_version);
+	changed = matrix_changed(b, b_old, b_old_ref, b_old_version) || changed;
+	changed = matrix_changed(c, c_old, c_old_ref, c_old_version) || changed;
+	changed = matrix_changed(d, d_old, d_old_ref, d_old_version) || changed;
+
+	if (changed)
 	{
 		a_old = a;
 		b_old = b;
 		c_old = c;
 		d_old = d;
 
-		a_old_ref = &a;
-		b_old_ref = &b;
-		c_old_ref = &c;
-		d_old_ref = &d;
-
-		const_cast<sca_util::sca_matrix<double>*> (&a)->reset_access_flag();
-		const_cast<sca_util::sca_matrix<double>*> (&b)->reset_access_flag();
-		const_cast<sca_util::sca_matrix<double>*> (&c)->reset_access_flag();
-		const_cast<sca_util::sca_matrix<double>*> (&d)->reset_access_flag();
-
 		return true;
 	}
 
@@ -280,8 +286,65 @@ inline void sca_ct_vector_ss_proxy::initialize_equation_system(int init_mode,
 
 	if (number_of_equations > 0)
 	{
-		int err = ana_reinit(a_ss, b_ss, number_of_equations, h, &sdata,
-				init_mode);
+		join_solver_group(init_mode,h);
+	}
+
+}
+
+
+//the equation system is defined by the matrix A
+inline void sca_ct_vector_ss_proxy::get_solver_key(sca_ct_solver_pool::key_type& key)
+{
+	unsigned long nn=number_of_equations*number_of_equations;
+
+	key.resize(1+nn);
+
+	key[0]=double(number_of_equations);
+	for(unsigned long i=0;i<nn;i++) key[1+i]=b_ss[i];
+}
+
+
+//use the solver data of a proxy with the same equation system and timestep
+//or (re-)initialize the solver data
+inline void sca_ct_vector_ss_proxy::join_solver_group(int init_mode, double h)
+{
+	sca_ct_solver_pool& pool=sca_ct_solver_pool::get_pool();
+	sca_ct_solver_pool::key_type key;
+
+	//the key changes only if the coefficients have been changed
+	if(reinit_request || (solver_group==NULL)) get_solver_key(key);
+	else                                      key=solver_group->key;
+
+	//the instance state must match the size of the equation system
+	if((solver_instance!=NULL) &&
+	   ((unsigned long)ana_get_dimension(solver_group->sdata)!=number_of_equations))
+	{
+		pool.release(solver_group,solver_instance);
+		ana_free_solver_instance(&solver_instance);
+	}
+
+	sca_ct_solver_pool::entry* group=pool.acquire(key,h);
+
+	if(group==NULL)
+	{
+		if((solver_group!=NULL) && (solver_group->users==1))
+		{
+			//the proxy is the only user - the solver data are re-initialized
+			pool.change_key(solver_group,key,h);
+			ana_attach_solver_instance(solver_group->sdata,solver_instance);
+		}
+		else
+		{
+			pool.release(solver_group,solver_instance);
+			solver_group=pool.create(key,h);
+		}
+
+		//the Euler factorization is not updated if only h changes
+		solver_group->euler_valid= (init_mode<2) || (solver_group->sdata==NULL) ||
+				(ana_get_algorithm(solver_group->sdata)==1);
+
+		int err = ana_reinit(a_ss, b_ss, number_of_equations, h,
+				&solver_group->sdata, init_mode);
 		if (err)
 		{
 			std::ostringstream str;
@@ -291,14 +354,66 @@ inline void sca_ct_vector_ss_proxy::initialize_equation_system(int init_mode,
 					sc_core::SC_SEC) << "." << std::endl;
 			SC_REPORT_ERROR("SystemC-AMS", str.str().c_str());
 		}
+
+		//if requested, small systems with constant step size are solved by
+		//the exact discretization - if not possible the trapezoidal method
+		//is used
+		if(pool.exact_discretization_requested())
+		{
+			ana_init_exact(a_ss, b_ss, number_of_equations, h, solver_group->sdata);
+		}
+	}
+	else if(group!=solver_group)
+	{
+		pool.release(solver_group,solver_instance);
+		solver_group=group;
+	}
+	else
+	{
+		//already a member of the group
+		pool.release(group,NULL);
+	}
+
+	sdata=solver_group->sdata;
+
+	bool restart=(init_mode<2);
+	if(solver_instance==NULL)
+	{
+		if(ana_allocate_solver_instance(number_of_equations,&solver_instance))
+		{
+			std::ostringstream str;
+			str << "Can't allocate enough memory for: " << ltf_object->name();
+			SC_REPORT_ERROR("SystemC-AMS",str.str().c_str());
+		}
+		restart=true;
 	}
 
+	if(restart) ana_restart_solver_instance(sdata,solver_instance);
+	else        ana_attach_solver_instance(sdata,solver_instance);
+
+	//the Euler factorization is required for the first steps
+	if(!solver_group->euler_valid && (ana_get_algorithm(sdata)==1))
+	{
+		ana_reinit(a_ss, b_ss, number_of_equations, h, &sdata, 1);
+		solver_group->euler_valid=true;
+	}
+}
+
+
+inline sca_solv_data* sca_ct_vector_ss_proxy::get_solver_data()
+{
+	if(solver_instance!=NULL) ana_attach_solver_instance(sdata,solver_instance);
+	return sdata;
 }
 
 inline void sca_ct_vector_ss_proxy::initialize()
 {
 	unsigned long ax, ay, bx, by, cx, cy, dx, dy;
 
+	//a pending checkpoint refers to the internal state - it must be copied
+	//before the state is removed
+	ana_resolve_solver_check_point(get_solver_data());
+
 	//if internal S is used it will be reset for
 	//every re-initialization
 	s_intern.remove();
@@ -378,7 +493,9 @@ inline void sca_ct_vector_ss_proxy::initialize()
 		SC_REPORT_ERROR("SystemC-AMS", str.str().c_str());
 	}
 
-	if(first_step)
+	//the backup vectors are only required for restoring the state, they are
+	//allocated by the first store otherwise
+	if(first_step && (module_is_dynamic || iterations_enabled))
 	{
 		//allocate memory for backup vectors
 		ana_allocate_solver_check_point(state_size,&s_intern_module_backup);
@@ -425,7 +542,7 @@ inline sca_util::sca_vector<double> sca_ct_vector_ss_proxy::calculate(
 
 		if (number_of_equations > 0) //solve fractional part
 		{
-			if(!dc_init) ana_solv(q_ss, s, sdata);
+			if(!dc_init) ana_solv(q_ss, s, get_solver_data());
 			dc_init=false;
 		}
 
@@ -647,7 +764,7 @@ inline void sca_ct_vector_ss_proxy::register_ss_common(
 
 					//reset the internal state vector to the module backup vector
 					//s_intern=s_intern_module_backup;
-					if(s_intern.length()>0) ana_restore_solver_check_point(sdata,s_intern.get_flat(),&s_intern_module_backup);
+					if(s_intern.length()>0) ana_swap_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_module_backup);
 
 					//reset the last calculated time to the module backup value
 					//(corresponds to the state vector)
@@ -699,7 +816,7 @@ inline void sca_ct_vector_ss_proxy::register_ss_common(
 
 					//backup state vector
 					//s_intern_module_backup=s_intern;
-					if(s_intern.length()>0) ana_store_solver_check_point(sdata,s_intern.get_flat(),&s_intern_module_backup);
+					if(s_intern.length()>0) ana_flip_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_module_backup);
 					last_in_time_module_backup=last_calculated_in_time;
 					last_out_time_module_backup=last_out_time;
 					last_calculated_time_module_backup=last_calculated_time;
@@ -732,7 +849,7 @@ inline void sca_ct_vector_ss_proxy::register_ss_common(
 				{
 					//reset statevector to value before last calculation
 					//s_intern=s_intern_tstep_backup;
-					if(s_intern.length()>0) ana_restore_solver_check_point(sdata,s_intern.get_flat(),&s_intern_tstep_backup);
+					if(s_intern.length()>0) ana_swap_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_tstep_backup);
 					last_calculated_in_time=last_in_time_tstep_backup;
 					last_out_time=last_out_time_tstep_backup;
 					last_calculated_time=last_calculated_time_tstep_backup;
@@ -758,7 +875,7 @@ inline void sca_ct_vector_ss_proxy::register_ss_common(
 				{
 					//backup current calculation state
 					//s_intern_tstep_backup=s_intern;
-					if(s_intern.length()>0) ana_store_solver_check_point(sdata,s_intern.get_flat(),&s_intern_tstep_backup);
+					if(s_intern.length()>0) ana_flip_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_tstep_backup);
 					last_in_time_tstep_backup=last_calculated_in_time;
 					last_out_time_tstep_backup=last_out_time;
 					last_calculated_time_tstep_backup=last_calculated_time;
@@ -784,7 +901,7 @@ inline void sca_ct_vector_ss_proxy::register_ss_common(
 				{
 					//restore state vector and time
 					//s_intern=s_intern_tstep_backup;
-					if(s_intern.length()>0) ana_restore_solver_check_point(sdata,s_intern.get_flat(),&s_intern_tstep_backup);
+					if(s_intern.length()>0) ana_swap_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_tstep_backup);
 					last_calculated_in_time=last_in_time_tstep_backup;
 					last_out_time=last_out_time_tstep_backup;
 					last_calculated_time=last_calculated_time_tstep_backup;
@@ -816,7 +933,7 @@ inline void sca_ct_vector_ss_proxy::register_ss_common(
 
 					//restore state vector and time
 					//s_intern=s_intern_tstep_backup;
-					if(s_intern.length()>0) ana_restore_solver_check_point(sdata,s_intern.get_flat(),&s_intern_tstep_backup);
+					if(s_intern.length()>0) ana_swap_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_tstep_backup);
 					last_calculated_in_time=last_in_time_tstep_backup;
 					last_out_time=last_out_time_tstep_backup;
 					last_calculated_time=last_calculated_time_tstep_backup;
@@ -835,7 +952,7 @@ inline void sca_ct_vector_ss_proxy::register_ss_common(
 			{
 				//backup tstep
 				//s_intern_tstep_backup=s_intern;
-				if(s_intern.length()>0) ana_store_solver_check_point(sdata,s_intern.get_flat(),&s_intern_tstep_backup);
+				if(s_intern.length()>0) ana_flip_solver_check_point(get_solver_data(),s_intern.get_flat(),&s_intern_tstep_backup);
 				last_in_time_tstep_backup=last_calculated_in_time;
 				last_out_time_tstep_backup=last_out_time;
 				last_calculated_time_tstep_backup=last_calculated_time;
@@ -1850,7 +1967,7 @@ sca_util::sca_vector<double> sca_ct_vector_ss_proxy::estimate_next_value()
 
 		double h=time_interval.to_seconds();
 
-		ana_store_solver_check_point(sdata,statep->get_flat(),&estimate_cp_data);
+		ana_store_solver_check_point(get_solver_data(),statep->get_flat(),&estimate_cp_data);
 		initialize_equation_system(2, h);
 		sca_util::sca_vector<double> tmp=last_calculated_in;
 
@@ -1858,7 +1975,7 @@ sca_util::sca_vector<double> sca_ct_vector_ss_proxy::estimate_next_value()
 
 		//ignore this calculation
 		last_calculated_in=tmp;
-		ana_restore_solver_check_point(sdata,statep->get_flat(),&estimate_cp_data);
+		ana_restore_solver_check_point(get_solver_data(),statep->get_flat(),&estimate_cp_data);
 	}
 
 
@@ -41,9 +41,11 @@
 #include "systemc-ams"
 #include "scams/predefined_moc/tdf/sca_tdf_ct_vector_proxy.h"
 #include "scams/impl/predefined_moc/tdf/sca_ct_delay_buffer.h"
+#include "scams/impl/predefined_moc/tdf/sca_ct_solver_pool.h"
 
 struct sca_solv_data;
 struct sca_solv_checkpoint_data;
+struct sca_solv_instance;
 
 namespace sca_tdf
 {
@@ -170,6 +172,10 @@ protected:
 	const sca_util::sca_matrix<double>* b_old_ref;
 	const sca_util::sca_matrix<double>* c_old_ref;
 	const sca_util::sca_matrix<double>* d_old_ref;
+	unsigned long long a_old_version;
+	unsigned long long b_old_version;
+	unsigned long long c_old_version;
+	unsigned long long d_old_version;
 
 	sca_util::sca_matrix<double> a_old;
 	sca_util::sca_matrix<double> b_old;
@@ -210,7 +216,8 @@ protected:
 	bool matrix_changed(
 			const sca_util::sca_matrix<double>&  matrix,
 			sca_util::sca_matrix<double>&        matrix_old,
-			const sca_util::sca_matrix<double>*& matrix_old_ref);
+			const sca_util::sca_matrix<double>*& matrix_old_ref,
+			unsigned long long&                  matrix_old_version);
 
 	bool coeff_changed(
 			const sca_util::sca_matrix<double>& a,
@@ -237,6 +244,17 @@ protected:
 	double *a_ss, *b_ss, *q_ss;
 	sca_solv_data   *sdata;
 	unsigned long memsize;
+
+	//the solver data are shared by all proxies with the same equation
+	//system and time step - the proxy keeps only its instance state
+	sca_ct_solver_pool::entry* solver_group;
+	sca_solv_instance* solver_instance;
+
+	void get_solver_key(sca_ct_solver_pool::key_type& key);
+	void join_solver_group(int init_mode, double h);
+
+	//attaches the instance state to the shared solver data
+	sca_solv_data* get_solver_data();
 	unsigned long dn, nn;
 
 
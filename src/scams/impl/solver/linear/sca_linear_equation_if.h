@@ -83,6 +83,9 @@ class sca_linear_equation_if
   virtual int& get_request_restore_checkpoint()	 = 0;
   virtual bool& get_request_store_coefficients() = 0;
 
+  virtual sc_dt::uint64& get_solver_state_idx()  = 0;
+  virtual unsigned int& get_number_of_solver_states() = 0;
+
   virtual ~sca_linear_equation_if() {};
 };
 
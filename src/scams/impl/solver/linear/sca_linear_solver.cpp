@@ -49,10 +49,31 @@
 
 #include <climits>
 #include<cstring>
+#include <cmath>
 
 
 //#define DEBUG_PWL
 
+//max. number of changed B coefficients forming the key of the switch state,
+//if more coefficients differ from the initialization the key becomes invalid
+static const std::size_t B_CHANGE_STATE_MAX_SIZE = 4096;
+
+//max. number of changed lines handled by low-rank updates, if
+//requested by modules (see sca_conservative_module::request_woodbury)
+static const long WOODBURY_DEFAULT_MAX_RANK = 8;
+
+//max. number of breakpoint predictions per segment border, afterwards the
+//timestep is halved
+static const unsigned long PWL_MAX_BREAKPOINT_PREDICTIONS = 4;
+
+//pseudo timestep relative to the cluster timestep for DC operating points
+//with singular B matrix, the Euler steps are repeated until the state
+//changes less than the tolerances
+static const double DC_PSEUDO_TIMESTEP_FACTOR = 1e6;
+static const unsigned long DC_MAX_PSEUDO_STEPS = 100;
+static const double DC_RELTOL = 1e-9;
+static const double DC_ABSTOL = 1e-12;
+
 namespace sca_core
 {
 namespace sca_implementation
@@ -104,9 +125,23 @@ sca_linear_solver::sca_linear_solver(std::vector<sca_module*>& mods,
 	 first_timestep = true;
 
 	 force_implicit_euler_method = false;
+	 bdf2_method=false;
 	 reinitialization_steps=-1;
 	 algorithm_set=false;
 	 algorithm_module=NULL;
+	 factorization_cache_size=4;
+	 woodbury_max_rank=-1;
+	 ordering=0;
+	 substep_reltol=0.0;
+	 substep_abstol=1e-6;
+	 pwl_breakpoint_interpolation=false;
+	 pwl_breakpoint_predictions=0;
+	 dc_operating_point=false;
+
+	 acceptable_dt=-1.0;
+	 substep_dt_cp=0.0;
+	 acceptable_dt_cp=-1.0;
+	 substep_data=NULL;
 
 
 	 pwl_iteration_cp =NULL;
@@ -128,6 +163,17 @@ sca_linear_solver::sca_linear_solver(std::vector<sca_module*>& mods,
 	 statistics_cur_pwl_timestep_iterations=0;
 
 	 statistics_pwl_min_timestep=1e64;
+	 statistics_pwl_cache_hits=0;
+	 statistics_pwl_cache_misses=0;
+
+	 factorization_key=0;
+	 factorization_key_valid=false;
+	 b_change_processed=0;
+	 b_change_state_overflow=false;
+
+	 statistics_dc_found=false;
+	 statistics_dc_pwl_iterations=0;
+	 statistics_dc_pseudo_steps=0;
 
 	 //default use euler
 	 last_reinit_flag=1;
@@ -178,12 +224,22 @@ void sca_linear_solver::set_solver_parameter(
 		if(val=="euler")
 		{
 			force_implicit_euler_method=true;
+			bdf2_method=false;
+			return;
+		}
+
+		//two step backward differentiation formula (Gear) instead of trapez
+		if((val=="bdf2") || (val=="gear"))
+		{
+			force_implicit_euler_method=false;
+			bdf2_method=true;
 			return;
 		}
 
 		if(val=="default")
 		{
 			force_implicit_euler_method=false;
+			bdf2_method=false;
 			return;
 		}
 
@@ -197,7 +253,7 @@ void sca_linear_solver::set_solver_parameter(
 		{
 			str << " set by module: " << mod->name() << " of kind: " << mod->kind();
 		}
-		str << " valid valiues are: euler and default - ignore parameter";
+		str << " valid valiues are: euler, bdf2, gear and default - ignore parameter";
 		SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
 
 		return;
@@ -222,11 +278,211 @@ void sca_linear_solver::set_solver_parameter(
 		return;
 	}
 
+	if(par=="factorization_cache_size")
+	{
+		std::istringstream istr(val);
+		long size;
+		istr>>size;
+		if(istr.fail() || (size<0))
+		{
+			std::ostringstream str;
+			str << "Value: " << val << " for solver parameter: " << par;
+			str << " can't be read as non-negative integer value - parameter ignored";
+			SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+			return;
+		}
+
+		factorization_cache_size=size;
+
+		if(internal_solver_data!=NULL)
+		{
+			ana_set_factorization_cache_size(internal_solver_data,size);
+		}
+
+		return;
+	}
+
+	if(par=="ordering")
+	{
+		if((val=="markowitz") || (val=="default"))
+		{
+			ordering=0;
+		}
+		else if(val=="minimum_degree")
+		{
+			ordering=1;
+		}
+		else if(val=="nested_dissection")
+		{
+			ordering=2;
+		}
+		else if(val=="block_triangular")
+		{
+			ordering=3;
+		}
+		else
+		{
+			std::ostringstream str;
+			str << "Unknown value: " << val << " for solver parameter: " << par;
+			str << " valid values are: markowitz, minimum_degree,";
+			str << " nested_dissection and block_triangular - ignore parameter";
+			SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+			return;
+		}
+
+		//takes effect with the next code generation
+		if(internal_solver_data!=NULL)
+		{
+			ana_set_ordering(internal_solver_data,ordering);
+		}
+
+		return;
+	}
+
+	if(par=="woodbury_max_rank")
+	{
+		std::istringstream istr(val);
+		long rank;
+		istr>>rank;
+		if(istr.fail() || (rank<-1))
+		{
+			std::ostringstream str;
+			str << "Value: " << val << " for solver parameter: " << par;
+			str << " can't be read as integer value >= -1 - parameter ignored";
+			SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+			return;
+		}
+
+		//-1: low-rank updates only if requested by modules
+		woodbury_max_rank=rank;
+
+		if((internal_solver_data!=NULL) && (rank>=0))
+		{
+			ana_set_woodbury_max_rank(internal_solver_data,rank);
+		}
+
+		return;
+	}
+
+
+	if(par=="pwl_breakpoints")
+	{
+		if((val=="bisection") || (val=="default"))
+		{
+			pwl_breakpoint_interpolation=false;
+		}
+		else if(val=="interpolation")
+		{
+			pwl_breakpoint_interpolation=true;
+		}
+		else
+		{
+			std::ostringstream str;
+			str << "Unknown value: " << val << " for solver parameter: " << par;
+			str << " valid values are: bisection, interpolation and default";
+			str << " - ignore parameter";
+			SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+		}
+
+		return;
+	}
+
+	//relative tolerance of the local error, enables sub-stepping
+	if((par=="substep_reltol") || (par=="substep_abstol"))
+	{
+		std::istringstream istr(val);
+		double tol;
+		istr>>tol;
+		if(istr.fail() || (tol<0.0) || ((par=="substep_abstol") && (tol<=0.0)))
+		{
+			std::ostringstream str;
+			str << "Value: " << val << " for solver parameter: " << par;
+			if(par=="substep_reltol")
+			{
+				str << " can't be read as non-negative value - parameter ignored";
+			}
+			else
+			{
+				str << " can't be read as positive value - parameter ignored";
+			}
+			SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+			return;
+		}
+
+		if(par=="substep_reltol") substep_reltol=tol;
+		else                      substep_abstol=tol;
+
+		return;
+	}
+
+	//the first timestep starts at the DC operating point
+	if(par=="dc_operating_point")
+	{
+		if(val=="true")
+		{
+			dc_operating_point=true;
+		}
+		else if((val=="false") || (val=="default"))
+		{
+			dc_operating_point=false;
+		}
+		else
+		{
+			std::ostringstream str;
+			str << "Unknown value: " << val << " for solver parameter: " << par;
+			str << " valid values are: true, false and default - ignore parameter";
+			SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+		}
+
+		return;
+	}
+
+	//the netlist reduction is performed by the eln view during elaboration
+	if(par=="netlist_reduction")
+	{
+		if((val!="true") && (val!="false") && (val!="default"))
+		{
+			std::ostringstream str;
+			str << "Unknown value: " << val << " for solver parameter: " << par;
+			str << " valid values are: true, false and default - ignore parameter";
+			SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+		}
+
+		return;
+	}
+
 
 	//parameter unknown -> print warning from base class
 	this->sca_solver_base::set_solver_parameter(mod,par,val);
 }
 
+//////////////////////////////////////////////////////////////////////
+
+bool sca_linear_solver::get_solver_parameter(
+		  const std::string& par,
+		  std::string& val) const
+{
+	//largest timestep, which satisfies the sub-step tolerances - may be
+	//used by change_attributes to increase the cluster timestep
+	if(par=="acceptable_timestep")
+	{
+		if(acceptable_dt<0.0)
+		{
+			val="";
+		}
+		else
+		{
+			std::ostringstream str;
+			str << acceptable_dt;
+			val=str.str();
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
 
 //////////////////////////////////////////////////////////////////////
 
@@ -693,40 +949,224 @@ void sca_linear_solver::init_eq_system()
 	init_pwl_data(false);
 
 
-	int err = 0;
-	if (A->is_sparse_mode())
+	//the settings are applied before the first code generation, thus the
+	//codes are generated once for the selected method and ordering
+	int err = ana_alloc_solver_data(&internal_solver_data);
+
+	if(!err)
+	{
+		if(force_implicit_euler_method)
+		{
+			ana_set_algorithm(internal_solver_data,0);
+		}
+		else if(bdf2_method)
+		{
+			ana_set_algorithm(internal_solver_data,2);
+		}
+		else
+		{
+			ana_set_algorithm(internal_solver_data,1);
+
+		}
+
+		if(reinitialization_steps>0)
+		{
+			ana_set_reinit_steps(internal_solver_data, reinitialization_steps-1);
+		}
+
+		ana_set_factorization_cache_size(internal_solver_data,factorization_cache_size);
+		set_woodbury_max_rank(false);
+		ana_set_ordering(internal_solver_data,ordering);
+
+		if (A->is_sparse_mode())
+		{
+			err = ana_init_sparse(A->get_sparse_matrix(), B->get_sparse_matrix(),
+					dt, &internal_solver_data, 0);
+		}
+		else
+		{
+			err = ana_init(A->get_flat(), B->get_flat(), A->n_cols(), dt,
+				&internal_solver_data, 0);
+		}
+	}
+
+	if (err) error_message(err, 0, 0.0);
+
+	call_id++;
+
+	//forbid access to tdf port attributes
+	(*this->get_allow_processing_access_flag_ref())=false;
+}
+
+//////////////////////////////////////////
+
+//sets key of current switch state for factorization cache
+void sca_linear_solver::set_factorization_key()
+{
+	if(factorization_cache_size<=0) return;
+
+	//modules maintain solver states
+	if(equation_if->get_number_of_solver_states()>0)
 	{
-	 	err = ana_init_sparse(A->get_sparse_matrix(), B->get_sparse_matrix(),
-	 			dt, &internal_solver_data, 0);
+		factorization_key=equation_if->get_solver_state_idx();
+		factorization_key_valid=equation_if->get_number_of_solver_states()<=64;
+		set_pwl_factorization_key();
+		return;
 	}
-	else
+
+	//the changes are reset at the begin of a pwl timestep only, thus only
+	//the changes added since the last call are processed
+	if(B_change->get_number_of_changes()<b_change_processed)
 	{
-		err = ana_init(A->get_flat(), B->get_flat(), A->n_cols(), dt,
-			&internal_solver_data, 0);
+		b_change_processed=0;
 	}
 
+	//otherwise the key is build from all B coefficients, which differ from
+	//the initialization
+	for(unsigned long i=b_change_processed;i<B_change->get_number_of_changes();i++)
+	{
+		unsigned long idx,idy;
+		double cur_value;
+		double old_value;
+		bool cont;
+
+		B_change->get_change(i,idy,idx,cur_value,old_value,cont);
+
+		if(b_change_state_overflow) continue;
 
-	if(force_implicit_euler_method)
+		std::pair<unsigned long,unsigned long> pos(idy,idx);
+		std::map<std::pair<unsigned long,unsigned long>,
+			std::pair<double,double> >::iterator sit=b_change_state.find(pos);
+
+		if(sit==b_change_state.end())
+		{
+			//the first old value is the value of the initialization
+			if(cur_value!=old_value)
+			{
+				b_change_state[pos]=std::make_pair(old_value,cur_value);
+			}
+		}
+		else if(cur_value==sit->second.first)
+		{
+			b_change_state.erase(sit);
+		}
+		else
+		{
+			sit->second.second=cur_value;
+		}
+
+		if(b_change_state.size()>B_CHANGE_STATE_MAX_SIZE)
+		{
+			b_change_state.clear();
+			b_change_state_overflow=true;
+		}
+	}
+
+	b_change_processed=B_change->get_number_of_changes();
+
+	//too many changed coefficients - the state is not identified
+	if(b_change_state_overflow)
 	{
-		ana_set_algorithm(internal_solver_data,0);
+		factorization_key=0;
+		factorization_key_valid=false;
+		set_pwl_factorization_key();
+		return;
 	}
-	else
+
+	//FNV-1a hash
+	sc_dt::uint64 key=14695981039346656037ULL;
+	std::map<std::pair<unsigned long,unsigned long>,
+		std::pair<double,double> >::iterator it;
+	for(it=b_change_state.begin();it!=b_change_state.end();++it)
 	{
-		ana_set_algorithm(internal_solver_data,1);
+		sc_dt::uint64 val[3];
+		val[0]=it->first.first;
+		val[1]=it->first.second;
+		std::memcpy(&val[2],&it->second.second,sizeof(double));
 
+		for(int j=0;j<3;j++)
+		{
+			key^=val[j];
+			key*=1099511628211ULL;
+		}
 	}
 
-	if(reinitialization_steps>0)
+	factorization_key=key;
+	factorization_key_valid=true;
+	set_pwl_factorization_key();
+}
+
+//////////////////////////////////////////
+
+//extends the key of the switch state by the active pwl segments, thus
+//recurring combinations of step size and segments are found in the cache
+void sca_linear_solver::set_pwl_factorization_key()
+{
+	if(factorization_cache_size<=0) return;
+
+	if(!pwl_coeff_available)
 	{
-		ana_set_reinit_steps(internal_solver_data, reinitialization_steps-1);
+		ana_set_factorization_key(internal_solver_data,
+				factorization_key,factorization_key_valid);
+		return;
 	}
-			
-	if (err) error_message(err, 0, 0.0);
 
-	call_id++;
+	//FNV-1a hash - the cache compares the matrix values anyway, thus
+	//an ambiguous switch state key can be used as well, a switch state
+	//without key remains without key
+	sc_dt::uint64 key=factorization_key;
+	for(unsigned long i=0;i<pwl_coefficients.size();++i)
+	{
+		key^=pwl_coefficients[i].current_segment;
+		key*=1099511628211ULL;
+	}
 
-	//forbid access to tdf port attributes
-	(*this->get_allow_processing_access_flag_ref())=false;
+	ana_set_factorization_key(internal_solver_data,key,factorization_key_valid);
+}
+
+//////////////////////////////////////////
+
+//reinitializes the equation system for a pwl sub-interval
+int sca_linear_solver::reinit_pwl(double timestep)
+{
+	long hits_before, misses_before, hits, misses;
+
+	set_pwl_factorization_key();
+
+	ana_get_factorization_cache_statistics(internal_solver_data,
+			&hits_before, &misses_before);
+
+	int err = ana_reinit_sparse(
+			A->get_sparse_matrix(),
+			B->get_sparse_matrix(),
+			timestep,
+			&internal_solver_data,
+			2 //initialize for trapez -> no euler step
+			);
+
+	ana_get_factorization_cache_statistics(internal_solver_data,
+			&hits, &misses);
+
+	statistics_pwl_cache_hits+=hits-hits_before;
+	statistics_pwl_cache_misses+=misses-misses_before;
+
+	return err;
+}
+
+//////////////////////////////////////////
+
+//enables low-rank updates for reinitializations requested as Woodbury
+void sca_linear_solver::set_woodbury_max_rank(bool woodbury_requested)
+{
+	//fixed by solver parameter
+	if(woodbury_max_rank>=0)
+	{
+		ana_set_woodbury_max_rank(internal_solver_data,woodbury_max_rank);
+		return;
+	}
+
+	ana_set_woodbury_max_rank(internal_solver_data,
+			woodbury_requested ? WOODBURY_DEFAULT_MAX_RANK : 0);
 }
 
 //////////////////////////////////////////
@@ -819,6 +1259,16 @@ bool sca_linear_solver::do_pwl_iteration(int& check_mode,double& timestep)
 	}
 
 
+	//values of the rejected step for the breakpoint prediction
+	if((ch_res==1) && pwl_breakpoint_interpolation)
+	{
+		pwl_trial_x.resize(pwl_coefficients.size());
+		for(unsigned long i=0;i<pwl_coefficients.size();++i)
+		{
+			pwl_trial_x[i]=x_flat[pwl_coefficients[i].arg_idx];
+		}
+	}
+
 	ana_restore_solver_check_point(internal_solver_data,x_flat,&pwl_iteration_cp);
 
 
@@ -826,7 +1276,22 @@ bool sca_linear_solver::do_pwl_iteration(int& check_mode,double& timestep)
 	{
 	case 1: //no segment changes
 	{
-		timestep = timestep / 2.0;
+		double predicted_timestep=-1.0;
+		if(pwl_breakpoint_interpolation &&
+		   (pwl_breakpoint_predictions<PWL_MAX_BREAKPOINT_PREDICTIONS))
+		{
+			predicted_timestep=predict_pwl_breakpoint(timestep);
+			pwl_breakpoint_predictions++;
+		}
+
+		if((predicted_timestep>0.0) && (predicted_timestep<=timestep))
+		{
+			timestep = predicted_timestep;
+		}
+		else
+		{
+			timestep = timestep / 2.0;
+		}
 
 		if (timestep < 1e-15)
 		{
@@ -847,12 +1312,7 @@ bool sca_linear_solver::do_pwl_iteration(int& check_mode,double& timestep)
 		//we must interpolate q
 		interpolate_B_q(reached_dt+timestep);
 
-		int err = ana_reinit_sparse(
-				A->get_sparse_matrix(),
-				B->get_sparse_matrix(),
-				timestep,
-				&internal_solver_data, 2 //initialize for trapez -> no euler step
-				);
+		int err = reinit_pwl(timestep); //trapez -> no euler step
 		if (err)
 		{
 			print_reinitialization_error();
@@ -876,13 +1336,7 @@ bool sca_linear_solver::do_pwl_iteration(int& check_mode,double& timestep)
 		change_pwl_coefficients();
 
 
-		int err = ana_reinit_sparse(
-				A->get_sparse_matrix(),
-				B->get_sparse_matrix(),
-				timestep,
-				&internal_solver_data,
-				2 //initialize for trapez -> no euler step
-				);
+		int err = reinit_pwl(timestep); //trapez -> no euler step
 		if (err)
 		{
 			print_reinitialization_error();
@@ -926,6 +1380,68 @@ bool sca_linear_solver::do_pwl_iteration(int& check_mode,double& timestep)
 
 //////////////////////////////////////////////////////////////////////////////
 
+//the solution inside the segments is almost linear, thus the crossing of
+//the segment border is found by linear inverse interpolation between the
+//values at the begin (current x) and the end of the rejected step
+double sca_linear_solver::predict_pwl_breakpoint(double timestep)
+{
+	if(pwl_trial_x.size()!=pwl_coefficients.size()) return -1.0;
+
+	double frac=1.0;
+	bool found=false;
+
+	for(unsigned long i=0;i<pwl_coefficients.size();++i)
+	{
+		pwl_data& data(pwl_coefficients[i]);
+
+		double x_start=x_flat[data.arg_idx];
+		double x_end=pwl_trial_x[i];
+		double x_border;
+
+		if((x_end<data.x_values[data.current_segment]) && (data.current_segment>0))
+		{
+			x_border=data.x_values[data.current_segment];
+		}
+		else if((data.current_segment+1<data.n_segments) &&
+				(x_end>data.x_values[data.current_segment+1]))
+		{
+			x_border=data.x_values[data.current_segment+1];
+		}
+		else
+		{
+			continue;
+		}
+
+		//no prediction for a zero slope or a slope, which points away
+		//from the border (the start value is not inside the segment)
+		double slope=x_end-x_start;
+		double dist=x_border-x_start;
+		if((slope==0.0) || !std::isfinite(slope)) continue;
+		if((slope>0.0) ? (dist<=0.0) : (dist>=0.0)) continue;
+
+		double f=dist/slope;
+		if((f>0.0) && (f<=frac))
+		{
+			frac=f;
+			found=true;
+		}
+	}
+
+	if(!found) return -1.0;
+
+	//the border was only slightly exceeded - stay a little before
+	if(frac>1.0-1e-6) frac=1.0-1e-6;
+
+	double predicted_timestep=frac*timestep;
+
+	//the bisection is used for predictions outside (0,timestep]
+	if(!(predicted_timestep>0.0) || (predicted_timestep>timestep)) return -1.0;
+
+	return predicted_timestep;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void sca_linear_solver::interpolate_B_q(double dtime)
 {
 	//interpolate only if time different
@@ -1011,14 +1527,7 @@ void sca_linear_solver::iterate_pwl_intervalls()
 
 		pwl_dt=remaining_dt;
 
-		int err = ana_reinit_sparse
-				(
-						A->get_sparse_matrix(),
-						B->get_sparse_matrix(),
-						pwl_dt,
-						&internal_solver_data,
-						2  //initialize for trapet -> no euler step
-				 );
+		int err = reinit_pwl(pwl_dt); //trapez -> no euler step
 		if (err)
 		{
 			print_reinitialization_error();
@@ -1048,6 +1557,7 @@ void sca_linear_solver::iterate_pwl_intervalls()
 		pwl_dt=pwl_dt_last=remaining_dt;
 
 		//iterate until valid timepoint found
+		pwl_breakpoint_predictions=0;
 		while(do_pwl_iteration(check_mode,pwl_dt));
 
 
@@ -1080,6 +1590,207 @@ void sca_linear_solver::iterate_pwl_intervalls()
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+
+//the global timestep is solved by error controlled sub-steps (see
+//ana_solv_substeps) - q is interpolated linearly between the global timepoints
+void sca_linear_solver::solve_substeps()
+{
+	std::size_t n=q->length();
+
+	//q at the begin of the first global step is unknown
+	if(substep_q_last.size()!=n)
+	{
+		substep_q_last.assign(q_current,q_current+n);
+	}
+
+	if(substep_data==NULL)
+	{
+		if(ana_alloc_substep_data(&substep_data))
+		{
+			std::ostringstream str;
+			str << "Not enough memory for the sub-stepping of: " << get_name();
+			SC_REPORT_ERROR("SystemC-AMS",str.str().c_str());
+			return;
+		}
+	}
+
+	ana_set_substep_tolerances(substep_data,substep_reltol,substep_abstol);
+
+	//enables the factorization cache for the sub-step sizes
+	set_factorization_key();
+
+	int err=ana_solv_substeps(
+			A->get_sparse_matrix(),
+			B->get_sparse_matrix(),
+			substep_q_last.data(),
+			q_current,
+			x_flat,
+			dt,
+			&internal_solver_data,
+			substep_data);
+
+	//the global step is aborted - the state of its begin is restored
+	if(err)
+	{
+		print_reinitialization_error();
+		return;
+	}
+
+	double proposed_dt=ana_get_substep_proposed_timestep(substep_data);
+	if(proposed_dt>0.0) acceptable_dt=proposed_dt;
+
+	substep_q_last.assign(q_current,q_current+n);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+//solves B*x+q=0 (capacitors open, inductors shorted) - the segments of the
+//pwl elements are changed until they are valid for the operating point,
+//if B is singular, the states not determined by B are kept by Euler steps
+//with a large pseudo timestep
+bool sca_linear_solver::solve_dc_operating_point()
+{
+	std::size_t n=x.length();
+
+	//the state vector is changed outside of ana_solv
+	ana_resolve_solver_check_point(internal_solver_data);
+
+	std::vector<double> x_start(x_flat,x_flat+n);
+	std::vector<double> x_prev(n);
+
+	//each iteration changes a segment by one
+	unsigned long max_pwl_iterations=1;
+	std::vector<unsigned long> segments_start(pwl_coefficients.size());
+	for(unsigned long i=0;i<pwl_coefficients.size();++i)
+	{
+		max_pwl_iterations+=pwl_coefficients[i].n_segments;
+		segments_start[i]=pwl_coefficients[i].current_segment;
+	}
+
+	bool pwl_changed=false;
+	bool settled=true;
+	int  err=0;
+
+	statistics_dc_found=false;
+
+	for(unsigned long it=0;it<max_pwl_iterations;++it)
+	{
+		settled=true;
+
+		err=ana_solve_dc(A->get_sparse_matrix(),B->get_sparse_matrix(),
+				0.0,q_current,x_flat,internal_solver_data);
+
+		if(err==4)
+		{
+			double h=DC_PSEUDO_TIMESTEP_FACTOR*dt;
+
+			settled=false;
+			for(unsigned long step=0;(step<DC_MAX_PSEUDO_STEPS) && !settled;++step)
+			{
+				x_prev.assign(x_flat,x_flat+n);
+
+				err=ana_solve_dc(A->get_sparse_matrix(),B->get_sparse_matrix(),
+						h,q_current,x_flat,internal_solver_data);
+				if(err) break;
+
+				statistics_dc_pseudo_steps++;
+
+				settled=true;
+				for(std::size_t i=0;i<n;i++)
+				{
+					double tol=DC_ABSTOL+DC_RELTOL*std::fabs(x_flat[i]);
+					if(std::fabs(x_flat[i]-x_prev[i])>tol)
+					{
+						settled=false;
+						break;
+					}
+				}
+			}
+		}
+
+		if(err) break;
+
+		if(!pwl_coeff_available || (check_pwl_intervals(2)==0))
+		{
+			statistics_dc_found=true;
+			break;
+		}
+
+		change_pwl_coefficients();
+		pwl_changed=true;
+		statistics_dc_pwl_iterations++;
+	}
+
+	//without operating point the simulation starts with the initial state
+	//and the segments of the begin
+	if(!statistics_dc_found && pwl_changed)
+	{
+		for(unsigned long i=0;i<pwl_coefficients.size();++i)
+		{
+			pwl_coefficients[i].new_segment=segments_start[i];
+		}
+		change_pwl_coefficients();
+	}
+
+	//the solver data were used by the DC calculation with other segments -
+	//reinitialization for the current (on failure the restored) segments
+	if(pwl_changed)
+	{
+		set_pwl_factorization_key();
+
+		int rerr = ana_reinit_sparse(A->get_sparse_matrix(), B->get_sparse_matrix(),
+				dt, &internal_solver_data, 1);
+		if (rerr)
+		{
+			print_reinitialization_error();
+		}
+	}
+
+	if(!statistics_dc_found)
+	{
+		std::memcpy(x_flat,x_start.data(),sizeof(double)*n);
+
+		std::ostringstream str;
+		str << "The DC operating point of the solver instance: " << get_name();
+		str << " (modules e.g.: " << get_name_associated_names(5) << ")";
+		if(err)
+		{
+			long row=-1, column=-1;
+			ana_get_error_position(internal_solver_data,&row,&column);
+
+			str << " can't be calculated (error: " << err << ")";
+			sc_core::sc_object* obj=get_object_of_equation(row);
+			if(obj!=NULL)
+			{
+				str << " the error is in the equation of: " << obj->name();
+			}
+		}
+		else
+		{
+			str << " can't be calculated, no consistent set of pwl segments";
+			str << " found after " << statistics_dc_pwl_iterations << " iterations";
+		}
+		str << " - the simulation starts with the initial state";
+		SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+
+		return false;
+	}
+
+	if(!settled)
+	{
+		std::ostringstream str;
+		str << "The state of the solver instance: " << get_name();
+		str << " (modules e.g.: " << get_name_associated_names(5) << ")";
+		str << " did not settle within " << DC_MAX_PSEUDO_STEPS;
+		str << " pseudo timesteps of the DC operating point calculation";
+		str << " - the last state is used";
+		SC_REPORT_WARNING("SystemC-AMS",str.str().c_str());
+	}
+
+	return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 void sca_linear_solver::solve_eq_system()
@@ -1125,6 +1836,7 @@ void sca_linear_solver::solve_eq_system()
 		if(!cp_restored)
 		{
 			B_change->reset();
+			b_change_processed=0;
 		}
 	}
 
@@ -1148,11 +1860,15 @@ void sca_linear_solver::solve_eq_system()
 
 
 	int init_flag = 0;
+	bool woodbury_requested = false;
 
 	if (ac_equation_initialized) //restore time domain equations
 	{
 		equation_if->reinit_equations();
 		init_pwl_data(false);
+		b_change_state.clear();
+		b_change_processed=0;
+		b_change_state_overflow=false;
 		ac_equation_initialized = false;
 	}
 
@@ -1177,6 +1893,9 @@ void sca_linear_solver::solve_eq_system()
 	{
 		equation_if->reinit_equations();
         init_pwl_data(false);
+		b_change_state.clear();
+		b_change_processed=0;
+		b_change_state_overflow=false;
 
 		ac_equation_initialized = false;
 	}
@@ -1195,6 +1914,7 @@ void sca_linear_solver::solve_eq_system()
 		if (init_flag == 3 || init_flag == 4)
 		{
 			init_flag -= 2;
+			woodbury_requested = true;
 		}
 
 		equation_if->get_reinit_request() = 0;  //reset request
@@ -1208,6 +1928,9 @@ void sca_linear_solver::solve_eq_system()
 
 	if (init_flag)
 	{
+		set_factorization_key();
+		set_woodbury_max_rank(woodbury_requested);
+
 		int err = ana_reinit_sparse(A->get_sparse_matrix(), B->get_sparse_matrix(), new_dt, &internal_solver_data,
 				   init_flag);
 
@@ -1219,16 +1942,43 @@ void sca_linear_solver::solve_eq_system()
 	}
 
 
+	//store vector for pwl-iteration
+	q_current=q->get_calc_flat();
+
+
+	//the first timestep starts at the DC operating point instead of
+	//an Euler step from the initial state
+	bool dc_solved=false;
+	if(first_timestep && dc_operating_point)
+	{
+		dc_solved=solve_dc_operating_point();
+	}
+
+	//the pwl iteration restarts at the DC operating point - the check point
+	//contains the method of the first step (Euler and the remaining Euler
+	//steps, after a segment change re-initialized by the DC calculation)
 	if(pwl_coeff_available)
 	{
 		ana_store_solver_check_point(internal_solver_data,x_flat,&pwl_iteration_cp);
 	}
 
-	//store vector for pwl-iteration
-	q_current=q->get_calc_flat();
-
-
-	ana_solv(q_current, x_flat, internal_solver_data);
+	if(dc_solved)
+	{
+		//x is the operating point, the derivative xp remains zero
+		if(substep_reltol>0.0)
+		{
+			substep_q_last.assign(q_current,q_current+q->length());
+		}
+	}
+	//the pwl iteration controls the step size by itself
+	else if((substep_reltol>0.0) && !pwl_coeff_available)
+	{
+		solve_substeps();
+	}
+	else
+	{
+		ana_solv(q_current, x_flat, internal_solver_data);
+	}
 
 	if(pwl_coeff_available)
 	{
@@ -1495,6 +2245,61 @@ void sca_linear_solver::print_post_solve_statisitcs()
 		str << std::endl;
 		str << "\t\thas calculated " << number_of_timesteps << " time steps the equation system was ";
 		str << (number_of_reinit) << " times re-initialized"<< std::endl;
+		if(internal_solver_data!=NULL)
+		{
+			long codegen_cnt, refactor_cnt;
+			ana_get_factorization_statistics(internal_solver_data,
+					&codegen_cnt, &refactor_cnt);
+			str << "\t\tthe factorization code was " << codegen_cnt;
+			str << " times generated and " << refactor_cnt;
+			str << " times numerically reused" << std::endl;
+
+			int alg = force_implicit_euler_method ? 1 : 2;
+			long fill_ins, fill_ins_after_dec;
+			ana_get_fill_ins(internal_solver_data, alg,
+					&fill_ins, &fill_ins_after_dec);
+			str << "\t\tordering ";
+			if(ordering==1)      str << "approximate minimum degree";
+			else if(ordering==2) str << "nested dissection";
+			else if(ordering==3) str << "block triangular";
+			else                 str << "Markowitz";
+			str << ": " << fill_ins << " non-zeros before and ";
+			str << fill_ins_after_dec << " after factorization, ";
+			str << ana_get_dec_flop(internal_solver_data, alg);
+			str << " flops for factorization and ";
+			str << ana_get_sol_flop(internal_solver_data, alg);
+			str << " flops for solution" << std::endl;
+
+			if(ordering==3)
+			{
+				long nblocks, nsingle;
+				ana_get_diagonal_blocks(internal_solver_data, alg,
+						&nblocks, &nsingle);
+				str << "\t\tblock triangular form: " << nblocks;
+				str << " diagonal blocks, " << nsingle;
+				str << " of them of size 1" << std::endl;
+			}
+
+			if(factorization_cache_size>0)
+			{
+				long cache_hits, cache_misses;
+				ana_get_factorization_cache_statistics(internal_solver_data,
+						&cache_hits, &cache_misses);
+				str << "\t\tfactorization cache (size " << factorization_cache_size;
+				str << "): " << cache_hits << " hits, " << cache_misses;
+				str << " misses" << std::endl;
+			}
+
+			long woodbury_cnt, consolidate_cnt;
+			ana_get_woodbury_statistics(internal_solver_data,
+					&woodbury_cnt, &consolidate_cnt);
+			if(woodbury_cnt>0)
+			{
+				str << "\t\t" << woodbury_cnt << " re-initializations were carried";
+				str << " out by low-rank (Woodbury) updates, " << consolidate_cnt;
+				str << " updates were merged into the factorization" << std::endl;
+			}
+		}
 		if(top_vec.size()>0)
 		{
 			str << "\t\tthe following max. " << N_TOP_MOD;
@@ -1507,6 +2312,34 @@ void sca_linear_solver::print_post_solve_statisitcs()
 			   str << std::endl;
 			}
 		}
+		if(substep_data!=NULL)
+		{
+			long substeps, rejections;
+			double min_substep;
+			ana_get_substep_statistics(substep_data,&substeps,&rejections,&min_substep);
+
+			str << "\t\t" << substeps << " sub-steps were calculated, ";
+			str << rejections << " were rejected";
+			if(substeps>0)
+			{
+				str << ", minimum sub-step: ";
+				str << min_substep << " sec";
+			}
+			str << std::endl;
+		}
+		if(dc_operating_point)
+		{
+			if(statistics_dc_found)
+			{
+				str << "\t\tDC operating point found";
+			}
+			else
+			{
+				str << "\t\tDC operating point not found";
+			}
+			str << " (" << statistics_dc_pwl_iterations << " pwl iterations, ";
+			str << statistics_dc_pseudo_steps << " pseudo timesteps)" << std::endl;
+		}
 		if(pwl_coeff_available)
 		{
 			str << "\t\tNumber of pwl iterations: ";
@@ -1531,6 +2364,13 @@ void sca_linear_solver::print_post_solve_statisitcs()
 				str << statistics_pwl_min_timestep << " sec";
 				str << std::endl;
 			}
+			if(factorization_cache_size>0)
+			{
+				str << "\t\tFactorizations of pwl intervals found in cache: ";
+				str << statistics_pwl_cache_hits << " hits, ";
+				str << statistics_pwl_cache_misses << " misses";
+				str << std::endl;
+			}
 		}
 
 #ifndef DISABLE_PERFORMANCE_STATISTICS
@@ -1559,6 +2399,10 @@ void sca_linear_solver::store_checkpoint()
 {
 	ana_store_solver_check_point(internal_solver_data,x_flat,&global_cp);
 	checkp_dt=dt_global;
+
+	substep_q_last_cp=substep_q_last;
+	substep_dt_cp=(substep_data!=NULL) ? ana_get_substep_timestep(substep_data) : 0.0;
+	acceptable_dt_cp=acceptable_dt;
 }
 
 //////////////////////////////////////////
@@ -1568,6 +2412,10 @@ void sca_linear_solver::restore_checkpoint()
 	ana_restore_solver_check_point(internal_solver_data,x_flat,&global_cp);
 	cp_restored=true;
 
+	substep_q_last=substep_q_last_cp;
+	if(substep_data!=NULL) ana_set_substep_timestep(substep_data,substep_dt_cp);
+	acceptable_dt=acceptable_dt_cp;
+
 
 	if(pwl_coeff_available)
 	{
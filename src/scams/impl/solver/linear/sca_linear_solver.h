@@ -46,6 +46,7 @@
 #include "scams/impl/util/data_types/sca_method_list.h"
 #include "scams/impl/util/data_types/sca_function_vector.h"
 #include "scams/impl/solver/util/sparse_library/linear_analog_solver.h"
+#include <map>
 
 
 #ifndef DISABLE_PERFORMANCE_STATISTICS
@@ -111,12 +112,25 @@ private:
     		  const std::string& par,
     		  const std::string& val);
 
+    /** provides the acceptable_timestep estimated by sub-stepping */
+    bool get_solver_parameter(
+    		  const std::string& par,
+    		  std::string& val) const;
+
     //variables to permit check of inconsistent double setting
     bool                  force_implicit_euler_method;
+    bool                  bdf2_method;
     int                   reinitialization_steps;
     bool                  algorithm_set;
     std::string           algorithm_value;
     sca_core::sca_module* algorithm_module;
+    long                  factorization_cache_size;
+    long                  woodbury_max_rank;
+    int                   ordering;
+    double                substep_reltol;  //0: sub-stepping disabled
+    double                substep_abstol;
+    bool                  pwl_breakpoint_interpolation;
+    bool                  dc_operating_point; //first timestep solves B*x+q=0
 
 
     std::string get_name_associated_names(int max_num=-1) const;
@@ -127,6 +141,17 @@ private:
     void iterate_pwl_intervalls();
     bool do_pwl_iteration(int& check_mode,double& timestep);
 
+    //predicts the timestep to the first crossed segment border,
+    //returns a value <=0.0 if not possible
+    double predict_pwl_breakpoint(double timestep);
+
+    //solves the global timestep by error controlled sub-steps
+    void solve_substeps();
+
+    //solves the DC operating point including the pwl segments, returns
+    //false if not found - the state vector remains unchanged
+    bool solve_dc_operating_point();
+
 
     void error_message(int error, int method, double n_dt); //error message for errors during (re)initialization and Woodbury formula
     void call_methods(sca_util::sca_implementation::sca_method_vector* methods); //call methods
@@ -167,6 +192,12 @@ private:
     unsigned long statistics_cur_pwl_segment_iterations;
     unsigned long statistics_cur_pwl_timestep_iterations;
     double        statistics_pwl_min_timestep;
+    long          statistics_pwl_cache_hits;
+    long          statistics_pwl_cache_misses;
+
+    bool          statistics_dc_found;
+    unsigned long statistics_dc_pwl_iterations;
+    unsigned long statistics_dc_pseudo_steps;
 
     //for check point restore with pwl to ensure that reinit mode is the same
     unsigned long last_reinit_flag;
@@ -223,6 +254,19 @@ private:
     //reached time for current step
     double reached_dt;
 
+    //pwl argument values of the last rejected step for breakpoint prediction
+    std::vector<double> pwl_trial_x;
+    //number of predictions for the current breakpoint
+    unsigned long pwl_breakpoint_predictions;
+
+    //sub-stepping data
+    std::vector<double> substep_q_last; //q at the begin of the global step
+    double acceptable_dt;         //largest acceptable step, <0: unknown
+
+    std::vector<double> substep_q_last_cp;
+    double substep_dt_cp;
+    double acceptable_dt_cp;
+
 
 
     void init_pwl_data(bool ac);
@@ -242,10 +286,39 @@ private:
     //prints error message for solv_eq_system
     void print_reinitialization_error();
 
+    //B coefficients, which differ from the initialization:
+    //(line, column) -> (value of the initialization, current value)
+    std::map<std::pair<unsigned long,unsigned long>,
+    	std::pair<double,double> > b_change_state;
+
+    //number of entries of B_change already stored in b_change_state
+    unsigned long b_change_processed;
+
+    //more than B_CHANGE_STATE_MAX_SIZE coefficients changed
+    bool b_change_state_overflow;
+
+    //sets key of current switch state for factorization cache
+    void set_factorization_key();
+
+    //key of the switch state without pwl segments
+    sc_dt::uint64 factorization_key;
+    bool          factorization_key_valid;
+
+    //sets key of switch state and current pwl segments
+    void set_pwl_factorization_key();
+
+    //reinitializes with the key of the current pwl segments
+    int reinit_pwl(double timestep);
+
+    //enables low-rank updates for reinitializations requested as Woodbury
+    void set_woodbury_max_rank(bool woodbury_requested);
+
     sca_solv_checkpoint_data* global_cp;
 
     sca_solv_checkpoint_data* pwl_iteration_cp;
 
+    sca_substep_data* substep_data;
+
 #ifndef DISABLE_PERFORMANCE_STATISTICS
 	std::uint64_t activation_cnt=0;
 	std::chrono::time_point<std::chrono::high_resolution_clock> start;
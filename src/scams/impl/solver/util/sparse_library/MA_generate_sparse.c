@@ -170,6 +170,8 @@ exportMA_Sparse err_code MA_ConvertFullToSparse(value* A, count_near n,
 
 	nmax=(size_t)(sA->nmax);
 
+	MA_FreeSlotMap(sA);
+
 	sA->a = (value *) calloc(nmax, (size_t) sizeof(value));
 	sA->ja = (count_near *)calloc(nmax,(size_t) sizeof(count_near));
 	sA->fa = (count_far *) calloc(nmax,(size_t) sizeof(count_far));
@@ -255,6 +257,8 @@ exportMA_Sparse err_code   MA_GenerateProductValueSparse(struct sparse* sA,
 	sA->nmax = anz + (count_far) anz/10 + 20; /* prophylactical */
     nmax=(size_t)(sA->nmax);
 
+	MA_FreeSlotMap(sA);
+
 	sA->a = (value *) calloc(nmax, (size_t) sizeof(value));
 	sA->ja = (count_near *) calloc(nmax,(size_t) sizeof(count_near));
 	sA->fa = (count_far *) calloc(nmax,(size_t) sizeof(count_far));
@@ -363,6 +367,8 @@ exportMA_Sparse err_code   MA_GenerateSumMatrixWeighted(struct sparse* sA,
 	sA->nel = anz;
 	sA->nmax = anz + (count_far) anz * 0.1 + 20; /* prophylactical */
 
+	MA_FreeSlotMap(sA);
+
 	sA->a = (value *) calloc((unsigned) sA->nmax, (unsigned) sizeof(value));
 	sA->ja = (count_near *) calloc((unsigned) sA->nmax,
 			(unsigned) sizeof(count_near));
@@ -485,6 +491,8 @@ exportMA_Sparse err_code MA_CopySparse(struct sparse* sA, struct sparse* sB)
 	sA->nmax = sB->nmax;
 	sA->sparse_list_ordered = sB->sparse_list_ordered;
 
+	MA_FreeSlotMap(sA); /* the slot map of sB is not copied */
+
 	if(sA->ja!=NULL)
 		free(sA->ja);
 	sA->ja=(count_near*)malloc((sB->nmax)*sizeof(count_near));
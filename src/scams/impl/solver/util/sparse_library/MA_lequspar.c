@@ -216,243 +216,1352 @@ static err_code tocodesol(struct spcode* code,count_far z1,count_far z2,count_fa
 /* ////////////////////////////////////////////////////////////////////////// */
 
 /**
- * @return
+ *  The internal function <i>storepattern</i> stores the structure of the
+ *  ordered matrix before decomposition. It is used by
+ *  <i>MA_LequSparseRefactor</i> to check whether the code can be reused.
+ *
+ *  @return
  *  <ul><li>    0 - okay
- *  <li>        1 - reallocation of NULL pointer
  *  <li>        2 - not enough memory
- *  <li>		3 - dimension erroneous
- *  <li>		4 - matrix singular
- *  <li>		6 - no sparse matrix
  *  </ul>
  */
-exportMA_Sparse err_code MA_LequSparseCodegen(struct sparse* sA,
-		struct spcode* code)
-#ifdef NOT_USED
-    /* channel for debug output*/
-	FILE *debf;
-#endif
-/*-----------------------------------------------------------------*/
-/*SparseDebug :
- 0 - nothing
- 1 - step, line etc. if singular
- 2 - matrix after dec., code
- 3 - tolerance criteria
- 4 - step, pivot candidates
- 5 - full information
- */
+
+static err_code storepattern(struct spcode* code,struct sparse* sA)
 {
-	count_near ret; /* return variable */
-	count_far i, i1, j1 = 0, i2, i3, k = 0, kk, j, i6, lvgl = 0,
-			mi = 0, i7, m1, line, i4, jlast, coljlast,
-			coli, /* column in pivot line */
-			colj, /* column in nonpivot line */
-			ipc, /* number of element in pivot column, sparse list */
-			n = 0, /* dimension */
-			nn, /* dimension - 1 */
-			nel, /* number elements */
-			niz, /* dimension of the matrix to be decomposed */
-			pnew, /* pointer to the last element in the sparse list */
-			l1, /* index of first el. in pivot line */
-			mark, /* Markowitz sum */
-			lz, /* pivot line   */
-			l, /* pivot number in sparse list */
-			ls; /* pivot column */
+	count_far i;
 
-	count_far *ip, /* line permutation vector */
-	*jp, /* column permutation vactor */
-	*jz, /* Markowitz sums of pivot proposals in the line */
-	*ik, /* indexes in a list of pivot proposals in the line */
-	*is; /* numbers of elements in undecomposed matrix part */
+	if (code->pattern_ia != NULL)
+	{
+		free(code->pattern_ia);
+		code->pattern_ia = NULL;
+	}
 
-	value su, w, rk, schwell, p, pmin, al; /* pivot value */
+	if (code->pattern_ja != NULL)
+	{
+		free(code->pattern_ja);
+		code->pattern_ja = NULL;
+	}
 
-	count_far pivot_flop, ndec;
-	pivot_flop = ndec = 0;
+	code->pattern_ia = (count_far *) calloc((unsigned) (sA->m + 1),
+			(unsigned) sizeof(count_far));
+	code->pattern_ja = (count_near *) calloc((unsigned) (sA->nel),
+			(unsigned) sizeof(count_near));
 
-	code->pivot_flop = code->dec_flop = code->sol_flop = code->dec_ma = 0;
+	if (code->pattern_ia == NULL || code->pattern_ja == NULL)
+		return 2;
 
-	/* get correct order of entries in sparse list */
-	MA_SortSparseList(sA);
+	for (i = 0; i <= sA->m; i++)
+		code->pattern_ia[i] = sA->ia[i];
 
-#ifdef NOT_USED
-	/*Should never happen*/
-	if (MA_GetSparseFullDescription(sA))
-	{	fprintf(debf,"System matrix used as a full description  \n");
-		return 6;
-	}
-#endif
+	for (i = 0; i < sA->nel; i++)
+		code->pattern_ja[i] = sA->ja[i];
 
-	sA->decomp = 1; /* note: matrix decomposed */
+	return 0;
+}
 
-	ret = 0;
-	if (sA->nd < 1 || sA->nel < 1)
-	{
-		return 3;
-	}
+/* ////////////////////////////////////////////////////////////////////////// */
 
-	ip = (count_far *) calloc((unsigned) (sA->nd + 1),
-			(unsigned) sizeof(count_far));
-	jp = (count_far *) calloc((unsigned) (sA->nd + 1),
-			(unsigned) sizeof(count_far));
-	jz = (count_far *) calloc((unsigned) (sA->nd + 1),
-			(unsigned) sizeof(count_far));
-	ik = (count_far *) calloc((unsigned) (sA->nd + 1),
-			(unsigned) sizeof(count_far));
-	is = (count_far *) calloc((unsigned) (sA->nd + 1),
+/**
+ *  The internal function <i>ordergraph</i> generates the adjacency structure
+ *  of the symmetric pattern \f$A + A^T\f$ without diagonal (nd+1 starts in
+ *  <i>*gptr</i>, neighbours in <i>*gadj</i>).
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  </ul>
+ */
+
+static err_code ordergraph(struct sparse* sA, count_far** gptr,
+		count_far** gadj)
+{
+	count_far i, j, k, n, nadj;
+	count_far *ptr, *adj, *cnt, *mark;
+
+	n = sA->nd;
+
+	ptr = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	cnt = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	mark = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	adj = (count_far *) calloc((unsigned) (2 * sA->nel + 1),
 			(unsigned) sizeof(count_far));
 
-	if (ip == NULL || jp == NULL || jz == NULL || ik == NULL || is == NULL)
+	if (ptr == NULL || cnt == NULL || mark == NULL || adj == NULL)
 	{
-		ret = 2;
-		goto retour;
+		if (ptr != NULL) free(ptr);
+		if (cnt != NULL) free(cnt);
+		if (mark != NULL) free(mark);
+		if (adj != NULL) free(adj);
+		return 2;
 	}
 
-#ifdef NOT_USED
-	brauchen wir nicht
-	if (code->SparseDebug > 0)
-	{	if (code->SparseDebug == 5)
-		{	fprintf(debf,"start lequsparse_codegen  \n");
-			MA_PrintSparse(sA, debf);
+	/* upper bound of neighbours: entries of line and column */
+	for (i = 0; i < n; i++)
+	{
+		for (k = sA->ia[i]; k < sA->ia[i + 1]; k++)
+		{
+			j = sA->ja[k];
+			if (j != i)
+			{
+				cnt[i]++;
+				cnt[j]++;
+			}
 		}
 	}
-#endif
 
-	/* Initialization */
-	/* ============== */
-	n = sA->nd;
-	nn = n - 1;
-	nel = sA->nel;
+	ptr[0] = 0;
+	for (i = 0; i < n; i++)
+		ptr[i + 1] = ptr[i] + cnt[i];
 
-	/* Code initialization */
-	code->ndecmax = code->nsolmax = 3 * 2 * nel;
-	if (code->dec != NULL)
+	for (i = 0; i < n; i++)
 	{
-		free(code->dec);
-		code->dec = NULL;
+		cnt[i] = ptr[i];
+		mark[i] = -1;
 	}
 
-	if (code->sol != NULL)
+	for (i = 0; i < n; i++)
 	{
-		free(code->sol);
-		code->sol = NULL;
+		for (k = sA->ia[i]; k < sA->ia[i + 1]; k++)
+		{
+			j = sA->ja[k];
+			if (j != i)
+			{
+				adj[cnt[i]++] = j;
+				adj[cnt[j]++] = i;
+			}
+		}
 	}
 
-	if (code->isort != NULL)
+	/* remove duplicates */
+	nadj = 0;
+	for (i = 0; i < n; i++)
 	{
-		free(code->isort);
-		code->isort = NULL;
+		k = ptr[i];
+		ptr[i] = nadj;
+		for (; k < cnt[i]; k++)
+		{
+			j = adj[k];
+			if (mark[j] != i)
+			{
+				mark[j] = i;
+				adj[nadj++] = j;
+			}
+		}
 	}
+	ptr[n] = nadj;
 
-	code->dec = (count_far *) calloc((unsigned) (code->ndecmax),
-			(unsigned) sizeof(count_far));
-	code->sol = (count_far *) calloc((unsigned) (code->nsolmax),
-			(unsigned) sizeof(count_far));
-	code->isort = (count_far *) calloc((unsigned) (sA->nd + 1),
-			(unsigned) sizeof(count_far));
-	if (code->sol == NULL || code->dec == NULL || code->isort == NULL)
-	{
+	free(cnt);
+	free(mark);
 
-		if(code->sol!=NULL) free(code->sol);
-		code->sol=NULL;
+	*gptr = ptr;
+	*gadj = adj;
 
-		if(code->dec!=NULL) free(code->dec);
-		code->dec=NULL;
+	return 0;
+}
 
-		if(code->isort!=NULL) free(code->isort);
-		code->isort=NULL;
+/* ////////////////////////////////////////////////////////////////////////// */
 
-		ret = 2;
-		goto retour;
+/**
+ *  The internal function <i>mdappend</i> appends <i>j</i> to the list
+ *  <i>*lst</i> with <i>*len</i> elements, the capacity <i>*cap</i> is
+ *  enlarged if necessary.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  </ul>
+ */
+
+static err_code mdappend(count_far** lst, count_far* len, count_far* cap,
+		count_far j)
+{
+	count_far* tmp;
+
+	if (*len >= *cap)
+	{
+		*cap = 2 * (*cap) + 4;
+		tmp = (count_far *) realloc(*lst, (unsigned) (*cap) * sizeof(count_far));
+		if (tmp == NULL)
+			return 2;
+		*lst = tmp;
 	}
-	code->ndec = code->nsol = 0;
-	code->critical_column = code->critical_line = -1; /* default regular */
+	(*lst)[(*len)++] = j;
 
-	/*niz = n;  never used ????? */ /* dimension of remaining matrix, still to be decomposed */
-	pnew = nel - 1;/* pointer to the last element in the sparse list */
+	return 0;
+}
 
-	schwell = 1.0 / code->gener_piv_scope;
+/* ////////////////////////////////////////////////////////////////////////// */
 
-	code->fill_ins = nel; /* original number of fill ins before decomposition */
+/**
+ *  The internal function <i>orderminimumdegree</i> orders the nodes of the
+ *  graph by approximate minimum degree. The elimination works on the
+ *  quotient graph: an eliminated node becomes an element holding the list
+ *  of its variables instead of forming a clique, elements adjacent to the
+ *  pivot are absorbed by the new element. The degree of a variable is the
+ *  upper bound of the AMD algorithm \f$ |A_i| + |L_p \setminus i| +
+ *  \sum_{e \ne p} |L_e \setminus L_p| \f$, elements with
+ *  \f$ L_e \subseteq L_p \f$ are absorbed as well. The variables are kept
+ *  in lists of equal degree, thus the pivot is found without a search over
+ *  all nodes. Supervariables are not detected.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  </ul>
+ */
 
-	/* ip, jp, is  - initialization */
-	for (i = 0; i < n; i++)
+static err_code orderminimumdegree(count_far n, count_far* ptr,
+		count_far* adj, count_far* order)
+{
+	count_far i, k, l, e, v, p, d, dext, nv, ne, step, mindeg, stamp = 0;
+	count_far **av, **ae, *nav, *nae, *cav, *cae;
+	count_far *st, *deg, *head, *next, *prev, *mark, *w;
+	count_far *lp, nlp, clp;
+	err_code ret = 0;
+
+	/* av: variables adjacent to a variable or variables of an element,
+	 * ae: elements adjacent to a variable,
+	 * st: 0 variable, 1 element, 2 absorbed element */
+	av = (count_far **) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far*));
+	ae = (count_far **) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far*));
+	nav = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	nae = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	cav = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	cae = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	st = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	deg = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	head = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	next = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	prev = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	mark = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+	w = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+
+	if (av == NULL || ae == NULL || nav == NULL || nae == NULL || cav == NULL
+			|| cae == NULL || st == NULL || deg == NULL || head == NULL
+			|| next == NULL || prev == NULL || mark == NULL || w == NULL)
 	{
-		ip[i] = jp[i] = i;
-		is[i] = 0;
+		ret = 2;
+		goto retour;
 	}
-	for (i = 0; i < nel; i++)
-		is[sA->ja[i]]++;
 
-#ifdef NOT_USED
-	if (code->SparseDebug > 0)
-	{	if (code->SparseDebug == 5)
-		{	fprintf(debf,"\n before first step \n");
-			MA_PrintSparse(sA, debf);
-			for (i = 0; i < n; i++)
-			fprintf(debf,"%6d   ip %6d   jp %6d   is %6d   jz %6d   ik %6d \n",
-				(int)i,(int)ip[i],(int)jp[i],(int)is[i],(int)jz[i],(int)ik[i]);
+	for (i = 0; i <= n; i++)
+		head[i] = -1;
+
+	for (i = 0; i < n; i++)
+	{
+		nav[i] = cav[i] = ptr[i + 1] - ptr[i];
+		if (cav[i] > 0)
+		{
+			av[i] = (count_far *) malloc((unsigned) cav[i] * sizeof(count_far));
+			if (av[i] == NULL)
+			{
+				ret = 2;
+				goto retour;
+			}
+			for (k = 0; k < nav[i]; k++)
+				av[i][k] = adj[ptr[i] + k];
 		}
+
+		order[i] = -1;
+		mark[i] = 0;
+		w[i] = -1;
+
+		/* degree lists */
+		deg[i] = nav[i];
+		prev[i] = -1;
+		next[i] = head[deg[i]];
+		if (next[i] >= 0)
+			prev[next[i]] = i;
+		head[deg[i]] = i;
 	}
-#endif
 
-	for (niz = n; niz > 1; niz--)
+	mindeg = 0;
+	for (step = 0; step < n; step++)
 	{
-
-#ifdef NOT_USED
-		if (code->SparseDebug > 0)
+		/* variable of minimum degree */
+		while (head[mindeg] < 0)
+			mindeg++;
+
+		p = head[mindeg];
+		head[mindeg] = next[p];
+		if (next[p] >= 0)
+			prev[next[p]] = -1;
+
+		order[p] = step;
+		st[p] = 1;
+
+		/* variables of the new element p: the adjacent variables and the
+		 * variables of the adjacent elements, which are absorbed */
+		stamp++;
+		mark[p] = stamp;
+		lp = NULL;
+		nlp = clp = 0;
+
+		for (k = 0; k < nav[p]; k++)
 		{
-			if (code->SparseDebug == 3 || code->SparseDebug == 4
-					|| code->SparseDebug == 5)
-			{	fprintf(debf,"\n\n\n pivot step, niz = %d  \n\n",(int)niz);
+			v = av[p][k];
+			if (st[v] == 0 && mark[v] != stamp)
+			{
+				mark[v] = stamp;
+				if (mdappend(&lp, &nlp, &clp, v) != 0)
+				{
+					if (lp != NULL) free(lp);
+					ret = 2;
+					goto retour;
+				}
 			}
 		}
-#endif
 
-		kk = n - niz; /* number of finished decomposition steps */
-		code->rank = kk;
-
-		/* Pivot candidates (stored in ik), Markowitz sums (stored in jz) */
-		/* ============================================================== */
-		for (j = kk; j < n; j++)
+		for (k = 0; k < nae[p]; k++)
 		{
-			i1 = ip[j]; /* line number, formerly i1 = iz[ ip[j]]; */
-			if (sA->ia[i1] == sA->ia[i1 + 1])
-			{ /* line is empty by structure */
-				ret = 4; /* singular */
+			e = ae[p][k];
+			if (st[e] != 1)
+				continue;
 
-#ifdef NOT_USED
-				if (code->SparseDebug > 0)
+			for (l = 0; l < nav[e]; l++)
+			{
+				v = av[e][l];
+				if (st[v] == 0 && mark[v] != stamp)
 				{
-					if (code->SparseDebug == 1 || code->SparseDebug == 5)
+					mark[v] = stamp;
+					if (mdappend(&lp, &nlp, &clp, v) != 0)
 					{
-						fprintf(debf,"structural singular in "
-								"decomposition step %d  \n",(int)kk);
-						fprintf(debf,"in line:  %6d  no pivot "
-								"candidate \n",(int)i1);
-						fprintf(debf,"already decomposed:  \n");
-						for (i = 0; i < kk; i++)
-						{
-							fprintf(debf,"line:  %6d  column:  "
-									"%6d\n",(int)ip[i],(int)jp[i]);
-						}
+						if (lp != NULL) free(lp);
+						ret = 2;
+						goto retour;
 					}
 				}
-#endif
+			}
 
-#ifdef NOT_USED
-				if (code->name_of_variable != NULL
-						&& code->name_of_equation != NULL)
-				fprintf(debf,"structural singular at variable: %s, equation: %s",
-						code->name_of_variable((count_near)jp[j]),
-						code->name_of_equation((count_near)ip[j]));
-#endif
+			st[e] = 2;
+			free(av[e]);
+			av[e] = NULL;
+			nav[e] = cav[e] = 0;
+		}
 
-				code->critical_line = ip[j];
-				code->critical_column = jp[j];
+		if (av[p] != NULL) free(av[p]);
+		if (ae[p] != NULL) free(ae[p]);
+		av[p] = lp;
+		nav[p] = nlp;
+		cav[p] = clp;
+		ae[p] = NULL;
+		nae[p] = cae[p] = 0;
 
-				/* if (j == n - 1) goto backward; goto retour; */
-				ik[i1] = -1; /* no pivot candidate in this line */
-				jz[i1] = 0; /* therefore, markowitz sum is zero */
+		/* |L_e \ L_p| of the elements adjacent to L_p */
+		for (k = 0; k < nlp; k++)
+		{
+			i = lp[k];
+
+			/* the degree of i is recomputed */
+			if (prev[i] >= 0)
+				next[prev[i]] = next[i];
+			else
+				head[deg[i]] = next[i];
+			if (next[i] >= 0)
+				prev[next[i]] = prev[i];
+
+			for (l = 0; l < nae[i]; l++)
+			{
+				e = ae[i][l];
+				if (st[e] != 1)
+					continue;
+				if (w[e] < 0)
+					w[e] = nav[e];
+				w[e]--;
+			}
+		}
+
+		for (k = 0; k < nlp; k++)
+		{
+			i = lp[k];
+
+			/* elements: drop the absorbed ones and the ones within L_p */
+			ne = 0;
+			dext = 0;
+			for (l = 0; l < nae[i]; l++)
+			{
+				e = ae[i][l];
+				if (st[e] != 1)
+					continue;
+				if (w[e] == 0)
+				{
+					st[e] = 2;
+					free(av[e]);
+					av[e] = NULL;
+					nav[e] = cav[e] = 0;
+					continue;
+				}
+				ae[i][ne++] = e;
+				dext += w[e];
+			}
+			nae[i] = ne;
+			if (mdappend(&ae[i], &nae[i], &cae[i], p) != 0)
+			{
+				ret = 2;
+				goto retour;
+			}
+
+			/* variables: drop the eliminated ones and the ones of L_p */
+			nv = 0;
+			for (l = 0; l < nav[i]; l++)
+			{
+				v = av[i][l];
+				if (st[v] == 0 && mark[v] != stamp)
+					av[i][nv++] = v;
+			}
+			nav[i] = nv;
+
+			d = nv + nlp - 1 + dext;
+			if (d > deg[i] + nlp - 1)
+				d = deg[i] + nlp - 1;
+			if (d > n - step - 2)
+				d = n - step - 2;
+			if (d < 0)
+				d = 0;
+
+			deg[i] = d;
+			prev[i] = -1;
+			next[i] = head[d];
+			if (next[i] >= 0)
+				prev[next[i]] = i;
+			head[d] = i;
+			if (d < mindeg)
+				mindeg = d;
+		}
+
+		/* reset |L_e \ L_p| */
+		for (k = 0; k < nlp; k++)
+		{
+			i = lp[k];
+			for (l = 0; l < nae[i]; l++)
+				w[ae[i][l]] = -1;
+		}
+	}
+
+	retour:
+
+	if (av != NULL)
+	{
+		for (i = 0; i < n; i++)
+			if (av[i] != NULL)
+				free(av[i]);
+		free(av);
+	}
+	if (ae != NULL)
+	{
+		for (i = 0; i < n; i++)
+			if (ae[i] != NULL)
+				free(ae[i]);
+		free(ae);
+	}
+	if (nav != NULL) free(nav);
+	if (nae != NULL) free(nae);
+	if (cav != NULL) free(cav);
+	if (cae != NULL) free(cae);
+	if (st != NULL) free(st);
+	if (deg != NULL) free(deg);
+	if (head != NULL) free(head);
+	if (next != NULL) free(next);
+	if (prev != NULL) free(prev);
+	if (mark != NULL) free(mark);
+	if (w != NULL) free(w);
+
+	return ret;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/** parts of nested dissection up to this size are not divided further */
+#define ND_LEAF_SIZE 8
+
+/**
+ *  The internal function <i>ordernesteddissection</i> orders the nodes
+ *  <i>set</i> of the graph by nested dissection. A level structure is
+ *  generated by breadth first search starting at a pseudo peripheral node,
+ *  the middle level is the separator, which is ordered after both parts.
+ *  Disconnected components are ordered one after another. The positions are
+ *  counted by <i>next</i>, <i>part</i>, <i>level</i> and <i>queue</i> are
+ *  work arrays of dimension nd.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  </ul>
+ */
+
+static err_code ordernesteddissection(count_far* ptr, count_far* adj,
+		count_far* set, count_far ns, count_far* order, count_far* next,
+		count_far* part, count_far* level, count_far* queue, count_far* id)
+{
+	count_far i, k, u, v, head, tail, pass, start, nlev, m, sum;
+	count_far nA, nB, nS;
+	count_far *pa, *pb, *ps;
+	err_code ret;
+
+	if (ns <= ND_LEAF_SIZE)
+	{
+		for (i = 0; i < ns; i++)
+			order[set[i]] = (*next)++;
+		return 0;
+	}
+
+	(*id)++;
+	for (i = 0; i < ns; i++)
+		part[set[i]] = *id;
+
+	/* level structure, the second search starts at the last node found */
+	start = set[0];
+	tail = 0;
+	nlev = 0;
+	for (pass = 0; pass < 2; pass++)
+	{
+		for (i = 0; i < ns; i++)
+			level[set[i]] = -1;
+
+		head = tail = 0;
+		queue[tail++] = start;
+		level[start] = 0;
+		while (head < tail)
+		{
+			u = queue[head++];
+			for (k = ptr[u]; k < ptr[u + 1]; k++)
+			{
+				v = adj[k];
+				if (part[v] == *id && level[v] < 0)
+				{
+					level[v] = level[u] + 1;
+					queue[tail++] = v;
+				}
+			}
+		}
+		start = queue[tail - 1];
+		nlev = level[start] + 1;
+	}
+
+	pa = (count_far *) malloc((unsigned) ns * sizeof(count_far));
+	pb = (count_far *) malloc((unsigned) ns * sizeof(count_far));
+	ps = (count_far *) malloc((unsigned) ns * sizeof(count_far));
+	if (pa == NULL || pb == NULL || ps == NULL)
+	{
+		if (pa != NULL) free(pa);
+		if (pb != NULL) free(pb);
+		if (ps != NULL) free(ps);
+		return 2;
+	}
+
+	nA = nB = nS = 0;
+
+	if (tail < ns)
+	{
+		/* disconnected: component of start node and the rest */
+		for (i = 0; i < ns; i++)
+		{
+			if (level[set[i]] >= 0)
+				pa[nA++] = set[i];
+			else
+				pb[nB++] = set[i];
+		}
+	}
+	else if (nlev < 3)
+	{
+		/* no separation possible */
+		for (i = 0; i < ns; i++)
+			ps[nS++] = set[i];
+	}
+	else
+	{
+		/* separator is the level, which halves the nodes */
+		sum = 0;
+		for (m = 0; m < nlev - 1; m++)
+		{
+			for (i = 0; i < tail; i++)
+				if (level[queue[i]] == m)
+					sum++;
+			if (2 * sum >= ns)
+				break;
+		}
+		if (m < 1)
+			m = 1;
+		if (m > nlev - 2)
+			m = nlev - 2;
+
+		for (i = 0; i < ns; i++)
+		{
+			u = set[i];
+			if (level[u] < m)
+				pa[nA++] = u;
+			else if (level[u] > m)
+				pb[nB++] = u;
+			else
+				ps[nS++] = u;
+		}
+	}
+
+	ret = ordernesteddissection(ptr, adj, pa, nA, order, next, part, level,
+			queue, id);
+	if (ret == 0)
+		ret = ordernesteddissection(ptr, adj, pb, nB, order, next, part,
+				level, queue, id);
+	for (i = 0; i < nS && ret == 0; i++)
+		order[ps[i]] = (*next)++;
+
+	free(pa);
+	free(pb);
+	free(ps);
+
+	return ret;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The internal function <i>orderblocktriangular</i> computes the block
+ *  triangular form of the matrix. A maximum transversal assigns a column
+ *  \f$c_i\f$ to each line \f$i\f$ (depth first search with augmenting
+ *  paths), afterwards the strongly connected components of the graph line
+ *  \f$i \rightarrow\f$ line \f$j\f$, if \f$a_{i,c_j} \neq 0\f$, are
+ *  determined by the algorithm of Tarjan. The components are found with
+ *  their dependencies first, <i>order</i> is set to the number of the block
+ *  of the line. <i>MA_LequSparseCodegen</i> decomposes and solves the matrix
+ *  block by block in this order. Blocks of one line are counted by
+ *  <i>nsingle</i>.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  </ul>
+ */
+
+static err_code orderblocktriangular(struct sparse* sA, count_far* order,
+		count_far* nblocks, count_far* nsingle)
+{
+	count_far i, k, c, u, v, n, top, found, prev, size, idx, stop;
+	count_far *rowmatch, *colmatch, *visited, *stack, *pos, *index, *low, *cstack;
+	char *onstack;
+	err_code ret = 0;
+
+	n = sA->nd;
+
+	rowmatch = (count_far *) malloc((unsigned) (n + 1) * sizeof(count_far));
+	colmatch = (count_far *) malloc((unsigned) (n + 1) * sizeof(count_far));
+	visited = (count_far *) malloc((unsigned) (n + 1) * sizeof(count_far));
+	stack = (count_far *) malloc((unsigned) (n + 1) * sizeof(count_far));
+	pos = (count_far *) malloc((unsigned) (n + 1) * sizeof(count_far));
+	index = (count_far *) malloc((unsigned) (n + 1) * sizeof(count_far));
+	low = (count_far *) malloc((unsigned) (n + 1) * sizeof(count_far));
+	cstack = (count_far *) malloc((unsigned) (n + 1) * sizeof(count_far));
+	onstack = (char *) calloc((unsigned) (n + 1), sizeof(char));
+
+	if (rowmatch == NULL || colmatch == NULL || visited == NULL || stack == NULL || pos == NULL
+			|| index == NULL || low == NULL || cstack == NULL || onstack == NULL)
+	{
+		ret = 2;
+		goto retour;
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		rowmatch[i] = colmatch[i] = visited[i] = -1;
+	}
+
+	/* maximum transversal */
+	for (i = 0; i < n; i++)
+	{
+		/* cheap assignment */
+		for (k = sA->ia[i]; k < sA->ia[i + 1]; k++)
+		{
+			if (colmatch[sA->ja[k]] < 0)
+			{
+				rowmatch[i] = sA->ja[k];
+				colmatch[sA->ja[k]] = i;
+				break;
+			}
+		}
+		if (rowmatch[i] >= 0)
+			continue;
+
+		/* augmenting path */
+		found = -1;
+		top = 0;
+		stack[0] = i;
+		pos[i] = sA->ia[i];
+		while (top >= 0 && found < 0)
+		{
+			u = stack[top];
+			if (pos[u] >= sA->ia[u + 1])
+			{
+				top--;
+				continue;
+			}
+
+			c = sA->ja[pos[u]++];
+			if (visited[c] == i)
+				continue;
+			visited[c] = i;
+
+			if (colmatch[c] < 0)
+			{
+				found = c;
+			}
+			else
+			{
+				v = colmatch[c];
+				stack[++top] = v;
+				pos[v] = sA->ia[v];
+			}
+		}
+
+		for (c = found; c >= 0 && top >= 0; top--)
+		{
+			u = stack[top];
+			prev = rowmatch[u];
+			rowmatch[u] = c;
+			colmatch[c] = u;
+			c = prev;
+		}
+	}
+
+	/* strongly connected components (Tarjan), iterative */
+	for (i = 0; i < n; i++)
+		index[i] = -1;
+
+	idx = 0;
+	stop = 0;
+	*nblocks = 0;
+	*nsingle = 0;
+
+	for (i = 0; i < n; i++)
+	{
+		if (index[i] >= 0)
+			continue;
+
+		top = 0;
+		stack[0] = i;
+		pos[i] = sA->ia[i];
+		index[i] = low[i] = idx++;
+		cstack[stop++] = i;
+		onstack[i] = 1;
+
+		while (top >= 0)
+		{
+			u = stack[top];
+
+			if (pos[u] < sA->ia[u + 1])
+			{
+				c = sA->ja[pos[u]++];
+				v = colmatch[c];
+				if (v < 0 || v == u)
+					continue;
+
+				if (index[v] < 0)
+				{
+					stack[++top] = v;
+					pos[v] = sA->ia[v];
+					index[v] = low[v] = idx++;
+					cstack[stop++] = v;
+					onstack[v] = 1;
+				}
+				else if (onstack[v] && index[v] < low[u])
+				{
+					low[u] = index[v];
+				}
+				continue;
+			}
+
+			/* all successors visited */
+			if (low[u] == index[u])
+			{ /* u is root of a component */
+				size = 0;
+				do
+				{
+					v = cstack[--stop];
+					onstack[v] = 0;
+					order[v] = *nblocks;
+					size++;
+				} while (v != u);
+				(*nblocks)++;
+				if (size == 1)
+					(*nsingle)++;
+			}
+
+			top--;
+			if (top >= 0 && low[u] < low[stack[top]])
+				low[stack[top]] = low[u];
+		}
+	}
+
+	retour:
+
+	if (rowmatch != NULL) free(rowmatch);
+	if (colmatch != NULL) free(colmatch);
+	if (visited != NULL) free(visited);
+	if (stack != NULL) free(stack);
+	if (pos != NULL) free(pos);
+	if (index != NULL) free(index);
+	if (low != NULL) free(low);
+	if (cstack != NULL) free(cstack);
+	if (onstack != NULL) free(onstack);
+
+	return ret;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The internal function <i>fillreducingorder</i> computes the pivot priority
+ *  <i>code->order</i> of the lines of the matrix by the ordering
+ *  <i>code->ordering</i>:
+ *  <ul><li> 1 - minimum degree of the symmetric pattern \f$A + A^T\f$
+ *  <li> 2 - nested dissection of the symmetric pattern \f$A + A^T\f$
+ *  <li> 3 - block triangular form
+ *  </ul>
+ *  <i>MA_LequSparseCodegen</i> takes the pivot line in this order, lines of
+ *  the same priority (the lines of a diagonal block) are selected by their
+ *  Markowitz sums. For the symmetric orderings the diagonal element is the
+ *  preferred pivot of a line. Without ordering the pivot is searched by
+ *  Markowitz sums over the whole remaining matrix. For the block triangular
+ *  form only the diagonal blocks are decomposed, see
+ *  <i>MA_LequSparseCodegen</i>.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  </ul>
+ */
+
+static err_code fillreducingorder(struct spcode* code, struct sparse* sA)
+{
+	count_far i, n, next, id;
+	count_far *ptr, *adj, *set, *part, *level, *queue;
+	err_code ret;
+
+	if (code->order != NULL)
+	{
+		free(code->order);
+		code->order = NULL;
+	}
+
+	code->nblocks = 0;
+	code->nsingle = 0;
+
+	if (code->ordering < 1 || code->ordering > 3)
+		return 0;
+
+	n = sA->nd;
+
+	code->order = (count_far *) calloc((unsigned) (n + 1),
+			(unsigned) sizeof(count_far));
+	if (code->order == NULL)
+	{
+		ret = 2;
+		goto retour;
+	}
+
+	if (code->ordering == 3)
+	{
+		ret = orderblocktriangular(sA, code->order, &code->nblocks,
+				&code->nsingle);
+		goto retour;
+	}
+
+	ret = ordergraph(sA, &ptr, &adj);
+	if (ret != 0)
+		goto retour;
+
+	if (code->ordering == 1)
+	{
+		ret = orderminimumdegree(n, ptr, adj, code->order);
+	}
+	else
+	{
+		set = (count_far *) malloc((unsigned) (n + 1) * sizeof(count_far));
+		part = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+		level = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+		queue = (count_far *) calloc((unsigned) (n + 1), (unsigned) sizeof(count_far));
+
+		if (set == NULL || part == NULL || level == NULL || queue == NULL)
+		{
+			ret = 2;
+		}
+		else
+		{
+			for (i = 0; i < n; i++)
+				set[i] = i;
+
+			next = 0;
+			id = 0;
+			ret = ordernesteddissection(ptr, adj, set, n, code->order, &next,
+					part, level, queue, &id);
+		}
+
+		if (set != NULL) free(set);
+		if (part != NULL) free(part);
+		if (level != NULL) free(level);
+		if (queue != NULL) free(queue);
+	}
+
+	free(ptr);
+	free(adj);
+
+	retour:
+
+	if (ret != 0)
+	{
+		if (code->order != NULL) free(code->order);
+		code->order = NULL;
+	}
+
+	return ret;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The internal function <i>tocodebackward</i> adds the backward
+ *  substitution of the decomposed lines <i>ip[kbeg]</i> ..
+ *  <i>ip[kend-1]</i> to the solution code: the pivot of line <i>ip[k]</i>
+ *  is in column <i>jp[k]</i>, each line is substituted with the solutions of
+ *  the following lines.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  </ul>
+ */
+
+static err_code tocodebackward(struct spcode* code, struct sparse* sA,
+		count_far* ip, count_far* jp, count_far kbeg, count_far kend)
+{
+	count_far k, line, i3, i4, i6;
+
+	for (k = kend - 2; k >= kbeg; k--)
+	{
+		line = ip[k];
+
+		i4 = sA->ia[line]; /* steps through actual line in sparse list */
+		do
+		{
+			i6 = sA->ja[i4]; /* column of actual element i4 in line */
+			if (i6 < 0)
+				i6 = -i6 - 1; /* all elements are watched at */
+			for (i3 = k + 1; i3 < kend; i3++) /* i3 steps through ready lines */
+			{
+				if (i6 == jp[i3])
+				{	/* test: is ready pivot in column i6 of el. i4? */
+					if (tocodesol(code, line, ip[i3], i4) != 0)
+						return 2;
+				} /* if it is, in line a backward subst. step is done with the
+				 pivot standing on the right hand vector in line ip[i3] */
+			}
+			i4 = sA->fa[i4];
+		} while (i4 > -1);
+	}
+
+	return 0;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The internal function <i>tocodecoupling</i> adds the forward substitution
+ *  of the solutions of the previous diagonal blocks to the solution code for
+ *  the lines <i>ip[kbeg]</i> .. <i>ip[kend-1]</i> of the diagonal block
+ *  <i>block</i>: \f$r_{line} = r_{line} - a_{line,c}\,x_c\f$ for all columns
+ *  \f$c\f$ outside of the block, \f$x_c\f$ is stored in line
+ *  <i>pivline[c]</i> of the right hand side. The coupling elements are
+ *  marked as decomposed, thus the decomposition of the block doesn't see
+ *  them.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  </ul>
+ */
+
+static err_code tocodecoupling(struct spcode* code, struct sparse* sA,
+		count_far* ip, count_far kbeg, count_far kend, count_far* colblock,
+		count_far* pivline, count_far block)
+{
+	count_far k, i, c, line;
+
+	for (k = kbeg; k < kend; k++)
+	{
+		line = ip[k];
+		if (sA->ia[line] == sA->ia[line + 1])
+			continue; /* line is empty by structure */
+
+		for (i = sA->ia[line]; i > -1; i = sA->fa[i])
+		{
+			c = sA->ja[i];
+			if (c > -1 && colblock[c] != block)
+			{
+				if (tocodesol(code, line, pivline[c], i) != 0)
+					return 2;
+				sA->ja[i] = -c - 1; /* marking */
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  For the block triangular form (<i>code->ordering</i> = 3) the diagonal
+ *  blocks are decomposed one after the other, dependencies first. The
+ *  solution code of a block starts with the forward substitution of the
+ *  solutions of the previous blocks (coupling elements), followed by the
+ *  decomposition and the backward substitution of the block, thus no
+ *  fill-ins occur outside of the diagonal blocks. A block of one line
+ *  becomes the direct assignment \f$x_i = r_i / z_{ii}\f$. A singular
+ *  diagonal block makes the matrix singular.
+ *
+ * @return
+ *  <ul><li>    0 - okay
+ *  <li>        1 - reallocation of NULL pointer
+ *  <li>        2 - not enough memory
+ *  <li>		3 - dimension erroneous
+ *  <li>		4 - matrix singular
+ *  <li>		6 - no sparse matrix
+ *  </ul>
+ */
+exportMA_Sparse err_code MA_LequSparseCodegen(struct sparse* sA,
+		struct spcode* code)
+#ifdef NOT_USED
+    /* channel for debug output*/
+	FILE *debf;
+#endif
+/*-----------------------------------------------------------------*/
+/*SparseDebug :
+ 0 - nothing
+ 1 - step, line etc. if singular
+ 2 - matrix after dec., code
+ 3 - tolerance criteria
+ 4 - step, pivot candidates
+ 5 - full information
+ */
+{
+	count_near ret; /* return variable */
+	count_far i, i1, j1 = 0, i2, i3, k = 0, kk, j, i6, lvgl = 0,
+			mi = 0, i7, m1, line, jlast, coljlast,
+			coli, /* column in pivot line */
+			colj, /* column in nonpivot line */
+			ipc, /* number of element in pivot column, sparse list */
+			n = 0, /* dimension */
+			nn, /* dimension - 1 */
+			nel, /* number elements */
+			niz, /* dimension of the matrix to be decomposed */
+			pnew, /* pointer to the last element in the sparse list */
+			l1, /* index of first el. in pivot line */
+			mark, /* Markowitz sum */
+			lz, /* pivot line   */
+			l, /* pivot number in sparse list */
+			ls, /* pivot column */
+			jbeg, jend, /* range of candidate lines in ip */
+			mend, /* end of the lines eliminated in ip */
+			bcur = -1, /* current diagonal block */
+			bstart = 0; /* first line of the current diagonal block in ip */
+
+	count_far *ip, /* line permutation vector */
+	*jp, /* column permutation vactor */
+	*jz, /* Markowitz sums of pivot proposals in the line */
+	*ik, /* indexes in a list of pivot proposals in the line */
+	*is, /* numbers of elements in undecomposed matrix part */
+	*colblock = NULL, /* diagonal block of the columns (ordering 3) */
+	*pivline = NULL; /* pivot line of the columns (ordering 3) */
+
+	int blocks = 0; /* decomposition block by block */
+
+	value su, w, rk, schwell, p, pmin, al; /* pivot value */
+
+	count_far pivot_flop, ndec;
+	pivot_flop = ndec = 0;
+
+	code->pivot_flop = code->dec_flop = code->sol_flop = code->dec_ma = 0;
+	code->pattern_nd = 0; /* no valid code for refactorization */
+
+	/* get correct order of entries in sparse list */
+	MA_SortSparseList(sA);
+
+#ifdef NOT_USED
+	/*Should never happen*/
+	if (MA_GetSparseFullDescription(sA))
+	{	fprintf(debf,"System matrix used as a full description  \n");
+		return 6;
+	}
+#endif
+
+	sA->decomp = 1; /* note: matrix decomposed */
+
+	ret = 0;
+	if (sA->nd < 1 || sA->nel < 1)
+	{
+		return 3;
+	}
+
+	ip = (count_far *) calloc((unsigned) (sA->nd + 1),
+			(unsigned) sizeof(count_far));
+	jp = (count_far *) calloc((unsigned) (sA->nd + 1),
+			(unsigned) sizeof(count_far));
+	jz = (count_far *) calloc((unsigned) (sA->nd + 1),
+			(unsigned) sizeof(count_far));
+	ik = (count_far *) calloc((unsigned) (sA->nd + 1),
+			(unsigned) sizeof(count_far));
+	is = (count_far *) calloc((unsigned) (sA->nd + 1),
+			(unsigned) sizeof(count_far));
+
+	if (ip == NULL || jp == NULL || jz == NULL || ik == NULL || is == NULL)
+	{
+		ret = 2;
+		goto retour;
+	}
+
+#ifdef NOT_USED
+	brauchen wir nicht
+	if (code->SparseDebug > 0)
+	{	if (code->SparseDebug == 5)
+		{	fprintf(debf,"start lequsparse_codegen  \n");
+			MA_PrintSparse(sA, debf);
+		}
+	}
+#endif
+
+	/* Initialization */
+	/* ============== */
+	n = sA->nd;
+	nn = n - 1;
+	nel = sA->nel;
+
+	/* Code initialization */
+	code->ndecmax = code->nsolmax = 3 * 2 * nel;
+	if (code->dec != NULL)
+	{
+		free(code->dec);
+		code->dec = NULL;
+	}
+
+	if (code->sol != NULL)
+	{
+		free(code->sol);
+		code->sol = NULL;
+	}
+
+	if (code->isort != NULL)
+	{
+		free(code->isort);
+		code->isort = NULL;
+	}
+
+	code->dec = (count_far *) calloc((unsigned) (code->ndecmax),
+			(unsigned) sizeof(count_far));
+	code->sol = (count_far *) calloc((unsigned) (code->nsolmax),
+			(unsigned) sizeof(count_far));
+	code->isort = (count_far *) calloc((unsigned) (sA->nd + 1),
+			(unsigned) sizeof(count_far));
+	if (code->sol == NULL || code->dec == NULL || code->isort == NULL)
+	{
+
+		if(code->sol!=NULL) free(code->sol);
+		code->sol=NULL;
+
+		if(code->dec!=NULL) free(code->dec);
+		code->dec=NULL;
+
+		if(code->isort!=NULL) free(code->isort);
+		code->isort=NULL;
+
+		ret = 2;
+		goto retour;
+	}
+	code->ndec = code->nsol = 0;
+	code->critical_column = code->critical_line = -1; /* default regular */
+
+	/* structure before decomposition, required for refactorization */
+	if (storepattern(code, sA) != 0)
+	{
+		ret = 2;
+		goto retour;
+	}
+
+	/* pivot priority of lines by fill-reducing ordering */
+	if (fillreducingorder(code, sA) != 0)
+	{
+		ret = 2;
+		goto retour;
+	}
+
+	if (code->ordering == 3 && code->order != NULL)
+	{ /* the block of a column is the first block, which uses it */
+		blocks = 1;
+
+		colblock = (count_far *) malloc((unsigned) (n + 1) * sizeof(count_far));
+		pivline = (count_far *) malloc((unsigned) (n + 1) * sizeof(count_far));
+		if (colblock == NULL || pivline == NULL)
+		{
+			ret = 2;
+			goto retour;
+		}
+
+		for (i = 0; i < n; i++)
+		{
+			colblock[i] = n;
+			pivline[i] = -1;
+		}
+
+		for (i = 0; i < n; i++)
+		{
+			for (k = sA->ia[i]; k < sA->ia[i + 1]; k++)
+			{
+				if (code->order[i] < colblock[sA->ja[k]])
+					colblock[sA->ja[k]] = code->order[i];
+			}
+		}
+	}
+
+	/*niz = n;  never used ????? */ /* dimension of remaining matrix, still to be decomposed */
+	pnew = nel - 1;/* pointer to the last element in the sparse list */
+
+	schwell = 1.0 / code->gener_piv_scope;
+
+	code->fill_ins = nel; /* original number of fill ins before decomposition */
+
+	/* ip, jp, is  - initialization */
+	for (i = 0; i < n; i++)
+	{
+		ip[i] = jp[i] = i;
+		is[i] = 0;
+	}
+	if (blocks)
+	{ /* Markowitz sums within the diagonal blocks */
+		for (i = 0; i < n; i++)
+		{
+			for (k = sA->ia[i]; k < sA->ia[i + 1]; k++)
+			{
+				if (colblock[sA->ja[k]] == code->order[i])
+					is[sA->ja[k]]++;
+			}
+		}
+	}
+	else
+	{
+		for (i = 0; i < nel; i++)
+			is[sA->ja[i]]++;
+	}
+
+#ifdef NOT_USED
+	if (code->SparseDebug > 0)
+	{	if (code->SparseDebug == 5)
+		{	fprintf(debf,"\n before first step \n");
+			MA_PrintSparse(sA, debf);
+			for (i = 0; i < n; i++)
+			fprintf(debf,"%6d   ip %6d   jp %6d   is %6d   jz %6d   ik %6d \n",
+				(int)i,(int)ip[i],(int)jp[i],(int)is[i],(int)jz[i],(int)ik[i]);
+		}
+	}
+#endif
+
+	for (niz = n; niz > 1; niz--)
+	{
+
+#ifdef NOT_USED
+		if (code->SparseDebug > 0)
+		{
+			if (code->SparseDebug == 3 || code->SparseDebug == 4
+					|| code->SparseDebug == 5)
+			{	fprintf(debf,"\n\n\n pivot step, niz = %d  \n\n",(int)niz);
+			}
+		}
+#endif
+
+		kk = n - niz; /* number of finished decomposition steps */
+		code->rank = kk;
+
+		/* Pivot candidates (stored in ik), Markowitz sums (stored in jz) */
+		/* ============================================================== */
+		jbeg = kk;
+		jend = n;
+		if (code->order != NULL)
+		{ /* only the lines of minimal priority are candidates, moved to kk.. */
+			for (j = kk + 1; j < n; j++)
+			{
+				if (code->order[ip[j]] < code->order[ip[jbeg]])
+					jbeg = j;
+			}
+			i = code->order[ip[jbeg]];
+			jbeg = kk;
+			jend = kk;
+			for (j = kk; j < n; j++)
+			{
+				if (code->order[ip[j]] == i)
+				{
+					i1 = ip[j];
+					ip[j] = ip[jend];
+					ip[jend++] = i1;
+				}
+			}
+
+			if (blocks && i != bcur)
+			{ /* next diagonal block: backward substitution of the finished
+			     block, forward substitution of the coupling elements */
+				if (bcur >= 0 && tocodebackward(code, sA, ip, jp, bstart, kk) != 0)
+				{
+					ret = 2;
+					goto retour;
+				}
+				if (tocodecoupling(code, sA, ip, jbeg, jend, colblock, pivline, i)
+						!= 0)
+				{
+					ret = 2;
+					goto retour;
+				}
+				bcur = i;
+				bstart = kk;
+			}
+		}
+
+		candidates:
+
+		for (j = jbeg; j < jend; j++)
+		{
+			i1 = ip[j]; /* line number, formerly i1 = iz[ ip[j]]; */
+			if (sA->ia[i1] == sA->ia[i1 + 1])
+			{ /* line is empty by structure */
+				ret = 4; /* singular */
+
+#ifdef NOT_USED
+				if (code->SparseDebug > 0)
+				{
+					if (code->SparseDebug == 1 || code->SparseDebug == 5)
+					{
+						fprintf(debf,"structural singular in "
+								"decomposition step %d  \n",(int)kk);
+						fprintf(debf,"in line:  %6d  no pivot "
+								"candidate \n",(int)i1);
+						fprintf(debf,"already decomposed:  \n");
+						for (i = 0; i < kk; i++)
+						{
+							fprintf(debf,"line:  %6d  column:  "
+									"%6d\n",(int)ip[i],(int)jp[i]);
+						}
+					}
+				}
+#endif
+
+#ifdef NOT_USED
+				if (code->name_of_variable != NULL
+						&& code->name_of_equation != NULL)
+				fprintf(debf,"structural singular at variable: %s, equation: %s",
+						code->name_of_variable((count_near)jp[j]),
+						code->name_of_equation((count_near)ip[j]));
+#endif
+
+				code->critical_line = ip[j];
+				code->critical_column = jp[j];
+
+				/* if (j == n - 1) goto backward; goto retour; */
+				ik[i1] = -1; /* no pivot candidate in this line */
+				jz[i1] = 0; /* therefore, markowitz sum is zero */
 			}
 			else
 			{ /* there exist elements in the line */
@@ -546,6 +1655,9 @@ exportMA_Sparse err_code MA_LequSparseCodegen(struct sparse* sA,
 									mark = (i2 - 1) * (is[i6] - 1);
 									i7 = i2 + is[i6];
 									p = mark + code->piv_rel_tol * rk;
+									if (code->order != NULL && code->ordering != 3
+											&& i6 == i1)
+										p = -1.0; /* prefer diagonal */
 									if (p < pmin || (p == pmin && i7 < lvgl))
 									{
 										pmin = p;
@@ -583,9 +1695,20 @@ exportMA_Sparse err_code MA_LequSparseCodegen(struct sparse* sA,
 		/* finding pivot line - minimal Markowitz sum */
 		/* ========================================== */
 
+		if (jend < n && !blocks)
+		{ /* no pivot in lines of the ordering - search all lines */
+			for (j = jbeg; j < jend && ik[ip[j]] < 0; j++)
+				;
+			if (j == jend)
+			{
+				jend = n;
+				goto candidates;
+			}
+		}
+
 		mark = -1;
 		i2 = -1;
-		for (j = kk; j < n; j++)
+		for (j = jbeg; j < jend; j++)
 		{
 			if (ik[ip[j]] > -1)
 			{
@@ -625,6 +1748,9 @@ exportMA_Sparse err_code MA_LequSparseCodegen(struct sparse* sA,
 		l1 = sA->ia[lz]; /* first el. pivot line in sparse list */
 		al = sA->a[l]; /* pivot value */
 
+		if (blocks)
+			pivline[ls] = lz;
+
 #ifdef NOT_USED
 		if (code->SparseDebug > 0)
 		{
@@ -709,9 +1835,11 @@ exportMA_Sparse err_code MA_LequSparseCodegen(struct sparse* sA,
 		}
 #endif
 
-		/* non pivot lines */
+		/* non pivot lines - only the lines of the diagonal block for the
+		   block triangular form */
 		/* =============== */
-		for (m1 = kk + 1; m1 < n; m1++)
+		mend = blocks ? jend : n;
+		for (m1 = kk + 1; m1 < mend; m1++)
 		{
 			line = ip[m1]; /* actual line */
 #ifdef NOT_USED
@@ -948,353 +2076,1111 @@ exportMA_Sparse err_code MA_LequSparseCodegen(struct sparse* sA,
 		i = l1;
 		while (i > -1)
 		{
-			if (sA->ja[i] > -1) /* neglect decomposed part */
+			if (sA->ja[i] > -1) /* neglect decomposed part */
+			{
+				is[sA->ja[i]] -= 1; /* updating is */
+				sA->ja[i] = -sA->ja[i] - 1; /* marking */
+			}
+			i = sA->fa[i];
+		}
+
+#ifdef NOT_USED
+		if (code->SparseDebug > 0)
+		{
+			if (code->SparseDebug == 5)
+			{
+				fprintf(debf,"after modifikation non pivot lines  \n");
+				MA_PrintSparse(sA, debf);
+				for (i = 0; i < n; i++)
+				fprintf(debf,"%6d   ip %6d   jp %6d   is %6d   jz %6d   "
+						"ik %6d \n",
+						(int)i,(int)ip[i],(int)jp[i],(int)is[i],(int)jz[i],
+						(int)ik[i]);
+			}
+		}
+#endif
+
+	} /* end niz */
+
+	code->rank = sA->nd - niz;
+
+	if (blocks && code->order[ip[nn]] != bcur)
+	{ /* the last line is a diagonal block of its own */
+		if (bcur >= 0 && tocodebackward(code, sA, ip, jp, bstart, nn) != 0)
+		{
+			ret = 2;
+			goto retour;
+		}
+		if (tocodecoupling(code, sA, ip, nn, n, colblock, pivline,
+				code->order[ip[nn]]) != 0)
+		{
+			ret = 2;
+			goto retour;
+		}
+		bcur = code->order[ip[nn]];
+		bstart = nn;
+	}
+
+	/* last pivot line */
+	/* =============== */
+	i = ip[nn];
+	j = jp[nn];
+	i1 = sA->ia[i];
+	while (sA->ja[i1] != j)
+	{
+		i1 = sA->fa[i1]; /* index to pivot in sparse list */
+		if (i1 < 0) /* singular, no pivot element */
+		{
+			ret = 4;
+
+#ifdef NOT_USED
+			if (code->SparseDebug > 0)
+			{
+				if (code->SparseDebug == 1 || code->SparseDebug == 5)
+				{
+					fprintf(debf,"structurally singular in last decomposition "
+							"step  \n");
+					fprintf(debf,"line:  %6d  column:  %6d\n",(int)i,(int)j);
+				}
+			}
+#endif
+
+#ifdef NOT_USED
+			if (code->name_of_variable != NULL
+					&& code->name_of_equation != NULL)
+			fprintf(debf,"singular at variable: %s,  equation: %s",
+					code->name_of_variable((count_near)jp[nn]),
+					code->name_of_equation((count_near)ip[nn]));
+#endif
+
+			code->critical_line = ip[nn];
+			code->critical_column = jp[nn];
+
+			goto backward;
+			/* goto retour; */
+		}
+	}
+	if (absol(sA->a[i1]) < code->piv_abs_tol) /* matrix singular */
+	{
+		ret = 4;
+
+#ifdef NOT_USED
+		if (code->SparseDebug > 0)
+		{
+			if (code->SparseDebug == 1 || code->SparseDebug == 5)
+			{
+				fprintf(debf,"numerically singular in last decomposition "
+						"step  \n");
+				fprintf(debf,"line:  %6d  column:  %6d\n",(int)i,(int)j);
+			}
+		}
+#endif
+
+		code->critical_line = i;
+		code->critical_column = j;
+		goto backward;
+		/* goto retour; */
+	}
+	sA->a[i1] = 1.0 / sA->a[i1];
+	sA->ja[j1] = -sA->ja[j1] - 1;
+
+	if (tocodedec(code, i1, -1, -1) != 0)
+	{
+		ret = 2;
+		goto retour;
+	}
+
+	if (tocodesol(code, i, i1, -1) != 0)
+	{
+		ret = 2;
+		goto retour;
+	}
+	code->rank = n;
+
+	/* ====================== */
+	/* backward decomposition */
+	/* ====================== */
+	backward: code->nsoldec = code->nsol;
+
+#ifdef NOT_USED
+	if (code->SparseDebug > 0)
+	{
+		if (code->SparseDebug == 5)
+		{
+			fprintf(debf,"before start backward decomposition  \n");
+			MA_PrintSparse(sA, debf);
+			for (i = 0; i < n; i++)
+			fprintf(debf,"%6d   ip %6d   jp %6d   is %6d   jz %6d   ik %6d \n",
+					(int)i,(int)ip[i],(int)jp[i],(int)is[i],(int)jz[i],
+					(int)ik[i]);
+			fprintf(debf,"n  %d \n",(int)n);
+		}
+	}
+#endif
+
+	if (blocks)
+	{ /* backward substitution of the last diagonal block, the code of a
+	     singular diagonal block is not used */
+		if (code->rank < n)
+			ret = 4;
+		if (ret != 0)
+			goto retour;
+
+		if (tocodebackward(code, sA, ip, jp, bstart, n) != 0)
+		{
+			ret = 2;
+			goto retour;
+		}
+
+		/* the backward substitution of a block follows its decomposition */
+		code->nsoldec = code->nsol;
+	}
+	else
+	{
+		/* filling zerodemand in singular case */
+		if (code->rank < n)
+		{
+			k = n - code->rank;
+			if (code->zerodemand != NULL)
+			{
+				free(code->zerodemand);
+				code->zerodemand = NULL;
+			}
+			code->zerodemand = (count_far *) calloc((unsigned) k,
+					(unsigned) sizeof(count_far));
+			if (code->zerodemand == NULL)
+			{
+				ret = 2;
+				goto retour;
+			}
+
+			for (i = 0; i < k; i++)
+				code->zerodemand[i] = ip[i + code->rank];
+
+#ifdef NOT_USED
+			if (code->SparseDebug > 0)
+			{
+				if (code->SparseDebug == 5)
+				{
+					fprintf(debf, "after decomposition the following positions ");
+					fprintf(debf, "of the solution vector have to be zero  \n");
+					for (i = 0; i < n - code->rank; i++)
+					fprintf(debf, "%6d  ", (int) code->zerodemand[i]);
+					fprintf(debf, " \n");
+				}
+			}
+#endif
+		}
+
+		if (tocodebackward(code, sA, ip, jp, 0, n) != 0)
+		{
+			ret = 2;
+			goto retour;
+		}
+	}
+
+	for (i = 0; i < n; i++)
+		code->isort[ip[i]] = jp[i]; /* for back permutation
+		 of solution */
+
+	code->fill_ins_after_dec = pnew + 1;
+
+	code->pivot_flop = 4.9 * pivot_flop;
+	ndec = code->ndec/3;
+	code->dec_flop = 3 * code->rank + code->dec_ma + ndec;
+	code->sol_flop = 2 * code->fill_ins_after_dec - code->rank;
+
+	if (ret == 0 && code->rank == n)
+		code->pattern_nd = n; /* code can be replayed by refactorization */
+
+	/*========================*/
+	/*Actions at the very end */
+	/*========================*/
+
+	retour:
+
+#ifdef NOT_USED
+
+	if (code->SparseDebug > 0)
+	{
+		if (code->SparseDebug == 2 || code->SparseDebug == 5)
+		{
+			fprintf(debf,"matrix at the end of decomposition \n");
+			MA_PrintSparse(sA, debf);
+			for (i = 0; i < n; i++)
+			fprintf(debf,"%6d   ip %6d   jp %6d   is %6d   jz %6d   ik %6d \n",
+					(int)i,(int)ip[i],(int)jp[i],(int)is[i],(int)jz[i],
+					(int)ik[i]);
+
+			fprintf(debf,"decomposition code \n");
+			for (i = 0; i < code->ndec; i +=3)
+			{
+				fprintf(debf," %8d %8d %8d \n",
+						(int)code->dec[i], (int)code->dec[i+1],
+						(int)code->dec[i+2]);
+			}
+
+			fprintf(debf,"solution code \n");
+			for (i = 0; i < code->nsol; i +=3)
+			{	fprintf(debf," %8d %8d %8d \n",
+						(int)code->sol[i], (int)code->sol[i+1],
+						(int)code->sol[i+2]);
+			}
+
+			fprintf(debf,"vector for back permutation of solution \n");
+			for (i = 0; i < n; i++)
+			{
+				fprintf(debf," %8d %8d %8d ", (int)code->sol[i],
+						(int)code->sol[i+1], (int)code->sol[i+2]);
+			}
+			fprintf(debf,"\n end of lequsparse_codegen \n\n");
+
+		}
+	}
+
+#endif
+
+	if(ip!=NULL) free(ip);
+	if(jp!=NULL) free(jp);
+	if(jz!=NULL) free(jz);
+	if(ik!=NULL) free(ik);
+	if(is!=NULL) free(is);
+	if(colblock!=NULL) free(colblock);
+	if(pivline!=NULL) free(pivline);
+
+	ip = NULL;
+	jp = NULL;
+	jz = NULL;
+	ik = NULL;
+	is = NULL;
+
+	return ret;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ * @return
+ *  <ul><li>    0 - okay
+ *  <li>		5 - zero demand not satisfied
+ *  </ul>
+ */
+exportMA_Sparse err_code MA_LequSparseSolut(struct sparse* sA,
+		struct spcode* code,value* r,value* x)
+{
+	count_far k, l;
+	err_code ret;
+
+	/* printf("\n in Solut:  rank  %d   nsol  %d   nsoldec  %d\n",
+	 (int)code->rank, (int)code->nsol, (int)code->nsoldec); */
+
+	ret = 0;
+
+	if (code->rank == sA->nd)
+	{ /* solution in regular case, decomposition and backward subst. together */
+		for (l = 0; l < code->nsol; l += 3)
+		{
+			k = code->sol[l + 2];
+			if (k < 0)
 			{
-				is[sA->ja[i]] -= 1; /* updating is */
-				sA->ja[i] = -sA->ja[i] - 1; /* marking */
+				*(r + code->sol[l]) *= sA->a[code->sol[l + 1]];
+
+			/*	 printf(" rl = %e  a=%e \n",
+				 (double)(*(r + code->sol[l])),
+				 (double)(sA->a[ code->sol[l+1] ])); */
+			}
+			else
+			{
+				*(r + code->sol[l]) -= *(r + code->sol[l + 1]) * sA->a[k];
+			/*	 printf(" rl = %e  rl+1=%e  a=%e \n", *(r + code->sol[l]),
+				 *(r + code->sol[l+1]), sA->a[ k ]); */
 			}
-			i = sA->fa[i];
 		}
-
-#ifdef NOT_USED
-		if (code->SparseDebug > 0)
+	}
+	else
+	{ /* singular case */
+		for (l = 0; l < code->nsoldec; l += 3) /* decomposition */
 		{
-			if (code->SparseDebug == 5)
+			k = code->sol[l + 2];
+			if (k < 0)
 			{
-				fprintf(debf,"after modifikation non pivot lines  \n");
-				MA_PrintSparse(sA, debf);
-				for (i = 0; i < n; i++)
-				fprintf(debf,"%6d   ip %6d   jp %6d   is %6d   jz %6d   "
-						"ik %6d \n",
-						(int)i,(int)ip[i],(int)jp[i],(int)is[i],(int)jz[i],
-						(int)ik[i]);
+				*(r + code->sol[l]) *= sA->a[code->sol[l + 1]];
+			}
+			else
+			{
+				*(r + code->sol[l]) -= *(r + code->sol[l + 1]) * sA->a[k];
 			}
 		}
-#endif
-
-	} /* end niz */
-
-	code->rank = sA->nd - niz;
 
-	/* last pivot line */
-	/* =============== */
-	i = ip[nn];
-	j = jp[nn];
-	i1 = sA->ia[i];
-	while (sA->ja[i1] != j)
-	{
-		i1 = sA->fa[i1]; /* index to pivot in sparse list */
-		if (i1 < 0) /* singular, no pivot element */
+		for (l = 0; l < sA->nd - code->rank; l++)
 		{
-			ret = 4;
-
-#ifdef NOT_USED
-			if (code->SparseDebug > 0)
+			if (r[code->zerodemand[l]] > code->piv_abs_tol
+					|| r[code->zerodemand[l]] < -code->piv_abs_tol)
 			{
-				if (code->SparseDebug == 1 || code->SparseDebug == 5)
-				{
-					fprintf(debf,"structurally singular in last decomposition "
-							"step  \n");
-					fprintf(debf,"line:  %6d  column:  %6d\n",(int)i,(int)j);
-				}
+				ret = 5;
+			    code->critical_line=code->isort[l];
 			}
-#endif
-
-#ifdef NOT_USED
-			if (code->name_of_variable != NULL
-					&& code->name_of_equation != NULL)
-			fprintf(debf,"singular at variable: %s,  equation: %s",
-					code->name_of_variable((count_near)jp[nn]),
-					code->name_of_equation((count_near)ip[nn]));
-#endif
-
-			code->critical_line = ip[nn];
-			code->critical_column = jp[nn];
-
-			goto backward;
-			/* goto retour; */
 		}
-	}
-	if (absol(sA->a[i1]) < code->piv_abs_tol) /* matrix singular */
-	{
-		ret = 4;
 
-#ifdef NOT_USED
-		if (code->SparseDebug > 0)
+		/* backward substitution */
+		for (l = code->nsoldec; l < code->nsol; l += 3)
 		{
-			if (code->SparseDebug == 1 || code->SparseDebug == 5)
+			k = code->sol[l + 2];
+			if (k < 0)
 			{
-				fprintf(debf,"numerically singular in last decomposition "
-						"step  \n");
-				fprintf(debf,"line:  %6d  column:  %6d\n",(int)i,(int)j);
+				*(r + code->sol[l]) *= sA->a[code->sol[l + 1]];
+			}
+			else
+			{
+				*(r + code->sol[l]) -= *(r + code->sol[l + 1]) * sA->a[k];
 			}
 		}
-#endif
+	}
 
-		code->critical_line = i;
-		code->critical_column = j;
-		goto backward;
-		/* goto retour; */
+	/* back permutation */
+	for (k = 0; k < sA->nd; k++)
+	{
+		x[code->isort[k]] = r[k];
 	}
-	sA->a[i1] = 1.0 / sA->a[i1];
-	sA->ja[j1] = -sA->ja[j1] - 1;
 
-	if (tocodedec(code, i1, -1, -1) != 0)
+	return ret;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The function <i>MA_LequSparseCheckPattern</i> checks whether the matrix
+ *  <i>sB</i> has the structure of the matrix the regular code <i>code</i> has
+ *  been generated for.
+ *
+ *  @return
+ *  <ul><li>    0 - same structure
+ *  <li>		3 - structure differs or no valid code available
+ *  </ul>
+ */
+exportMA_Sparse err_code MA_LequSparseCheckPattern(struct sparse* sB,
+		struct spcode* code)
+{
+	count_far i, n;
+
+	n = code->pattern_nd;
+
+	if (n < 1 || code->rank != n || sB->nd != n)
+		return 3;
+
+	/* get correct order of entries in sparse list */
+	MA_SortSparseList(sB);
+
+	if (sB->nel != code->fill_ins)
+		return 3;
+
+	for (i = 0; i <= sB->m; i++)
 	{
-		ret = 2;
-		goto retour;
+		if (sB->ia[i] != code->pattern_ia[i])
+			return 3;
 	}
 
-	if (tocodesol(code, i, i1, -1) != 0)
+	for (i = 0; i < sB->nel; i++)
 	{
-		ret = 2;
-		goto retour;
+		if (sB->ja[i] != code->pattern_ja[i])
+			return 3;
 	}
-	code->rank = n;
 
-	/* ====================== */
-	/* backward decomposition */
-	/* ====================== */
-	backward: code->nsoldec = code->nsol;
+	return 0;
+}
 
-#ifdef NOT_USED
-	if (code->SparseDebug > 0)
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The function <i>MA_LequSparseRefactor</i> decomposes the matrix <i>sB</i>
+ *  without pivotal search, if it has the same structure as the matrix the
+ *  code has been generated for. The values of <i>sB</i> are copied into the
+ *  decomposed matrix <i>sA</i> and the decomposition code is replayed, thus
+ *  pivot order and fill-ins of the code generation are kept. The solution
+ *  code can be used with <i>sA</i> afterwards.
+ *
+ *  A pivot is rejected if it is smaller than <i>piv_abs_tol</i> or if it
+ *  violates the pivot range <i>gener_piv_scope</i> used by the code
+ *  generation. In this case the content of <i>sA</i> is invalid and a new
+ *  code generation is required.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>		3 - structure differs or no valid code available
+ *  <li>		4 - pivot rejected
+ *  </ul>
+ */
+exportMA_Sparse err_code MA_LequSparseRefactor(struct sparse* sA,
+		struct sparse* sB, struct spcode* code)
+{
+	count_far i, k, l, n;
+	value w, schwell;
+
+	n = code->pattern_nd;
+
+	if (sA->nd != n || MA_LequSparseCheckPattern(sB, code) != 0
+			|| sA->nmax < code->fill_ins_after_dec)
+		return 3;
+
+	/* original elements keep their position, fill-ins are appended */
+	for (k = 0; k < sB->nel; k++)
+		sA->a[k] = sB->a[k];
+
+	schwell = 1.0 / code->gener_piv_scope;
+
+	for (l = 0; l < code->ndec; l += 3)
 	{
-		if (code->SparseDebug == 5)
-		{
-			fprintf(debf,"before start backward decomposition  \n");
-			MA_PrintSparse(sA, debf);
-			for (i = 0; i < n; i++)
-			fprintf(debf,"%6d   ip %6d   jp %6d   is %6d   jz %6d   ik %6d \n",
-					(int)i,(int)ip[i],(int)jp[i],(int)is[i],(int)jz[i],
-					(int)ik[i]);
-			fprintf(debf,"n  %d \n",(int)n);
+		i = code->dec[l];
+		k = code->dec[l + 1];
+
+		if (k < 0)
+		{ /* pivot */
+			w = sA->a[i];
+			if (absol(w) < code->piv_abs_tol)
+				return 4;
+			sA->a[i] = 1.0 / w;
+		}
+		else if (code->dec[l + 2] == -1)
+		{ /* division by pivot element */
+			sA->a[i] *= sA->a[k];
+			if (absol(sA->a[i]) > schwell)
+				return 4;
+		}
+		else if (code->dec[l + 2] > -1)
+		{ /* el. in pivot and nonpivot line */
+			sA->a[i] -= sA->a[k] * sA->a[code->dec[l + 2]];
+		}
+		else
+		{ /* new fill in */
+			sA->a[i] = -sA->a[k] * sA->a[-code->dec[l + 2] - 2];
 		}
 	}
-#endif
 
-	/* filling zerodemand in singular case */
-	if (code->rank < n)
+	sA->decomp = 1;
+
+	return 0;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The function <i>MA_LequSparseLower</i> translates the solution code of a
+ *  regular matrix into the flat code <i>flat</i>. The triples of the
+ *  solution code are split into
+ *  <ul><li> the diagonal scaling \f$r_{lz} = r_{lz}\,a_l\f$ of each pivot
+ *  step,
+ *  <li> the L-solve \f$r_{line} = r_{line} - r_{lz}\,a_{ipc}\f$ following
+ *  each pivot step and
+ *  <li> the U-solve \f$r_{line} = r_{line} - \sum r_{src}\,a_{k}\f$ grouped
+ *  by line.
+ *  </ul>
+ *  A run of pivot steps followed by a run of U-groups forms a segment. The
+ *  code of a matrix decomposed as a whole has one segment, the code of the
+ *  block triangular form one per diagonal block (the U-groups contain the
+ *  backward substitution of the block and the coupling of the next block).
+ *  The factors are gathered from the sparse list into contiguous arrays,
+ *  thus <i>MA_LequSparseSolutFlat</i> runs without branches and without
+ *  indirection through the sparse matrix. The order of operations is the
+ *  one of <i>MA_LequSparseSolut</i>, which remains the reference.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  <li>		3 - code can not be lowered (singular matrix)
+ *  </ul>
+ */
+exportMA_Sparse err_code MA_LequSparseLower(struct sparse* sA,
+		struct spcode* code, struct spflat* flat)
+{
+	count_far l, k, n, nl, nu, nug, nseg, line, lz;
+	int steps; /* -1: begin, 1: pivot steps, 0: U-groups */
+
+	MA_FreeFlatCode(flat);
+
+	n = sA->nd;
+	if (n < 1 || code->rank != n || code->sol == NULL)
+		return 3;
+
+	/* count operations - an operation of a pivot step must use the line of
+	 * the pivot and belong to the decomposition part of the code */
+	k = nl = nu = nug = nseg = 0;
+	line = lz = -1;
+	steps = -1;
+	for (l = 0; l < code->nsol; l += 3)
 	{
-		k = n - code->rank;
-		if (code->zerodemand != NULL)
+		if (code->sol[l + 2] < 0)
 		{
-			free(code->zerodemand);
-			code->zerodemand = NULL;
+			if (steps != 1)
+				nseg++;
+			steps = 1;
+			lz = code->sol[l];
+			k++;
 		}
-		code->zerodemand = (count_far *) calloc((unsigned) k,
-				(unsigned) sizeof(count_far));
-		if (code->zerodemand == NULL)
+		else if (steps == 1 && l < code->nsoldec && code->sol[l + 1] == lz)
 		{
-			ret = 2;
-			goto retour;
+			nl++;
+		}
+		else
+		{
+			if (steps == -1)
+				nseg++;
+			if (steps != 0)
+				line = -1;
+			steps = 0;
+
+			nu++;
+			if (code->sol[l] != line)
+			{
+				line = code->sol[l];
+				nug++;
+			}
 		}
+	}
 
-		for (i = 0; i < k; i++)
-			code->zerodemand[i] = ip[i + code->rank];
+	if (k != n)
+		return 3;
 
-#ifdef NOT_USED
-		if (code->SparseDebug > 0)
+	flat->diag_line = (count_far *) calloc((unsigned) n, sizeof(count_far));
+	flat->diag_pos  = (count_far *) calloc((unsigned) n, sizeof(count_far));
+	flat->diag_val  = (value *) calloc((unsigned) n, sizeof(value));
+	flat->l_ptr     = (count_far *) calloc((unsigned) (n + 1), sizeof(count_far));
+	flat->l_line    = (count_far *) calloc((unsigned) (nl + 1), sizeof(count_far));
+	flat->l_pos     = (count_far *) calloc((unsigned) (nl + 1), sizeof(count_far));
+	flat->l_val     = (value *) calloc((unsigned) (nl + 1), sizeof(value));
+	flat->u_line    = (count_far *) calloc((unsigned) (nug + 1), sizeof(count_far));
+	flat->u_ptr     = (count_far *) calloc((unsigned) (nug + 1), sizeof(count_far));
+	flat->u_src     = (count_far *) calloc((unsigned) (nu + 1), sizeof(count_far));
+	flat->u_pos     = (count_far *) calloc((unsigned) (nu + 1), sizeof(count_far));
+	flat->u_val     = (value *) calloc((unsigned) (nu + 1), sizeof(value));
+	flat->isort     = (count_far *) calloc((unsigned) n, sizeof(count_far));
+	flat->seg_step  = (count_far *) calloc((unsigned) (nseg + 1), sizeof(count_far));
+	flat->seg_group = (count_far *) calloc((unsigned) (nseg + 1), sizeof(count_far));
+
+	if (flat->diag_line == NULL || flat->diag_pos == NULL
+			|| flat->diag_val == NULL || flat->l_ptr == NULL
+			|| flat->l_line == NULL || flat->l_pos == NULL
+			|| flat->l_val == NULL || flat->u_line == NULL
+			|| flat->u_ptr == NULL || flat->u_src == NULL
+			|| flat->u_pos == NULL || flat->u_val == NULL
+			|| flat->isort == NULL || flat->seg_step == NULL
+			|| flat->seg_group == NULL)
+	{
+		MA_FreeFlatCode(flat);
+		return 2;
+	}
+
+	/* pivot steps (diagonal scaling followed by L-solve) and U-groups */
+	k = nl = nu = nug = nseg = 0;
+	line = lz = -1;
+	steps = -1;
+	for (l = 0; l < code->nsol; l += 3)
+	{
+		if (code->sol[l + 2] < 0)
 		{
-			if (code->SparseDebug == 5)
+			if (steps != 1)
+			{ /* new segment */
+				flat->seg_step[nseg]  = k;
+				flat->seg_group[nseg] = nug;
+				nseg++;
+			}
+			steps = 1;
+			lz = code->sol[l];
+
+			flat->diag_line[k] = code->sol[l];
+			flat->diag_pos[k]  = code->sol[l + 1];
+			flat->l_ptr[k]     = nl;
+			k++;
+		}
+		else if (steps == 1 && l < code->nsoldec && code->sol[l + 1] == lz)
+		{
+			flat->l_line[nl] = code->sol[l];
+			flat->l_pos[nl]  = code->sol[l + 2];
+			nl++;
+		}
+		else
+		{
+			if (steps == -1)
+			{ /* segment without pivot steps */
+				flat->seg_step[nseg]  = k;
+				flat->seg_group[nseg] = nug;
+				nseg++;
+			}
+			if (steps != 0)
+				line = -1;
+			steps = 0;
+
+			if (code->sol[l] != line)
 			{
-				fprintf(debf, "after decomposition the following positions ");
-				fprintf(debf, "of the solution vector have to be zero  \n");
-				for (i = 0; i < n - code->rank; i++)
-				fprintf(debf, "%6d  ", (int) code->zerodemand[i]);
-				fprintf(debf, " \n");
+				line = code->sol[l];
+				flat->u_line[nug] = line;
+				flat->u_ptr[nug]  = nu;
+				nug++;
 			}
+
+			flat->u_src[nu] = code->sol[l + 1];
+			flat->u_pos[nu] = code->sol[l + 2];
+			nu++;
 		}
-#endif
 	}
+	flat->l_ptr[n] = nl;
+	flat->u_ptr[nug] = nu;
+	flat->seg_step[nseg]  = n;
+	flat->seg_group[nseg] = nug;
+
+	for (k = 0; k < n; k++)
+		flat->isort[k] = code->isort[k];
+
+	flat->n    = n;
+	flat->nl   = nl;
+	flat->nu   = nu;
+	flat->nug  = nug;
+	flat->nseg = nseg;
+
+	MA_LequSparseLowerValues(sA, flat);
+
+	return 0;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+exportMA_Sparse void MA_LequSparseLowerValues(struct sparse* sA,
+		struct spflat* flat)
+{
+	count_far k;
+
+	for (k = 0; k < flat->n; k++)
+		flat->diag_val[k] = sA->a[flat->diag_pos[k]];
+
+	for (k = 0; k < flat->nl; k++)
+		flat->l_val[k] = sA->a[flat->l_pos[k]];
 
-	for (k = n - 2; k > -1; k--)
-	{
-		line = ip[k];
-		/*j = jp[k];  never used ????????*/    /* line steps through lines of matrix */
+	for (k = 0; k < flat->nu; k++)
+		flat->u_val[k] = sA->a[flat->u_pos[k]];
+}
 
-		i4 = sA->ia[line]; /* steps through actual line in sparse list */
-		do
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The function <i>MA_LequSparseSolutFlat</i> solves the linear system with
+ *  the flat code generated by <i>MA_LequSparseLower</i>. The lines modified
+ *  within one L-step and the operations of one U-group are independent,
+ *  thus the inner loops can be vectorized by the compiler.
+ */
+exportMA_Sparse void MA_LequSparseSolutFlat(struct spflat* flat,
+		value* r, value* x)
+{
+	count_far s, k, kend, j, jend;
+	value rp;
+
+	const count_far* diag_line = flat->diag_line;
+	const value*     diag_val  = flat->diag_val;
+	const count_far* l_ptr     = flat->l_ptr;
+	const count_far* l_line    = flat->l_line;
+	const value*     l_val     = flat->l_val;
+	const count_far* u_line    = flat->u_line;
+	const count_far* u_ptr     = flat->u_ptr;
+	const count_far* u_src     = flat->u_src;
+	const value*     u_val     = flat->u_val;
+
+	for (s = 0; s < flat->nseg; s++)
+	{
+		/* diagonal scaling and L-solve */
+		kend = flat->seg_step[s + 1];
+		for (k = flat->seg_step[s]; k < kend; k++)
 		{
-			i6 = sA->ja[i4]; /* column of actual element i4 in line */
-			if (i6 < 0)
-				i6 = -i6 - 1; /* all elements are watched at */
-			for (i3 = k + 1; i3 < n; i3++) /* i3 steps through ready lines */
-			{
-				if (i6 == jp[i3])
-				{	/* test: is ready pivot in column i6 of el. i4? */
-					if (tocodesol(code, line, ip[i3], i4) != 0)
-					{
-						ret = 2;
-						goto retour;
-					}
-				} /* if it is, in line a backward subst. step is done with the
-				 pivot standing on the right hand vector in line ip[i3] */
-			}
-			i4 = sA->fa[i4];
-		} while (i4 > -1);
-	}
+			rp = r[diag_line[k]] * diag_val[k];
+			r[diag_line[k]] = rp;
 
-	for (i = 0; i < n; i++)
-		code->isort[ip[i]] = jp[i]; /* for back permutation
-		 of solution */
+			jend = l_ptr[k + 1];
+			for (j = l_ptr[k]; j < jend; j++)
+				r[l_line[j]] -= rp * l_val[j];
+		}
 
-	code->fill_ins_after_dec = pnew + 1;
+		/* U-solve */
+		kend = flat->seg_group[s + 1];
+		for (k = flat->seg_group[s]; k < kend; k++)
+		{
+			rp = r[u_line[k]];
 
-	code->pivot_flop = 4.9 * pivot_flop;
-	ndec = code->ndec/3;
-	code->dec_flop = 3 * code->rank + code->dec_ma + ndec;
-	code->sol_flop = 2 * code->fill_ins_after_dec - code->rank;
+			jend = u_ptr[k + 1];
+			for (j = u_ptr[k]; j < jend; j++)
+				rp -= r[u_src[j]] * u_val[j];
 
-	/*========================*/
-	/*Actions at the very end */
-	/*========================*/
+			r[u_line[k]] = rp;
+		}
+	}
 
-	retour:
+	/* back permutation */
+	for (k = 0; k < flat->n; k++)
+		x[flat->isort[k]] = r[k];
+}
 
-#ifdef NOT_USED
+/* ////////////////////////////////////////////////////////////////////////// */
 
-	if (code->SparseDebug > 0)
+/**
+ *  The function <i>MA_LequSparseSolutFlatBatch</i> solves the linear system
+ *  for <i>nb</i> righthandsides with the flat code. The vectors are stored
+ *  by lines (element i of vector c at i*nb+c), thus each operation of the
+ *  code is applied to all vectors in the innermost loop. The operations are
+ *  executed in the order of <i>MA_LequSparseSolutFlat</i>, the solution of
+ *  each vector is identical.
+ */
+exportMA_Sparse void MA_LequSparseSolutFlatBatch(struct spflat* flat,
+		value* r, value* x, count_far nb)
+{
+	count_far s, k, kend, j, jend, c;
+	value f;
+	value* rp;
+	value* rl;
+
+	const count_far* diag_line = flat->diag_line;
+	const value*     diag_val  = flat->diag_val;
+	const count_far* l_ptr     = flat->l_ptr;
+	const count_far* l_line    = flat->l_line;
+	const value*     l_val     = flat->l_val;
+	const count_far* u_line    = flat->u_line;
+	const count_far* u_ptr     = flat->u_ptr;
+	const count_far* u_src     = flat->u_src;
+	const value*     u_val     = flat->u_val;
+
+	for (s = 0; s < flat->nseg; s++)
 	{
-		if (code->SparseDebug == 2 || code->SparseDebug == 5)
+		/* diagonal scaling and L-solve */
+		kend = flat->seg_step[s + 1];
+		for (k = flat->seg_step[s]; k < kend; k++)
 		{
-			fprintf(debf,"matrix at the end of decomposition \n");
-			MA_PrintSparse(sA, debf);
-			for (i = 0; i < n; i++)
-			fprintf(debf,"%6d   ip %6d   jp %6d   is %6d   jz %6d   ik %6d \n",
-					(int)i,(int)ip[i],(int)jp[i],(int)is[i],(int)jz[i],
-					(int)ik[i]);
+			rp = r + diag_line[k] * nb;
+			f = diag_val[k];
+			for (c = 0; c < nb; c++)
+				rp[c] *= f;
 
-			fprintf(debf,"decomposition code \n");
-			for (i = 0; i < code->ndec; i +=3)
+			jend = l_ptr[k + 1];
+			for (j = l_ptr[k]; j < jend; j++)
 			{
-				fprintf(debf," %8d %8d %8d \n",
-						(int)code->dec[i], (int)code->dec[i+1],
-						(int)code->dec[i+2]);
+				rl = r + l_line[j] * nb;
+				f = l_val[j];
+				for (c = 0; c < nb; c++)
+					rl[c] -= rp[c] * f;
 			}
+		}
 
-			fprintf(debf,"solution code \n");
-			for (i = 0; i < code->nsol; i +=3)
-			{	fprintf(debf," %8d %8d %8d \n",
-						(int)code->sol[i], (int)code->sol[i+1],
-						(int)code->sol[i+2]);
-			}
+		/* U-solve */
+		kend = flat->seg_group[s + 1];
+		for (k = flat->seg_group[s]; k < kend; k++)
+		{
+			rl = r + u_line[k] * nb;
 
-			fprintf(debf,"vector for back permutation of solution \n");
-			for (i = 0; i < n; i++)
+			jend = u_ptr[k + 1];
+			for (j = u_ptr[k]; j < jend; j++)
 			{
-				fprintf(debf," %8d %8d %8d ", (int)code->sol[i],
-						(int)code->sol[i+1], (int)code->sol[i+2]);
+				rp = r + u_src[j] * nb;
+				f = u_val[j];
+				for (c = 0; c < nb; c++)
+					rl[c] -= rp[c] * f;
 			}
-			fprintf(debf,"\n end of lequsparse_codegen \n\n");
-
 		}
 	}
 
-#endif
+	/* back permutation */
+	for (k = 0; k < flat->n; k++)
+	{
+		rp = r + k * nb;
+		rl = x + flat->isort[k] * nb;
+		for (c = 0; c < nb; c++)
+			rl[c] = rp[c];
+	}
+}
 
-	if(ip!=NULL) free(ip);
-	if(jp!=NULL) free(jp);
-	if(jz!=NULL) free(jz);
-	if(ik!=NULL) free(ik);
-	if(is!=NULL) free(is);
+/* ////////////////////////////////////////////////////////////////////////// */
 
-	ip = NULL;
-	jp = NULL;
-	jz = NULL;
-	ik = NULL;
-	is = NULL;
+/**
+ *  The function <i>MA_LequSparseRefactorComplex</i> decomposes a complex
+ *  matrix by replaying the decomposition code of a real matrix with the same
+ *  structure, e.g. the matrix of the magnitudes of the complex entries. The
+ *  complex values are stored interleaved (real part, imaginary part), which
+ *  is the memory layout of <i>std::complex<double></i>.
+ *  <i>ca</i> contains the values of the sorted sparse list of the matrix the
+ *  code has been generated for, <i>lu</i> gets the decomposed matrix with
+ *  <i>code->fill_ins_after_dec</i> complex elements.
+ *
+ *  The pivots are checked as in <i>MA_LequSparseRefactor</i>, thus the
+ *  pivot order chosen for the real matrix is rejected, if it is not stable
+ *  for the complex values.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>		3 - no valid code of a regular matrix available
+ *  <li>		4 - pivot rejected
+ *  </ul>
+ */
+exportMA_Sparse err_code MA_LequSparseRefactorComplex(value* ca, value* lu,
+		struct spcode* code)
+{
+	count_far i, k, j, l, n;
+	value wr, wi, w, schwell;
 
-	return ret;
+	n = code->pattern_nd;
+
+	if (n < 1 || code->rank != n)
+		return 3;
+
+	/* original elements keep their position, fill-ins are appended */
+	for (k = 0; k < 2 * code->fill_ins; k++)
+		lu[k] = ca[k];
+
+	schwell = 1.0 / code->gener_piv_scope;
+
+	for (l = 0; l < code->ndec; l += 3)
+	{
+		i = 2 * code->dec[l];
+		k = 2 * code->dec[l + 1];
+
+		if (code->dec[l + 1] < 0)
+		{ /* pivot */
+			wr = lu[i];
+			wi = lu[i + 1];
+			w = wr * wr + wi * wi;
+			if (w < code->piv_abs_tol * code->piv_abs_tol)
+				return 4;
+			lu[i] = wr / w;
+			lu[i + 1] = -wi / w;
+		}
+		else if (code->dec[l + 2] == -1)
+		{ /* division by pivot element */
+			wr = lu[i] * lu[k] - lu[i + 1] * lu[k + 1];
+			wi = lu[i] * lu[k + 1] + lu[i + 1] * lu[k];
+			lu[i] = wr;
+			lu[i + 1] = wi;
+			if (wr * wr + wi * wi > schwell * schwell)
+				return 4;
+		}
+		else if (code->dec[l + 2] > -1)
+		{ /* el. in pivot and nonpivot line */
+			j = 2 * code->dec[l + 2];
+			lu[i] -= lu[k] * lu[j] - lu[k + 1] * lu[j + 1];
+			lu[i + 1] -= lu[k] * lu[j + 1] + lu[k + 1] * lu[j];
+		}
+		else
+		{ /* new fill in */
+			j = 2 * (-code->dec[l + 2] - 2);
+			lu[i] = -(lu[k] * lu[j] - lu[k + 1] * lu[j + 1]);
+			lu[i + 1] = -(lu[k] * lu[j + 1] + lu[k + 1] * lu[j]);
+		}
+	}
+
+	return 0;
 }
 
 /* ////////////////////////////////////////////////////////////////////////// */
 
 /**
- * @return
+ *  The function <i>MA_LequSparseSolutComplex</i> solves the complex linear
+ *  system decomposed by <i>MA_LequSparseRefactorComplex</i> with the
+ *  solution code. <i>r</i> (destroyed) and <i>x</i> are complex vectors
+ *  stored interleaved.
+ *
+ *  @return
  *  <ul><li>    0 - okay
- *  <li>		5 - zero demand not satisfied
+ *  <li>		3 - no valid code of a regular matrix available
  *  </ul>
  */
-exportMA_Sparse err_code MA_LequSparseSolut(struct sparse* sA,
-		struct spcode* code,value* r,value* x)
+exportMA_Sparse err_code MA_LequSparseSolutComplex(value* lu,
+		struct spcode* code, value* r, value* x)
 {
-	count_far k, l;
-	err_code ret;
-
-	/* printf("\n in Solut:  rank  %d   nsol  %d   nsoldec  %d\n",
-	 (int)code->rank, (int)code->nsol, (int)code->nsoldec); */
+	count_far i, j, k, l;
+	value wr, wi;
 
-	ret = 0;
+	if (code->pattern_nd < 1 || code->rank != code->pattern_nd)
+		return 3;
 
-	if (code->rank == sA->nd)
-	{ /* solution in regular case, decomposition and backward subst. together */
-		for (l = 0; l < code->nsol; l += 3)
+	for (l = 0; l < code->nsol; l += 3)
+	{
+		i = 2 * code->sol[l];
+		if (code->sol[l + 2] < 0)
 		{
-			k = code->sol[l + 2];
-			if (k < 0)
-			{
-				*(r + code->sol[l]) *= sA->a[code->sol[l + 1]];
-
-			/*	 printf(" rl = %e  a=%e \n",
-				 (double)(*(r + code->sol[l])),
-				 (double)(sA->a[ code->sol[l+1] ])); */
-			}
-			else
-			{
-				*(r + code->sol[l]) -= *(r + code->sol[l + 1]) * sA->a[k];
-			/*	 printf(" rl = %e  rl+1=%e  a=%e \n", *(r + code->sol[l]),
-				 *(r + code->sol[l+1]), sA->a[ k ]); */
-			}
+			k = 2 * code->sol[l + 1];
+			wr = r[i] * lu[k] - r[i + 1] * lu[k + 1];
+			wi = r[i] * lu[k + 1] + r[i + 1] * lu[k];
+			r[i] = wr;
+			r[i + 1] = wi;
 		}
-	}
-	else
-	{ /* singular case */
-		for (l = 0; l < code->nsoldec; l += 3) /* decomposition */
+		else
 		{
-			k = code->sol[l + 2];
-			if (k < 0)
-			{
-				*(r + code->sol[l]) *= sA->a[code->sol[l + 1]];
-			}
-			else
-			{
-				*(r + code->sol[l]) -= *(r + code->sol[l + 1]) * sA->a[k];
-			}
+			j = 2 * code->sol[l + 1];
+			k = 2 * code->sol[l + 2];
+			r[i] -= r[j] * lu[k] - r[j + 1] * lu[k + 1];
+			r[i + 1] -= r[j] * lu[k + 1] + r[j + 1] * lu[k];
 		}
+	}
 
-		for (l = 0; l < sA->nd - code->rank; l++)
+	/* back permutation */
+	for (k = 0; k < code->pattern_nd; k++)
+	{
+		x[2 * code->isort[k]] = r[2 * k];
+		x[2 * code->isort[k] + 1] = r[2 * k + 1];
+	}
+
+	return 0;
+}
+
+/**
+ *  The function <i>MA_LequSparseSolutComplexMulti</i> solves the complex
+ *  linear system decomposed by <i>MA_LequSparseRefactorComplex</i> for
+ *  <i>nrhs</i> right-hand sides in one pass over the solution code. The
+ *  vectors are stored by lines, the real part of line <i>i</i> of the
+ *  right-hand side <i>m</i> is <i>r[2*(i*nrhs+m)]</i>, the imaginary part
+ *  follows. <i>r</i> is destroyed. The result of each right-hand side is
+ *  identical to the result of <i>MA_LequSparseSolutComplex</i>.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>		3 - no valid code of a regular matrix available
+ *  </ul>
+ */
+exportMA_Sparse err_code MA_LequSparseSolutComplexMulti(value* lu,
+		struct spcode* code, count_far nrhs, value* r, value* x)
+{
+	count_far i, j, k, l, m;
+	value wr, wi, lr, li;
+
+	if (code->pattern_nd < 1 || code->rank != code->pattern_nd)
+		return 3;
+
+	for (l = 0; l < code->nsol; l += 3)
+	{
+		i = 2 * nrhs * code->sol[l];
+		if (code->sol[l + 2] < 0)
 		{
-			if (r[code->zerodemand[l]] > code->piv_abs_tol
-					|| r[code->zerodemand[l]] < -code->piv_abs_tol)
+			k = 2 * code->sol[l + 1];
+			lr = lu[k];
+			li = lu[k + 1];
+			for (m = 0; m < 2 * nrhs; m += 2)
 			{
-				ret = 5;
-			    code->critical_line=code->isort[l];
+				wr = r[i + m] * lr - r[i + m + 1] * li;
+				wi = r[i + m] * li + r[i + m + 1] * lr;
+				r[i + m] = wr;
+				r[i + m + 1] = wi;
 			}
 		}
-
-		/* backward substitution */
-		for (l = code->nsoldec; l < code->nsol; l += 3)
+		else
 		{
-			k = code->sol[l + 2];
-			if (k < 0)
-			{
-				*(r + code->sol[l]) *= sA->a[code->sol[l + 1]];
-			}
-			else
+			j = 2 * nrhs * code->sol[l + 1];
+			k = 2 * code->sol[l + 2];
+			lr = lu[k];
+			li = lu[k + 1];
+			for (m = 0; m < 2 * nrhs; m += 2)
 			{
-				*(r + code->sol[l]) -= *(r + code->sol[l + 1]) * sA->a[k];
+				r[i + m] -= r[j + m] * lr - r[j + m + 1] * li;
+				r[i + m + 1] -= r[j + m] * li + r[j + m + 1] * lr;
 			}
 		}
 	}
 
 	/* back permutation */
+	for (k = 0; k < code->pattern_nd; k++)
+	{
+		i = 2 * nrhs * k;
+		j = 2 * nrhs * code->isort[k];
+		for (m = 0; m < 2 * nrhs; m++)
+			x[j + m] = r[i + m];
+	}
+
+	return 0;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The function <i>MA_LequSparseSolutTrans</i> solves the transposed linear
+ *  system \f$A^T x = r\f$ of a regular matrix with the solution code of
+ *  \f$A\f$. The solution code represents \f$A^{-1}\f$ as product of
+ *  elementary operations followed by a permutation, thus the transposed
+ *  operations are applied in reverse order after the inverse permutation.
+ *  <i>r</i> is not changed.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>		3 - no valid code of a regular matrix available
+ *  </ul>
+ */
+exportMA_Sparse err_code MA_LequSparseSolutTrans(struct sparse* sA,
+		struct spcode* code, value* r, value* x)
+{
+	count_far k, l;
+
+	if (code->rank != sA->nd || code->rank < 1)
+		return 3;
+
 	for (k = 0; k < sA->nd; k++)
+		x[k] = r[code->isort[k]];
+
+	for (l = code->nsol - 3; l >= 0; l -= 3)
 	{
-		x[code->isort[k]] = r[k];
+		k = code->sol[l + 2];
+		if (k < 0)
+		{
+			x[code->sol[l]] *= sA->a[code->sol[l + 1]];
+		}
+		else
+		{
+			x[code->sol[l + 1]] -= x[code->sol[l]] * sA->a[k];
+		}
 	}
 
-	return ret;
+	return 0;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The function <i>MA_LequSparseSolutComplexTrans</i> solves the transposed
+ *  (not conjugated) complex linear system \f$A^T x = r\f$ decomposed by
+ *  <i>MA_LequSparseRefactorComplex</i>, see <i>MA_LequSparseSolutTrans</i>.
+ *  <i>r</i> is not changed.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>		3 - no valid code of a regular matrix available
+ *  </ul>
+ */
+exportMA_Sparse err_code MA_LequSparseSolutComplexTrans(value* lu,
+		struct spcode* code, value* r, value* x)
+{
+	count_far i, j, k, l;
+	value wr, wi;
+
+	if (code->pattern_nd < 1 || code->rank != code->pattern_nd)
+		return 3;
+
+	for (k = 0; k < code->pattern_nd; k++)
+	{
+		x[2 * k] = r[2 * code->isort[k]];
+		x[2 * k + 1] = r[2 * code->isort[k] + 1];
+	}
+
+	for (l = code->nsol - 3; l >= 0; l -= 3)
+	{
+		i = 2 * code->sol[l];
+		if (code->sol[l + 2] < 0)
+		{
+			k = 2 * code->sol[l + 1];
+			wr = x[i] * lu[k] - x[i + 1] * lu[k + 1];
+			wi = x[i] * lu[k + 1] + x[i + 1] * lu[k];
+			x[i] = wr;
+			x[i + 1] = wi;
+		}
+		else
+		{
+			j = 2 * code->sol[l + 1];
+			k = 2 * code->sol[l + 2];
+			x[j] -= x[i] * lu[k] - x[i + 1] * lu[k + 1];
+			x[j + 1] -= x[i] * lu[k + 1] + x[i + 1] * lu[k];
+		}
+	}
+
+	return 0;
 }
 
+/* ////////////////////////////////////////////////////////////////////////// */
+
 /* /// end of file ////////////////////////////////////////////////////////// */
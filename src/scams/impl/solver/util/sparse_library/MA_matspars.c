@@ -102,6 +102,11 @@ exportMA_Sparse void MA_InitSparse(struct sparse* sA)
 	sA->sparse_list_ordered = 0;
 	sA->full   = 0;
 	sA->decomp = 0;
+
+	sA->nslot    = 0;
+	sA->slot     = NULL;
+	sA->slotline = NULL;
+	sA->slottail = NULL;
 }
 
 /* ////////////////////////////////////////////////////////////////////////// */
@@ -139,6 +144,35 @@ exportMA_Sparse void MA_FreeSparse(struct sparse* sA)
 
 	sA->full = 0;
 	sA->decomp = 0;
+
+	MA_FreeSlotMap(sA);
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+exportMA_Sparse void MA_FreeSlotMap(struct sparse* sA)
+{
+	if(sA==NULL) return;
+
+	sA->nslot = 0;
+
+	if (sA->slot != NULL)
+	{
+		free( sA->slot);
+		sA->slot = NULL;
+	}
+
+	if (sA->slotline != NULL)
+	{
+		free( sA->slotline);
+		sA->slotline = NULL;
+	}
+
+	if (sA->slottail != NULL)
+	{
+		free( sA->slottail);
+		sA->slottail = NULL;
+	}
 }
 
 /* ////////////////////////////////////////////////////////////////////////// */
@@ -235,12 +269,199 @@ exportMA_Sparse err_code MA_ProductSparseVector(struct sparse* sA,value* pb,
 
 /* ////////////////////////////////////////////////////////////////////////// */
 
+/* minimal number of elements of a line for the unrolled product */
+#define MA_ROW_UNROLL_MIN 8
+
+/**
+ *  computes the product of line <i>li</i> of \f$A\f$ with \f$pb\f$. The
+ *  lines of an ordered sparse list are stored contiguously, long lines are
+ *  summed up with four independent partial sums, which can be vectorized.
+ */
+static value MA_ProductSparseLine(const struct sparse* sA, count_near li,
+		const value* pb)
+{
+	count_far k, kend;
+	value s0, s1, s2, s3;
+	const value* a = sA->a;
+	const count_near* ja = sA->ja;
+
+	k = sA->ia[li];
+	if (k == sA->ia[li+1] || k == -1)
+		return 0.0;
+
+	s0 = 0.0;
+
+	if (sA->sparse_list_ordered)
+	{
+		kend = sA->ia[li+1];
+
+		if (kend - k >= MA_ROW_UNROLL_MIN)
+		{
+			s1 = s2 = s3 = 0.0;
+			for (; k + 3 < kend; k += 4)
+			{
+				s0 += a[k]   * pb[ja[k]];
+				s1 += a[k+1] * pb[ja[k+1]];
+				s2 += a[k+2] * pb[ja[k+2]];
+				s3 += a[k+3] * pb[ja[k+3]];
+			}
+			s0 = (s0 + s1) + (s2 + s3);
+		}
+
+		for (; k < kend; k++)
+			s0 += a[k] * pb[ja[k]];
+
+		return s0;
+	}
+
+	while (k != -1)
+	{
+		s0 += a[k] * pb[ja[k]];
+		k = sA->fa[k];
+	}
+
+	return s0;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The function <i>MA_ResidualSparseVector</i> computes
+ *  \f$pr = A\,pa + vb\,B\,pb - pq\f$ (or \f$pr = A\,pa - pq\f$ if
+ *  <i>sB</i> is NULL) line by line, thus each element of \f$pr\f$ is
+ *  written once and no temporary vector is required. The lines are
+ *  evaluated in the order of <i>MA_ProductSparseVector</i>, for lines with
+ *  less than MA_ROW_UNROLL_MIN elements the result is identical.
+ *
+ * @return
+ *  <ul><li>    0 - okay
+ *  <li>		3 - dimension erroneous
+ *  </ul>
+ */
+exportMA_Sparse err_code MA_ResidualSparseVector(struct sparse* sA, value* pa,
+		struct sparse* sB, value vb, value* pb, value* pq, value* pr)
+{
+	count_near li;
+
+	/*----------------------- exceptions  -----------------------------*/
+
+	if (sA->nd < 1 || sA->nmax < 1)
+		return 3;
+
+	if (sB != NULL && (sB->nd < 1 || sB->nmax < 1 || sB->m != sA->m))
+		return 3;
+
+	/*----------------------- residual --------------------------------*/
+
+	if (sB == NULL)
+	{
+		for (li = 0; li < sA->m; li++)
+			pr[li] = MA_ProductSparseLine(sA, li, pa) - pq[li];
+	}
+	else
+	{
+		for (li = 0; li < sA->m; li++)
+		{
+			pr[li] = MA_ProductSparseLine(sA, li, pa) +
+					(vb * MA_ProductSparseLine(sB, li, pb) - pq[li]);
+		}
+	}
+
+	return 0;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  adds \f$f\f$ times the products of line <i>li</i> of \f$A\f$ with
+ *  <i>nb</i> vectors stored by lines to <i>prl</i>, the innermost loop runs
+ *  over the vectors and can be vectorized
+ */
+static void MA_AddProductSparseLineBatch(const struct sparse* sA,
+		count_near li, value f, const value* pb, value* prl, count_far nb)
+{
+	count_far k, kend, c;
+	value fa;
+	const value* pbk;
+
+	k = sA->ia[li];
+	if (k == -1)
+		return;
+
+	kend = sA->sparse_list_ordered ? sA->ia[li+1] : -1;
+
+	while (k != kend && k != -1)
+	{
+		fa = f * sA->a[k];
+		pbk = pb + (count_far)sA->ja[k] * nb;
+
+		for (c = 0; c < nb; c++)
+			prl[c] += fa * pbk[c];
+
+		k = sA->sparse_list_ordered ? k + 1 : sA->fa[k];
+	}
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/**
+ *  The function <i>MA_ResidualSparseBatch</i> computes
+ *  \f$pr = A\,pa + vb\,B\,pb - pq\f$ (or \f$pr = A\,pa - pq\f$ if
+ *  <i>sB</i> is NULL) for <i>nb</i> vectors, which are stored by lines
+ *  (element i of vector c at i*nb+c). Each element of the matrices is
+ *  loaded once for all vectors.
+ *
+ * @return
+ *  <ul><li>    0 - okay
+ *  <li>		3 - dimension erroneous
+ *  </ul>
+ */
+exportMA_Sparse err_code MA_ResidualSparseBatch(struct sparse* sA, value* pa,
+		struct sparse* sB, value vb, value* pb, value* pq, value* pr,
+		count_far nb)
+{
+	count_near li;
+	count_far c;
+	value* prl;
+	const value* pql;
+
+	/*----------------------- exceptions  -----------------------------*/
+
+	if (sA->nd < 1 || sA->nmax < 1 || nb < 1)
+		return 3;
+
+	if (sB != NULL && (sB->nd < 1 || sB->nmax < 1 || sB->m != sA->m))
+		return 3;
+
+	/*----------------------- residual --------------------------------*/
+
+	for (li = 0; li < sA->m; li++)
+	{
+		prl = pr + (count_far)li * nb;
+		pql = pq + (count_far)li * nb;
+
+		for (c = 0; c < nb; c++)
+			prl[c] = -pql[c];
+
+		MA_AddProductSparseLineBatch(sA, li, 1.0, pa, prl, nb);
+
+		if (sB != NULL)
+			MA_AddProductSparseLineBatch(sB, li, vb, pb, prl, nb);
+	}
+
+	return 0;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
 void MA_SortSparseColumms(struct sparse *sA)
 {
 	count_near i, j_min;
 	count_far k, k0, ind_min=0;
 	value a_min=0;
 
+	MA_FreeSlotMap(sA); /* elements are permuted */
+
 	for (i = 0; i < sA->m; ++i)
 	{
 		k = sA->ia[i];
@@ -331,6 +552,15 @@ exportMA_Sparse void MA_InitCode(struct spcode* code)
 
 	code->fill_ins = 0;
 	code->fill_ins_after_dec = 0;
+
+	code->pattern_nd = 0;
+	code->pattern_ia = NULL;
+	code->pattern_ja = NULL;
+
+	code->ordering = 0;
+	code->order = NULL;
+	code->nblocks = 0;
+	code->nsingle = 0;
 }
 
 /* ////////////////////////////////////////////////////////////////////////// */
@@ -364,8 +594,77 @@ exportMA_Sparse void MA_FreeCode(struct spcode  *code)
 		free( code->zerodemand);
 		code->zerodemand = NULL;
 	}
+
+	code->pattern_nd = 0;
+
+	if (code->pattern_ia != NULL)
+	{
+		free( code->pattern_ia);
+		code->pattern_ia = NULL;
+	}
+
+	if (code->pattern_ja != NULL)
+	{
+		free( code->pattern_ja);
+		code->pattern_ja = NULL;
+	}
+
+	if (code->order != NULL)
+	{
+		free( code->order);
+		code->order = NULL;
+	}
 }
 
 
+/* ////////////////////////////////////////////////////////////////////////// */
+
+exportMA_Sparse void MA_InitFlatCode(struct spflat* flat)
+{
+	if(flat==NULL) return;
+
+	flat->n = flat->nl = flat->nu = flat->nug = flat->nseg = 0;
+	flat->seg_step  = NULL;
+	flat->seg_group = NULL;
+	flat->diag_line = NULL;
+	flat->diag_pos  = NULL;
+	flat->diag_val  = NULL;
+	flat->l_ptr     = NULL;
+	flat->l_line    = NULL;
+	flat->l_pos     = NULL;
+	flat->l_val     = NULL;
+	flat->u_line    = NULL;
+	flat->u_ptr     = NULL;
+	flat->u_src     = NULL;
+	flat->u_pos     = NULL;
+	flat->u_val     = NULL;
+	flat->isort     = NULL;
+}
+
+/* ////////////////////////////////////////////////////////////////////////// */
+
+exportMA_Sparse void MA_FreeFlatCode(struct spflat* flat)
+{
+	if(flat==NULL) return;
+
+	if (flat->diag_line != NULL) free(flat->diag_line);
+	if (flat->diag_pos  != NULL) free(flat->diag_pos);
+	if (flat->diag_val  != NULL) free(flat->diag_val);
+	if (flat->l_ptr     != NULL) free(flat->l_ptr);
+	if (flat->l_line    != NULL) free(flat->l_line);
+	if (flat->l_pos     != NULL) free(flat->l_pos);
+	if (flat->l_val     != NULL) free(flat->l_val);
+	if (flat->u_line    != NULL) free(flat->u_line);
+	if (flat->u_ptr     != NULL) free(flat->u_ptr);
+	if (flat->u_src     != NULL) free(flat->u_src);
+	if (flat->u_pos     != NULL) free(flat->u_pos);
+	if (flat->u_val     != NULL) free(flat->u_val);
+	if (flat->isort     != NULL) free(flat->isort);
+	if (flat->seg_step  != NULL) free(flat->seg_step);
+	if (flat->seg_group != NULL) free(flat->seg_group);
+
+	MA_InitFlatCode(flat);
+}
+
 
 /* /// end of file ////////////////////////////////////////////////////////// */
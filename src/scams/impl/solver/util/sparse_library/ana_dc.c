@@ -0,0 +1,158 @@
+/*****************************************************************************
+
+    Copyright 2010
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+ ana_dc.c - description
+
+ Original Author: Karsten Einwich Fraunhofer IIS/EAS Dresden
+
+ Created on: 22.10.2009
+
+ *****************************************************************************/
+
+/**
+ * @file 	ana_dc.c
+ * @brief	Source-file to define method <i>ana_solve_dc</i>
+ *
+ * The DC operating point of \f$A\,\dot{x} + B\,x + q = 0\f$ is the solution
+ * of \f$B\,x = -q\f$ (capacitors open, inductors shorted). If \f$B\f$ is
+ * singular (e.g. nodes connected by capacitors only), the operating point
+ * can be approached by Euler backward steps with a large pseudo step size
+ * \f$h\f$, which keep the undetermined states.
+ *
+ * The matrices and the code of the DC solution are temporary, thus the
+ * factorizations of the time domain methods and the factorization cache
+ * remain unchanged.
+ */
+
+/*****************************************************************************/
+
+
+#include "ana_solv_data.h"
+#include "ma_typedef.h"
+#include "ma_util.h"
+#include "ma_sparse.h"
+#include "linear_analog_solver.h"
+#include <stdlib.h>
+
+/****************************************/
+
+/**
+ * The method <i>ana_solve_dc</i> solves for <i>h</i> <= 0 the DC equation
+ * system
+ * \f[
+ * B\,x = -q
+ * \f]
+ * and for <i>h</i> > 0 the Euler backward step
+ * \f[
+ * \left(\frac{1}{h}\,A + B\right)x = \frac{1}{h}\,A\,x_{last} - q
+ * \f]
+ * with \f$x_{last}\f$ the given vector <i>x</i>. The vector <i>x</i> is only
+ * overwritten, if the solution succeeds. The derivative <i>sdata->xp</i> is
+ * not changed. In case of a singular matrix the position is stored for
+ * <i>ana_get_error_position</i>.
+ *
+ * @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  <li>		3 - dimension erroneous
+ *  <li>		4 - matrix singular
+ *  <li>		6 - no sparse matrix
+ *  </ul>
+ */
+int ana_solve_dc (
+		  sparse_matrix* sA,
+          sparse_matrix* sB,
+          double  h,
+          double* q,
+          double* x,
+          sca_solv_data* sdata
+          )
+{
+	struct sparse sW, sZ;
+	struct spcode code;
+	double* r;
+	unsigned long i, size;
+	int err=0;
+
+	if ((sA == NULL) || (sB == NULL))
+		return 6;
+
+	size = sB->m;
+	if (size != (unsigned long)sA->m)
+		return 3;
+
+	if (size == 0)
+		return 0;
+
+	r = (double *)calloc(size,(unsigned)sizeof(double));
+	if (r == NULL)
+		return 2;
+
+	MA_InitSparse(&sW);
+	MA_InitSparse(&sZ);
+	MA_InitCode(&code);
+
+	if (sdata != NULL)
+	{
+		code.ordering = sdata->ordering;
+		sdata->critical_column = -1;
+		sdata->critical_row    = -1;
+	}
+
+	if (h > 0.0)
+	{
+		/* Z = A/h + B, r = A/h*x_last - q */
+		err = MA_GenerateProductValueSparse(&sW, sA, 1.0/h);
+		if (!err)
+			err = MA_GenerateSumMatrixWeighted(&sZ, 1.0, &sW, 1.0, sB);
+		if (!err)
+			err = MA_ResidualSparseVector(&sW, x, NULL, 0.0, NULL, q, r);
+	}
+	else
+	{
+		/* Z = B, r = -q */
+		err = MA_CopySparse(&sZ, sB);
+		for (i = 0; i < size; i++)
+			r[i] = -q[i];
+	}
+
+	if (!err)
+	{
+		err = MA_LequSparseCodegen(&sZ, &code);
+		if (err && (sdata != NULL))
+		{
+			sdata->critical_column = code.critical_column;
+			sdata->critical_row    = code.critical_line;
+		}
+	}
+
+	/* the code of a singular matrix is not used */
+	if (!err)
+		err = MA_LequSparseSolut(&sZ, &code, r, x);
+
+	MA_FreeCode(&code);
+	MA_FreeSparse(&sZ);
+	MA_FreeSparse(&sW);
+	free(r);
+
+	return err;
+}
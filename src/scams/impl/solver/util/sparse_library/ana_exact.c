@@ -0,0 +1,731 @@
+/*****************************************************************************
+
+    Copyright 2010
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+ ana_exact.c - description
+
+ Original Author: Karsten Einwich Fraunhofer IIS/EAS Dresden
+
+ Created on: 22.10.2009
+
+ *****************************************************************************/
+
+/**
+ * @file 	ana_exact.c
+ * @brief	Source-file to define methods <i>ana_init_exact_sparse</i>,
+ * <i>ana_init_exact</i>, <i>ana_solve_exact</i> and <i>ana_free_exact</i>
+ *
+ * For small systems \f$A\,\dot{x} + B\,x + q(t) = 0\f$ with constant matrices
+ * and a constant step size \f$h\f$ the trapezoidal method can be replaced by
+ * the exact solution for a linear interpolated \f$q\f$ (first order hold).
+ * The system is split into the differential variables \f$x_d\f$ (columns of
+ * \f$A\f$ with non-zero entries) and the algebraic variables \f$x_a\f$. For an
+ * index-1 system this leads to
+ * \f[
+ * \dot{x}_d = M\,x_d + N\,q, \quad x_a = -(K\,x_d + L\,q)
+ * \f]
+ * and the exact discretization
+ * \f[
+ * x_{d,k+1} = \Phi\,x_{d,k} + G_0\,q_k + G_1\,q_{k+1}, \quad \Phi = e^{M h}
+ * \f]
+ * \f$\Phi\f$, \f$G_0\f$ and \f$G_1\f$ are the blocks of the exponential of an
+ * augmented matrix. The derivative <i>sdata->xp</i> is kept consistent to
+ * \f$A\,\dot{x} + B\,x + q = 0\f$, thus \f$q_k\f$ is obtained from the last
+ * solution and check points or a switch back to the trapezoidal method
+ * require no additional data.
+ */
+
+/*****************************************************************************/
+
+
+#include "ana_solv_data.h"
+#include "ma_typedef.h"
+#include "ma_util.h"
+#include "ma_sparse.h"
+#include "linear_analog_solver.h"
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* maximum number of equations for the exact discretization */
+#define SCA_EXACT_MAX_SIZE 64
+
+/* number of steps with the same step size before the coefficients are
+ * computed - for varying step sizes the trapezoidal method is used */
+#define SCA_EXACT_MIN_STEPS 4
+
+/****************************************/
+
+/* converts sparse matrix to full matrix F by lines */
+static void ana_exact_sparse_to_full(sparse_matrix* sA, unsigned long n, double* F)
+{
+	count_far li,k;
+
+	memset(F,0,n*n*sizeof(double));
+
+	if (sA->nd < 1 || sA->nmax < 1) return;
+
+	for (li = 0; li < sA->m && li < (count_far)n; li++)
+	{
+		k = sA->ia[li];
+		if (!(k == sA->ia[li+1] || k == -1))
+		{
+			while (k != -1)
+			{
+				F[li*n+sA->ja[k]] = sA->a[k];
+				k = sA->fa[k];
+			}
+		}
+	}
+}
+
+/****************************************/
+
+/* LU decomposition with partial pivoting of the n x n matrix a by lines,
+ * returns 4 if the matrix is singular */
+static int ana_exact_lu(double* a, long n, long* piv)
+{
+	long i,j,k,p;
+	double amax,tmp;
+
+	for(k=0;k<n;k++)
+	{
+		p=k;
+		amax=fabs(a[k*n+k]);
+		for(i=k+1;i<n;i++)
+		{
+			if(fabs(a[i*n+k])>amax)
+			{
+				amax=fabs(a[i*n+k]);
+				p=i;
+			}
+		}
+
+		if(amax<1e-300) return 4;
+
+		piv[k]=p;
+		if(p!=k)
+		{
+			for(j=0;j<n;j++)
+			{
+				tmp=a[k*n+j];
+				a[k*n+j]=a[p*n+j];
+				a[p*n+j]=tmp;
+			}
+		}
+
+		for(i=k+1;i<n;i++)
+		{
+			a[i*n+k]/=a[k*n+k];
+			for(j=k+1;j<n;j++) a[i*n+j]-=a[i*n+k]*a[k*n+j];
+		}
+	}
+
+	return 0;
+}
+
+/* solves a x = b for the m columns of b (n x m by lines), b is overwritten */
+static void ana_exact_lu_solve(double* a, long n, long* piv, double* b, long m)
+{
+	long i,j,k;
+	double tmp;
+
+	for(k=0;k<n;k++)
+	{
+		if(piv[k]!=k)
+		{
+			for(j=0;j<m;j++)
+			{
+				tmp=b[k*m+j];
+				b[k*m+j]=b[piv[k]*m+j];
+				b[piv[k]*m+j]=tmp;
+			}
+		}
+	}
+
+	for(i=1;i<n;i++)
+		for(k=0;k<i;k++)
+			for(j=0;j<m;j++) b[i*m+j]-=a[i*n+k]*b[k*m+j];
+
+	for(i=n-1;i>=0;i--)
+	{
+		for(k=i+1;k<n;k++)
+			for(j=0;j<m;j++) b[i*m+j]-=a[i*n+k]*b[k*m+j];
+
+		for(j=0;j<m;j++) b[i*m+j]/=a[i*n+i];
+	}
+}
+
+/****************************************/
+
+/* C = A * B for n x n matrices by lines */
+static void ana_exact_mult(double* A, double* B, double* C, long n)
+{
+	long i,j,k;
+	double a;
+
+	memset(C,0,n*n*sizeof(double));
+	for(i=0;i<n;i++)
+	{
+		for(k=0;k<n;k++)
+		{
+			a=A[i*n+k];
+			if(a==0.0) continue;
+			for(j=0;j<n;j++) C[i*n+j]+=a*B[k*n+j];
+		}
+	}
+}
+
+/* E = exp(Z) by scaling and squaring with Taylor series, Z is overwritten */
+static int ana_exact_expm(double* Z, double* E, long n)
+{
+	long i,k,s;
+	double norm,row,tnorm,enorm;
+	double *T,*T2;
+	int exp2;
+
+	T =(double*)malloc(2*n*n*sizeof(double));
+	if(T==NULL) return 2;
+	T2=T+n*n;
+
+	norm=0.0;
+	for(i=0;i<n;i++)
+	{
+		row=0.0;
+		for(k=0;k<n;k++) row+=fabs(Z[i*n+k]);
+		if(row>norm) norm=row;
+	}
+
+	/* scale to norm <= 0.5 */
+	s=0;
+	if(norm>0.5)
+	{
+		frexp(norm/0.5,&exp2);
+		s=exp2;
+		for(i=0;i<n*n;i++) Z[i]=ldexp(Z[i],-exp2);
+	}
+
+	memset(E,0,n*n*sizeof(double));
+	memset(T,0,n*n*sizeof(double));
+	for(i=0;i<n;i++)
+	{
+		E[i*n+i]=1.0;
+		T[i*n+i]=1.0;
+	}
+
+	/* the series converges fast, 0.5^k/k! */
+	for(k=1;k<=30;k++)
+	{
+		ana_exact_mult(T,Z,T2,n);
+
+		tnorm=0.0;
+		enorm=0.0;
+		for(i=0;i<n*n;i++)
+		{
+			T[i]=T2[i]/(double)k;
+			E[i]+=T[i];
+			if(fabs(T[i])>tnorm) tnorm=fabs(T[i]);
+			if(fabs(E[i])>enorm) enorm=fabs(E[i]);
+		}
+
+		if(tnorm<=1e-17*enorm) break;
+	}
+
+	for(;s>0;s--)
+	{
+		ana_exact_mult(E,E,T2,n);
+		memcpy(E,T2,n*n*sizeof(double));
+	}
+
+	free(T);
+
+	return 0;
+}
+
+/****************************************/
+
+/* computes the reduced system M, N, K, L from A and B,
+ * returns 4 if the system is not an index-1 system */
+static int ana_exact_reduce(sca_exact_data* ex)
+{
+	long n=(long)ex->size;
+	long i,j,k,na,nd;
+	long *drow,*arow,*piv;
+	double *Add,*Baa,*Rd,*Ra;
+	int err=0;
+	char *dv,*dr,*qu;
+
+	drow=(long*)malloc(3*n*sizeof(long));
+	dv  =(char*)calloc(3*n,sizeof(char));
+	Add =(double*)malloc(6*n*n*sizeof(double));
+	if(drow==NULL || dv==NULL || Add==NULL)
+	{
+		if(drow!=NULL) free(drow);
+		if(dv!=NULL)   free(dv);
+		if(Add!=NULL)  free(Add);
+		return 2;
+	}
+	arow=drow+n;
+	piv =arow+n;
+	dr=dv+n;
+	qu=dr+n;
+	Baa=Add+n*n;
+	Rd =Baa+n*n;  /* right hand sides of the differential lines, n x (n+n) */
+	Ra =Rd+2*n*n; /* right hand sides of the algebraic lines, n x (n+n) */
+
+	/* differential variables/lines - non-zero columns/lines of A */
+	for(i=0;i<n;i++)
+	{
+		for(j=0;j<n;j++)
+		{
+			if(ex->A[i*n+j]!=0.0)
+			{
+				dr[i]=1;
+				dv[j]=1;
+			}
+		}
+	}
+
+	nd=0;
+	na=0;
+	for(i=0;i<n;i++)
+	{
+		if(dv[i]) ex->dvar[nd++]=i;
+		else      ex->avar[na++]=i;
+	}
+
+	k=0;
+	for(i=0,j=0;i<n;i++)
+	{
+		if(dr[i]) drow[k++]=i;
+		else      arow[j++]=i;
+	}
+
+	if(k!=nd)
+	{
+		err=4;
+		goto cleanup;
+	}
+
+	ex->nd=nd;
+
+	/* algebraic lines: B_ad x_d + B_aa x_a + q_a = 0
+	 * -> x_a = -B_aa^-1 (B_ad x_d + E_a q), stored as [K | L_full]
+	 * with L_full n columns */
+	if(na>0)
+	{
+		for(i=0;i<na;i++)
+			for(j=0;j<na;j++) Baa[i*na+j]=ex->B[arow[i]*n+ex->avar[j]];
+
+		if(ana_exact_lu(Baa,na,piv))
+		{
+			err=4;
+			goto cleanup;
+		}
+
+		for(i=0;i<na;i++)
+		{
+			for(j=0;j<nd;j++) Ra[i*(nd+n)+j]=ex->B[arow[i]*n+ex->dvar[j]];
+			for(j=0;j<n;j++)  Ra[i*(nd+n)+nd+j]=(j==arow[i])?1.0:0.0;
+		}
+
+		ana_exact_lu_solve(Baa,na,piv,Ra,nd+n);
+	}
+
+	/* differential lines: A_dd dx_d + (B_dd - B_da K) x_d + (E_d - B_da L) q = 0 */
+	for(i=0;i<nd;i++)
+	{
+		for(j=0;j<nd;j++) Add[i*nd+j]=ex->A[drow[i]*n+ex->dvar[j]];
+
+		for(j=0;j<nd;j++) Rd[i*(nd+n)+j]=ex->B[drow[i]*n+ex->dvar[j]];
+		for(j=0;j<n;j++)  Rd[i*(nd+n)+nd+j]=(j==drow[i])?1.0:0.0;
+
+		for(k=0;k<na;k++)
+		{
+			double bda=ex->B[drow[i]*n+ex->avar[k]];
+			if(bda==0.0) continue;
+			for(j=0;j<nd+n;j++) Rd[i*(nd+n)+j]-=bda*Ra[k*(nd+n)+j];
+		}
+	}
+
+	if(nd>0)
+	{
+		if(ana_exact_lu(Add,nd,piv))
+		{
+			err=4;
+			goto cleanup;
+		}
+		ana_exact_lu_solve(Add,nd,piv,Rd,nd+n);
+	}
+
+	/* used entries of q */
+	ex->nu=0;
+	for(j=0;j<n;j++)
+	{
+		for(i=0;i<nd;i++) if(Rd[i*(nd+n)+nd+j]!=0.0) qu[j]=1;
+		for(i=0;i<na;i++) if(Ra[i*(nd+n)+nd+j]!=0.0) qu[j]=1;
+		if(qu[j]) ex->qidx[ex->nu++]=j;
+	}
+
+	for(i=0;i<nd;i++)
+	{
+		for(j=0;j<nd;j++)     ex->M[i*nd+j]=-Rd[i*(nd+n)+j];
+		for(j=0;j<ex->nu;j++) ex->N[i*ex->nu+j]=-Rd[i*(nd+n)+nd+ex->qidx[j]];
+	}
+
+	for(i=0;i<na;i++)
+	{
+		for(j=0;j<nd;j++)     ex->K[i*nd+j]=Ra[i*(nd+n)+j];
+		for(j=0;j<ex->nu;j++) ex->L[i*ex->nu+j]=Ra[i*(nd+n)+nd+ex->qidx[j]];
+	}
+
+	ex->reduced=1;
+
+cleanup:
+
+	free(drow);
+	free(dv);
+	free(Add);
+
+	return err;
+}
+
+/****************************************/
+
+/* computes phi, g0 and g1 for the step size ex->h from the exponential of
+ * the augmented matrix
+ *     | M  N  0   |            | phi  P0 N  g1 |
+ * Z = | 0  0  I/h |  exp(Z h)= |  0    I    I  |
+ *     | 0  0  0   |            |  0    0    I  |
+ * with g0 = P0 N - g1 */
+static int ana_exact_coefficients(sca_exact_data* ex)
+{
+	long nd=ex->nd;
+	long nu=ex->nu;
+	long m=nd+2*nu;
+	long i,j;
+	double h=ex->h;
+	double *Z,*E;
+	int err;
+
+	Z=(double*)calloc(2*m*m,sizeof(double));
+	if(Z==NULL) return 2;
+	E=Z+m*m;
+
+	for(i=0;i<nd;i++)
+	{
+		for(j=0;j<nd;j++) Z[i*m+j]   =ex->M[i*nd+j]*h;
+		for(j=0;j<nu;j++) Z[i*m+nd+j]=ex->N[i*nu+j]*h;
+	}
+	for(i=0;i<nu;i++) Z[(nd+i)*m+nd+nu+i]=1.0;
+
+	err=ana_exact_expm(Z,E,m);
+	if(err)
+	{
+		free(Z);
+		return err;
+	}
+
+	for(i=0;i<nd;i++)
+	{
+		for(j=0;j<nd;j++) ex->phi[i*nd+j]=E[i*m+j];
+		for(j=0;j<nu;j++)
+		{
+			ex->g1[i*nu+j]=E[i*m+nd+nu+j];
+			ex->g0[i*nu+j]=E[i*m+nd+j]-ex->g1[i*nu+j];
+		}
+	}
+
+	free(Z);
+
+	ex->cnt++;
+
+	return 0;
+}
+
+/****************************************/
+
+/**
+ * The method <i>ana_free_exact</i> removes the data of the exact
+ * discretization.
+ */
+void ana_free_exact(sca_solv_data* sdata)
+{
+	sca_exact_data* ex;
+
+	if(sdata==NULL) return;
+
+	ex=&sdata->exact;
+
+	if(ex->A!=NULL)    free(ex->A);
+	if(ex->dvar!=NULL) free(ex->dvar);
+
+	memset(ex,0,sizeof(sca_exact_data));
+}
+
+/****************************************/
+
+/**
+ * The method <i>ana_init_exact_sparse</i> enables the exact discretization
+ * for the matrices \f$A\f$ and \f$B\f$ and the step size \f$h\f$ of the last
+ * call of <i>ana_reinit_sparse</i>. The coefficients are computed by
+ * <i>ana_solve_exact</i> after some steps with the same step size, they are
+ * kept as long as \f$A\f$, \f$B\f$ and \f$h\f$ don't change.
+ *
+ * @return
+ *  <ul><li>    0 - okay
+ *  <li>        1 - no solver data
+ *  <li>        2 - not enough memory
+ *  <li>		3 - system too large
+ *  </ul>
+ */
+int ana_init_exact_sparse(
+		  sparse_matrix* sA, 		/**< sparse matrix A */
+          sparse_matrix* sB,		/**< sparse matrix B */
+          double  h,              /**< time step */
+          sca_solv_data* sdata    /**< internal solver data */
+		)
+{
+	sca_exact_data* ex;
+	unsigned long n;
+	double *F;
+	int changed;
+
+	if(sdata==NULL) return 1;
+
+	ex=&sdata->exact;
+	n=sdata->size;
+
+	if(n==0 || n>SCA_EXACT_MAX_SIZE)
+	{
+		ana_free_exact(sdata);
+		return 3;
+	}
+
+	changed=0;
+	if(ex->size!=n || ex->A==NULL)
+	{
+		ana_free_exact(sdata);
+
+		/* A, B, M, N, K, L, phi, g0, g1 (n*n each), t (2*n), temp. (2*n*n) */
+		ex->A=(double*)calloc(11*n*n+2*n,sizeof(double));
+		ex->dvar=(long*)calloc(3*n,sizeof(long));
+		if(ex->A==NULL || ex->dvar==NULL)
+		{
+			ana_free_exact(sdata);
+			return 2;
+		}
+
+		ex->size=n;
+		ex->B  =ex->A+n*n;
+		ex->M  =ex->B+n*n;
+		ex->N  =ex->M+n*n;
+		ex->K  =ex->N+n*n;
+		ex->L  =ex->K+n*n;
+		ex->phi=ex->L+n*n;
+		ex->g0 =ex->phi+n*n;
+		ex->g1 =ex->g0+n*n;
+		ex->t  =ex->g1+n*n;
+		ex->avar=ex->dvar+n;
+		ex->qidx=ex->avar+n;
+
+		changed=1;
+	}
+
+	/* detect change of A and B */
+	F=ex->t+2*n;
+
+	ana_exact_sparse_to_full(sA,n,F);
+	if(changed || memcmp(F,ex->A,n*n*sizeof(double)))
+	{
+		memcpy(ex->A,F,n*n*sizeof(double));
+		changed=1;
+	}
+
+	ana_exact_sparse_to_full(sB,n,F);
+	if(changed || memcmp(F,ex->B,n*n*sizeof(double)))
+	{
+		memcpy(ex->B,F,n*n*sizeof(double));
+		changed=1;
+	}
+
+	if(changed)
+	{
+		ex->reduced=0;
+		ex->failed=0;
+		ex->valid=0;
+		ex->h=-1.0;
+	}
+
+	if(fabs(h-ex->h)>1e-13*fabs(h))
+	{
+		/* coefficients will be computed, if the step size is kept */
+		ex->valid=0;
+		ex->h=h;
+		ex->steps=0;
+	}
+
+	ex->enabled=1;
+
+	return 0;
+}
+
+/****************************************/
+
+/**
+ * The method <i>ana_init_exact</i> corresponds to <i>ana_init_exact_sparse</i>
+ * for matrices \f$A\f$ and \f$B\f$ in full matrix representation.
+ */
+int ana_init_exact (
+		  double* A,             /**< square matrix A */
+		  double* B,             /**< square matrix B */
+		  unsigned long size,    /**< number of equations -> dim of A and B */
+		  double  h,             /**< time step */
+		  sca_solv_data* sdata   /**< internal solver data */
+		)
+{
+    sparse_matrix sparse_A;
+	sparse_matrix sparse_B;
+	int err=0;
+
+	if(sdata==NULL) return 1;
+
+	if(size==0 || size>SCA_EXACT_MAX_SIZE)
+	{
+		ana_free_exact(sdata);
+		return 3;
+	}
+
+	MA_InitSparse(&sparse_A);
+	MA_InitSparse(&sparse_B);
+
+	MA_ConvertFullToSparse(A, size, &sparse_A, 0);
+	MA_ConvertFullToSparse(B, size, &sparse_B, 0);
+
+	err = ana_init_exact_sparse(&sparse_A,&sparse_B,h,sdata);
+
+	MA_FreeSparse(&sparse_A);
+  	MA_FreeSparse(&sparse_B);
+
+  	return err;
+}
+
+/****************************************/
+
+/**
+ * The method <i>ana_solve_exact</i> performs a step of the exact
+ * discretization, the input/output conventions correspond to
+ * <i>ana_solv</i>. The vector <i>sdata->x_last</i> must contain the solution
+ * of the last step, the new derivative is written to <i>sdata->xp</i>, which
+ * may differ from <i>xp_last</i>.
+ *
+ * @return
+ *  <ul><li>    0 - okay, x and xp are updated
+ *  <li>        1 - exact discretization not available, the step must be
+ *  performed by the trapezoidal method
+ *  </ul>
+ */
+int ana_solve_exact(
+		  double* q,      		/**< time dependent vector */
+		  double* x,     			/**< state vector */
+		  double* xp_last,		/**< derivative of the last step */
+		  sca_solv_data* sdata 	/**< internal solver data */
+		)
+{
+	sca_exact_data* ex=&sdata->exact;
+	long n,nd,nu,na,i,j;
+	double *qlast,*xd,*xp,*x_last;
+	double sum;
+
+	if(!ex->enabled || ex->failed) return 1;
+
+	if(!ex->valid)
+	{
+		/* use the trapezoidal method as long as the step size varies */
+		if(++ex->steps<SCA_EXACT_MIN_STEPS) return 1;
+
+		if(!ex->reduced && ana_exact_reduce(ex))
+		{
+			ex->failed=1;
+			return 1;
+		}
+
+		if(ana_exact_coefficients(ex))
+		{
+			ex->failed=1;
+			return 1;
+		}
+
+		ex->valid=1;
+	}
+
+	n =(long)ex->size;
+	nd=ex->nd;
+	nu=ex->nu;
+	na=n-nd;
+	xp=sdata->xp;
+	x_last=sdata->x_last;
+	qlast=ex->t;
+	xd=ex->t+n;
+
+	/* q of the last step from A xp + B x + q = 0 */
+	for(j=0;j<nu;j++)
+	{
+		long l=ex->qidx[j];
+		sum=0.0;
+		for(i=0;i<n;i++) sum+=ex->A[l*n+i]*xp_last[i]+ex->B[l*n+i]*x_last[i];
+		qlast[j]=-sum;
+	}
+
+	/* x_d = phi x_d,last + g0 q_last + g1 q */
+	for(i=0;i<nd;i++)
+	{
+		sum=0.0;
+		for(j=0;j<nd;j++) sum+=ex->phi[i*nd+j]*x_last[ex->dvar[j]];
+		for(j=0;j<nu;j++) sum+=ex->g0[i*nu+j]*qlast[j]+ex->g1[i*nu+j]*q[ex->qidx[j]];
+		xd[i]=sum;
+	}
+
+	for(i=0;i<nd;i++) x[ex->dvar[i]]=xd[i];
+
+	/* x_a = -(K x_d + L q) */
+	for(i=0;i<na;i++)
+	{
+		sum=0.0;
+		for(j=0;j<nd;j++) sum+=ex->K[i*nd+j]*xd[j];
+		for(j=0;j<nu;j++) sum+=ex->L[i*nu+j]*q[ex->qidx[j]];
+		x[ex->avar[i]]=-sum;
+	}
+
+	/* derivative dx_d/dt = M x_d + N q */
+	for(i=0;i<nd;i++)
+	{
+		sum=0.0;
+		for(j=0;j<nd;j++) sum+=ex->M[i*nd+j]*xd[j];
+		for(j=0;j<nu;j++) sum+=ex->N[i*nu+j]*q[ex->qidx[j]];
+		xp[ex->dvar[i]]=sum;
+	}
+	for(i=0;i<na;i++) xp[ex->avar[i]]=0.0;
+
+	return 0;
+}
+
+/****************************************/
@@ -49,6 +49,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 
 
@@ -57,6 +58,425 @@
 #include "ma_util.h"
 #include "ma_sparse.h"
 
+/**
+ * searches in the factorization cache an entry for the current key, step size
+ * and method, whose matrix equals the newly generated matrix sdata->sZ_new
+ */
+static sca_fact_cache_entry* ana_find_cache_entry(
+		sca_solv_data* sdata,
+		sca_algT alg
+		)
+{
+	sca_fact_cache_entry* entry;
+	sparse_matrix* sZ=sdata->sZ_new;
+	long i;
+
+	for(i=0;i<sdata->cache_size;i++)
+	{
+		entry=&(sdata->cache[i]);
+
+		if(!entry->valid || entry->algorithm!=alg) continue;
+		if(entry->key!=sdata->cache_key || entry->h!=sdata->h) continue;
+		if(entry->nvalues!=sZ->nel) continue;
+
+		/* the key may not cover all changes, thus compare the matrix */
+		if(MA_LequSparseCheckPattern(sZ, entry->code)!=0) continue;
+		if(memcmp(entry->values, sZ->a, sZ->nel*sizeof(double))!=0) continue;
+
+		return entry;
+	}
+
+	return NULL;
+}
+
+/*****************************************************************************/
+
+/**
+ * gets an unused or the least recently used entry of the factorization cache
+ */
+static sca_fact_cache_entry* ana_lru_cache_entry(sca_solv_data* sdata)
+{
+	sca_fact_cache_entry* entry=NULL;
+	long i;
+
+	for(i=0;i<sdata->cache_size;i++)
+	{
+		if(!sdata->cache[i].valid) return &(sdata->cache[i]);
+
+		if((entry==NULL) || (sdata->cache[i].last_use < entry->last_use))
+		{
+			entry=&(sdata->cache[i]);
+		}
+	}
+
+	return entry;
+}
+
+/*****************************************************************************/
+
+/**
+ * exchanges the current factorization of the method alg with the cache entry,
+ * allocates an empty factorization if the entry was not used before
+ */
+static int ana_swap_cache_entry(
+		sca_solv_data* sdata,
+		sca_algT alg,
+		sca_fact_cache_entry* entry
+		)
+{
+	sca_fact_cache_entry tmp;
+	sca_fact_cache_entry* active;
+	sparse_matrix** sZp;
+	struct spcode** codep;
+	struct spflat** flatp;
+
+	if(alg==EULER)
+	{
+		active=&(sdata->active_euler);
+		sZp=&(sdata->sZ_euler);
+		codep=&(sdata->code_euler);
+		flatp=&(sdata->flat_euler);
+	}
+	else
+	{
+		active=&(sdata->active_trapez);
+		sZp=&(sdata->sZ_trapez);
+		codep=&(sdata->code_trapez);
+		flatp=&(sdata->flat_trapez);
+	}
+
+	tmp=*entry;
+
+	*entry=*active;
+	entry->sZ=*sZp;
+	entry->code=*codep;
+	entry->flat=*flatp;
+
+	*active=tmp;
+	active->sZ=NULL;
+	active->code=NULL;
+	active->flat=NULL;
+
+	if(tmp.sZ==NULL)
+	{
+		tmp.sZ  =(struct sparse*)calloc(1,(unsigned)sizeof(struct sparse));
+		tmp.code=(struct spcode*)calloc(1,(unsigned)sizeof(struct spcode));
+		tmp.flat=(struct spflat*)calloc(1,(unsigned)sizeof(struct spflat));
+
+		if(tmp.sZ==NULL || tmp.code==NULL || tmp.flat==NULL)
+		{
+			if(tmp.sZ!=NULL)   free(tmp.sZ);
+			if(tmp.code!=NULL) free(tmp.code);
+			if(tmp.flat!=NULL) free(tmp.flat);
+			return 2;
+		}
+
+		MA_InitSparse(tmp.sZ);
+		MA_InitCode(tmp.code);
+		MA_InitFlatCode(tmp.flat);
+	}
+
+	*sZp=tmp.sZ;
+	*codep=tmp.code;
+	*flatp=tmp.flat;
+
+	return 0;
+}
+
+/*****************************************************************************/
+
+/**
+ * The method <i>ana_generate_code_sparse</i> generates the matrix
+ * \f$Z = W + B\f$ and its factorization for the method <i>alg</i>.
+ *
+ * If the factorization cache is enabled and a factorization for the current
+ * key, step size and matrix \f$Z\f$ is stored, it is exchanged with the
+ * current one. Otherwise the current factorization is stored in the cache
+ * and replaced by the least recently used entry.
+ *
+ * If low-rank updates are enabled and at most
+ * <i>sdata->woodbury_max_rank</i> lines of \f$Z\f$ differ from the values
+ * of the current factorization, the factorization is kept and
+ * <i>ana_solv</i> corrects the solution by the formula of Woodbury.
+ *
+ * If the structure of \f$Z\f$ is unchanged, the decomposition code of the
+ * last code generation is replayed by <i>MA_LequSparseRefactor</i>. Only if
+ * the structure has changed or a pivot became unsuitable a new code
+ * generation with pivotal search is carried out. Afterwards the solution
+ * code is lowered to the flat code used by <i>ana_solv</i>.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        1 - reallocation of NULL pointer
+ *  <li>        2 - not enough memory
+ *  <li>		3 - dimension erroneous
+ *  <li>		4 - matrix singular
+ *  <li>		6 - no sparse matrix
+ *  </ul>
+ */
+int ana_generate_code_sparse (
+		sca_solv_data* sdata,
+		int alg,
+		sparse_matrix* sW,
+		sparse_matrix* sB
+		)
+{
+	sparse_matrix* sZ_tmp;
+	sparse_matrix** sZp;
+	struct spcode* code;
+	struct spflat* flat;
+	sca_fact_cache_entry* active;
+	sca_fact_cache_entry* entry;
+	sca_lowrank_update* lowrank;
+	double* values;
+	int use_cache;
+	int err=0;
+
+	err = MA_GenerateSumMatrixWeighted(sdata->sZ_new, 1.0, sW, 1.0, sB);
+	if (err)
+		return err;
+
+	active = (alg==EULER) ? &(sdata->active_euler) : &(sdata->active_trapez);
+
+	use_cache = (sdata->cache_size > 0) && sdata->cache_key_valid;
+	lowrank = (alg==EULER) ? &(sdata->lowrank_euler) : &(sdata->lowrank_trapez);
+
+	if(use_cache)
+	{
+		entry=ana_find_cache_entry(sdata, (sca_algT)alg);
+		if(entry!=NULL)
+		{
+			sdata->cache_hits++;
+			lowrank->rank=0;
+			ana_swap_cache_entry(sdata, (sca_algT)alg, entry);
+			active->last_use=++(sdata->cache_clock);
+			return 0;
+		}
+
+		sdata->cache_misses++;
+	}
+
+	/* only a few lines changed - keep factorization, correct by Woodbury */
+	if(sdata->woodbury_max_rank > 0 && ana_update_woodbury(sdata, alg)==0)
+	{
+		sdata->woodbury_cnt++;
+		return 0;
+	}
+
+	lowrank->rank=0;
+
+	/* keep the current factorization */
+	if(use_cache && active->valid)
+	{
+		err = ana_swap_cache_entry(sdata, (sca_algT)alg,
+				ana_lru_cache_entry(sdata));
+		if(err)
+			return err;
+	}
+
+	/* store values before factorization for later comparison */
+	if(active->nvalues < sdata->sZ_new->nel)
+	{
+		values=(double*)realloc(active->values,
+				(unsigned)(sdata->sZ_new->nel*sizeof(double)));
+		if(values==NULL)
+			return 2;
+		active->values=values;
+	}
+	active->nvalues=sdata->sZ_new->nel;
+	memcpy(active->values, sdata->sZ_new->a,
+			sdata->sZ_new->nel*sizeof(double));
+
+	active->valid=0;
+
+	if(alg==EULER)
+	{
+		sZp =&(sdata->sZ_euler);
+		code=sdata->code_euler;
+		flat=sdata->flat_euler;
+	}
+	else
+	{
+		sZp =&(sdata->sZ_trapez);
+		code=sdata->code_trapez;
+		flat=sdata->flat_trapez;
+	}
+
+	if(MA_LequSparseRefactor(*sZp, sdata->sZ_new, code)==0)
+	{
+		sdata->refactor_cnt++;
+		MA_LequSparseLowerValues(*sZp, flat);
+	}
+	else
+	{
+		/* new matrix becomes Z, the old one is reused for the next generation */
+		sZ_tmp        = *sZp;
+		*sZp          = sdata->sZ_new;
+		sdata->sZ_new = sZ_tmp;
+
+		sdata->codegen_cnt++;
+
+		code->ordering=sdata->ordering;
+		err = MA_LequSparseCodegen(*sZp, code);
+		if(err)
+		{
+			sdata->critical_column=code->critical_column;
+			sdata->critical_row=code->critical_line;
+			MA_FreeFlatCode(flat);
+			return err;
+		}
+
+		/* if lowering fails, ana_solv uses the solution code */
+		MA_LequSparseLower(*sZp, code, flat);
+	}
+
+	if(use_cache)
+	{
+		active->valid=1;
+		active->key=sdata->cache_key;
+		active->h=sdata->h;
+		active->algorithm=(sca_algT)alg;
+		active->last_use=++(sdata->cache_clock);
+	}
+
+	return err;
+}
+
+/*****************************************************************************/
+
+/* frees the matrices, codes and vectors of the solver data */
+static void ana_free_solver_memory(sca_solv_data* sdata)
+{
+	/* the vector xp of an attached instance belongs to the instance */
+	if(sdata->instance!=NULL) ana_detach_solver_instance(sdata,sdata->instance);
+
+	/* a pending check point refers to the removed state */
+	ana_drop_solver_check_point(&sdata->pending_cp);
+
+	MA_FreeSparse(sdata->A);
+	MA_FreeCode(sdata->code_euler);
+	MA_FreeFlatCode(sdata->flat_euler);
+	MA_FreeSparse(sdata->sZ_euler);
+	MA_FreeSparse(sdata->sW_euler);
+	MA_FreeCode(sdata->code_trapez);
+	MA_FreeFlatCode(sdata->flat_trapez);
+	MA_FreeSparse(sdata->sZ_trapez);
+	MA_FreeSparse(sdata->sW_trapez);
+	MA_FreeSparse(sdata->sZ_new);
+	ana_free_factorization_cache(sdata);
+	ana_free_woodbury(sdata);
+	ana_free_exact(sdata);
+
+	if(sdata->xp!=NULL)       free(sdata->xp);
+	if(sdata->x_last!=NULL)   free(sdata->x_last);
+	if(sdata->r1!=NULL)       free(sdata->r1);
+	if(sdata->r2!=NULL)       free(sdata->r2);
+	if(sdata->A!=NULL)        free(sdata->A);
+	if(sdata->sZ_euler!=NULL) free(sdata->sZ_euler);
+	if(sdata->sW_euler!=NULL) free(sdata->sW_euler);
+	if(sdata->code_euler!=NULL) free(sdata->code_euler);
+	if(sdata->flat_euler!=NULL) free(sdata->flat_euler);
+
+
+	if(sdata->sZ_trapez!=NULL)    free(sdata->sZ_trapez);
+	if(sdata->sW_trapez!=NULL)    free(sdata->sW_trapez);
+	if(sdata->code_trapez!=NULL)  free(sdata->code_trapez);
+	if(sdata->flat_trapez!=NULL)  free(sdata->flat_trapez);
+	if(sdata->sZ_new!=NULL)       free(sdata->sZ_new);
+
+	sdata->xp=NULL;
+	sdata->x_last=NULL;
+	sdata->r1=NULL;
+	sdata->r2=NULL;
+	sdata->A=NULL;
+	sdata->sZ_euler=NULL;
+	sdata->sW_euler=NULL;
+	sdata->code_euler=NULL;
+	sdata->sZ_trapez=NULL;
+	sdata->sW_trapez=NULL;
+	sdata->code_trapez=NULL;
+	sdata->flat_euler=NULL;
+	sdata->flat_trapez=NULL;
+	sdata->sZ_new=NULL;
+
+	if(sdata->batch_r!=NULL)      free(sdata->batch_r);
+	if(sdata->batch_x_last!=NULL) free(sdata->batch_x_last);
+	sdata->batch_r=NULL;
+	sdata->batch_x_last=NULL;
+	sdata->batch_len=0;
+
+	sdata->size=0;
+}
+
+/*****************************************************************************/
+
+/**
+ * The method <i>ana_alloc_solver_data</i> allocates internal solver data with
+ * default settings and without matrices and codes. The settings (e.g.
+ * <i>ana_set_algorithm</i>, <i>ana_set_ordering</i>) can be changed before
+ * the first <i>ana_init_sparse</i>, thus the codes are generated only once.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  </ul>
+ */
+int ana_alloc_solver_data(sca_solv_data **sdatap)
+{
+	sca_solv_data *sdata;
+
+	sdata =(sca_solv_data*)malloc(sizeof(sca_solv_data));
+
+	if (sdata == NULL)
+		return 2;
+
+	sdata->A=NULL;
+	sdata->sW_euler=NULL;
+	sdata->sW_trapez=NULL;
+	sdata->sZ_euler=NULL;
+	sdata->sZ_trapez=NULL;
+	sdata->code_euler=NULL;
+	sdata->code_trapez=NULL;
+	sdata->flat_euler=NULL;
+	sdata->flat_trapez=NULL;
+	sdata->sZ_new=NULL;
+	sdata->codegen_cnt=0;
+	sdata->refactor_cnt=0;
+	sdata->cache_size=0;
+	sdata->cache=NULL;
+	memset(&(sdata->active_euler),0,sizeof(sca_fact_cache_entry));
+	memset(&(sdata->active_trapez),0,sizeof(sca_fact_cache_entry));
+	sdata->cache_key=0;
+	sdata->cache_key_valid=0;
+	sdata->cache_clock=0;
+	sdata->cache_hits=0;
+	sdata->cache_misses=0;
+	sdata->woodbury_max_rank=0;
+	memset(&(sdata->lowrank_euler),0,sizeof(sca_lowrank_update));
+	memset(&(sdata->lowrank_trapez),0,sizeof(sca_lowrank_update));
+	sdata->woodbury_cnt=0;
+	sdata->consolidate_cnt=0;
+	sdata->ordering=0;
+	memset(&(sdata->exact),0,sizeof(sca_exact_data));
+	sdata->instance=NULL;
+	sdata->xp_data=NULL;
+	sdata->batch_r=NULL;
+	sdata->batch_x_last=NULL;
+	sdata->batch_len=0;
+	sdata->pending_cp=NULL;
+	sdata->algorithm=TRAPEZ;
+	sdata->cur_algorithm=EULER;
+	sdata->reinit_cnt=0;
+	sdata->reinit_steps=0;
+
+	sdata->size=0;
+	*sdatap=sdata;
+
+	return 0;
+}
+
+/*****************************************************************************/
+
 /**
  * The method <i>ana_init</i> generates sparse matrices \f$W_{euler}\f$,
  * \f$Z_{euler}\f$, \f$W_{trapez}\f$ and \f$Z_{trapez}\f$ in CRS-format as
@@ -67,6 +487,9 @@
  * <li>	\f$W_{trapez} = \frac2{h} A\f$
  * <li>	\f$Z_{trapez} = \frac2{h} A + B\f$
  * </ul>
+ * For the BDF2 method (<i>sdata->algorithm = BDF2</i>) the matrices
+ * \f$W_{trapez}\f$ and \f$Z_{trapez}\f$ are generated with the factor
+ * \f$\frac3{2h}\f$ instead of \f$\frac2{h}\f$.
  * The sparse matrices are stored within the internal solver data. Moreover, the
  * method generates code for decomposition of the matrices \f$Z_{euler}\f$ and
  * \f$Z_{trapez}\f$ as well as the solution code to solve linear systems of
@@ -108,34 +531,17 @@ int ana_init_sparse (
 	int force_init=0;
 
 	/*** common data ******/
-	if((!reinit)||((*sdatap)==NULL))
+	/* solver data without codes (e.g. from ana_alloc_solver_data) is used
+	 * with its settings */
+	if(((*sdatap)==NULL)||((!reinit)&&((*sdatap)->size!=0)))
 	{
-		sdata =(sca_solv_data*)malloc(sizeof(sca_solv_data));
-
-
-		if (sdata == NULL)
-			return 2;
-
-		sdata->A=NULL;
-		sdata->sW_euler=NULL;
-		sdata->sW_trapez=NULL;
-		sdata->sZ_euler=NULL;
-		sdata->sZ_trapez=NULL;
-		sdata->code_euler=NULL;
-		sdata->code_trapez=NULL;
-		sdata->algorithm=TRAPEZ;
-		sdata->cur_algorithm=EULER;
-		sdata->reinit_cnt=0;
-		sdata->reinit_steps=0;
-
-		*sdatap=sdata;
-		sdata->size=0;
-	}
-	else
-	{
-		sdata=*sdatap;
+		err = ana_alloc_solver_data(sdatap);
+		if(err)
+			return err;
 	}
 
+	sdata=*sdatap;
+
 	sdata->critical_column = -1;
 	sdata->critical_row    = -1;
 
@@ -143,40 +549,7 @@ int ana_init_sparse (
 
 	if(force_init && (sdata->size!=0))
 	{
-		MA_FreeSparse(sdata->A);
-		MA_FreeCode(sdata->code_euler);
-		MA_FreeSparse(sdata->sZ_euler);
-		MA_FreeSparse(sdata->sW_euler);
-		MA_FreeCode(sdata->code_trapez);
-		MA_FreeSparse(sdata->sZ_trapez);
-		MA_FreeSparse(sdata->sW_trapez);
-
-		if(sdata->xp!=NULL)       free(sdata->xp);
-		if(sdata->x_last!=NULL)   free(sdata->x_last);
-		if(sdata->r1!=NULL)       free(sdata->r1);
-		if(sdata->r2!=NULL)       free(sdata->r2);
-		if(sdata->A!=NULL)        free(sdata->A);
-		if(sdata->sZ_euler!=NULL) free(sdata->sZ_euler);
-		if(sdata->sW_euler!=NULL) free(sdata->sW_euler);
-		if(sdata->code_euler!=NULL) free(sdata->code_euler);
-
-
-		if(sdata->sZ_trapez!=NULL)    free(sdata->sZ_trapez);
-		if(sdata->sW_trapez!=NULL)    free(sdata->sW_trapez);
-		if(sdata->code_trapez!=NULL)  free(sdata->code_trapez);
-
-		sdata->xp=NULL;
-		sdata->x_last=NULL;
-		sdata->r1=NULL;
-		sdata->r2=NULL;
-		sdata->A=NULL;
-		sdata->sZ_euler=NULL;
-		sdata->sW_euler=NULL;
-		sdata->code_euler=NULL;
-		sdata->sZ_trapez=NULL;
-		sdata->sW_trapez=NULL;
-		sdata->code_trapez=NULL;
-		sdata->size=0;
+		ana_free_solver_memory(sdata);
 	}
 
 	sdata->h     = h;
@@ -215,11 +588,19 @@ int ana_init_sparse (
 				(struct sparse*)calloc(1,(unsigned)sizeof(struct sparse));
 		sdata->code_euler =
 				(struct spcode*)calloc(1,(unsigned)sizeof(struct spcode));
+		sdata->flat_euler =
+				(struct spflat*)calloc(1,(unsigned)sizeof(struct spflat));
+		sdata->sZ_new    =
+				(struct sparse*)calloc(1,(unsigned)sizeof(struct sparse));
 
 		if (sdata->A == NULL ||sdata->sZ_euler == NULL
-				|| sdata->sW_euler == NULL || sdata->code_euler == NULL)
+				|| sdata->sW_euler == NULL || sdata->code_euler == NULL
+				|| sdata->flat_euler == NULL || sdata->sZ_new == NULL)
 			return 2;
 
+		MA_InitFlatCode(sdata->flat_euler);
+
+		MA_InitSparse(sdata->sZ_new);
 		MA_InitSparse(sdata->sZ_euler);
 		MA_InitSparse(sdata->sW_euler);
 		MA_InitSparse(sdata->A);
@@ -238,27 +619,14 @@ int ana_init_sparse (
 		if (err)
 			return err;
 
-		err = MA_GenerateSumMatrixWeighted(sdata->sZ_euler, 1.0,
-				sdata->sW_euler, 1.0, sB);
-		if (err)
-			return err;
-
-		err = MA_LequSparseCodegen(sdata->sZ_euler,sdata->code_euler);
+		err = ana_generate_code_sparse(sdata, EULER, sdata->sW_euler, sB);
 		if(err)
-		{
-			if(sdata->code_euler!=NULL)
-			{
-				sdata->critical_column=sdata->code_euler->critical_column;
-				sdata->critical_row=sdata->code_euler->critical_line;
-			}
-
 			return(err);
-		}
 	}
 
-	/*** initialization for trapezoidal method *******/
+	/*** initialization for trapezoidal or BDF2 method *******/
 
-	if(sdata->algorithm==TRAPEZ)
+	if(sdata->algorithm!=EULER)
 	{
 
 		if(force_init)
@@ -269,40 +637,32 @@ int ana_init_sparse (
 				(struct sparse*)calloc(1,(unsigned)sizeof(struct sparse));
 			sdata->code_trapez =
 				(struct spcode*)calloc(1,(unsigned)sizeof(struct spcode));
+			sdata->flat_trapez =
+				(struct spflat*)calloc(1,(unsigned)sizeof(struct spflat));
 
 			if (sdata->sZ_trapez == NULL || sdata->sW_trapez == NULL
-					|| sdata->code_trapez == NULL)
+					|| sdata->code_trapez == NULL || sdata->flat_trapez == NULL)
 				return 2;
 
+			MA_InitFlatCode(sdata->flat_trapez);
+
 			MA_InitSparse(sdata->sZ_trapez);
 			MA_InitSparse(sdata->sW_trapez);
 			MA_InitCode(sdata->code_trapez);
 		}
 
-		hinv = 2.0/h;
+		hinv = (sdata->algorithm==BDF2) ? 1.5/h : 2.0/h;
 
 		err = MA_GenerateProductValueSparse(sdata->sW_trapez, sA, hinv);
 		if (err)
 			return err;
 
-		err = MA_GenerateSumMatrixWeighted(sdata->sZ_trapez, 1.0,
-				sdata->sW_trapez, 1.0, sB);
-		if (err)
-			return err;
-
-		err = MA_LequSparseCodegen(sdata->sZ_trapez,sdata->code_trapez);
+		err = ana_generate_code_sparse(sdata, sdata->algorithm,
+				sdata->sW_trapez, sB);
 		if(err)
-		{
-			if(sdata->code_trapez!=NULL)
-			{
-				sdata->critical_column=sdata->code_trapez->critical_column;
-				sdata->critical_row=sdata->code_trapez->critical_line;
-			}
-
 			return(err);
-		}
 
-	} /*if(sdata->algorithm==TRAPEZ)*/
+	} /*if(sdata->algorithm!=EULER)*/
 
 	return(0);
 }
@@ -346,6 +706,44 @@ int ana_init (
    return err;
 }
 
+/*****************************************************************************/
+
+/**
+ * The method <i>ana_free_solver_data</i> frees the internal solver data
+ * and sets the pointer to NULL.
+ */
+void ana_free_solver_data(
+		sca_solv_data **sdatap
+		)
+{
+	sca_solv_data* sdata;
+
+	if((sdatap==NULL) || ((*sdatap)==NULL)) return;
+
+	sdata=*sdatap;
+
+	if(sdata->size!=0)
+	{
+		ana_free_solver_memory(sdata);
+	}
+	else
+	{
+		if(sdata->instance!=NULL) ana_detach_solver_instance(sdata,sdata->instance);
+		ana_drop_solver_check_point(&sdata->pending_cp);
+		if(sdata->xp!=NULL)     free(sdata->xp);
+		if(sdata->x_last!=NULL) free(sdata->x_last);
+		if(sdata->r1!=NULL)     free(sdata->r1);
+		if(sdata->r2!=NULL)     free(sdata->r2);
+		if(sdata->batch_r!=NULL)      free(sdata->batch_r);
+		if(sdata->batch_x_last!=NULL) free(sdata->batch_x_last);
+		ana_free_factorization_cache(sdata);
+		ana_free_exact(sdata);
+	}
+
+	free(sdata);
+	(*sdatap)=NULL;
+}
+
 
 
 
@@ -64,6 +64,8 @@
  * <li>	\f$W_{trapez} = \frac2{h} A\f$
  * <li>	\f$Z_{trapez} = \frac2{h} A + B\f$
  * </ul>
+ * For the BDF2 method the factor \f$\frac2{h}\f$ is replaced by
+ * \f$\frac3{2h}\f$.
  * The sparse matrices are stored within the internal solver data. Moreover, the
  * method generates code for factorization of the matrices \f$Z_{euler}\f$ and
  * \f$Z_{trapez}\f$.
@@ -121,33 +123,28 @@ int ana_reinit_sparse (
 	/*copy A matrix, due its required for solver*/
 	MA_CopySparse(sdata->A,sA);
 
-	hinv = 2.0/h;
+	hinv = (sdata->algorithm==BDF2) ? 1.5/h : 2.0/h;
 	sdata->h = h;
 
-	if((*sdatap)->algorithm==TRAPEZ)
+	/* BDF2 keeps the backward difference xp of the last step as slope, thus
+	 * the history is linearly interpolated for the new step size */
+	if((*sdatap)->algorithm!=EULER)
 	{
 
 		err = MA_GenerateProductValueSparse(sdata->sW_trapez, sA, hinv);
 		if (err)
 			return err;
 
-		err = MA_GenerateSumMatrixWeighted(sdata->sZ_trapez, 1.0, sdata->sW_trapez,1.0, sB);
-
-		if (err)
-		{
-			return err;
-		}
-
-		err = MA_LequSparseCodegen(sdata->sZ_trapez, sdata->code_trapez);
+		/* numeric refactorization if only values of Z_trapez changed */
+		err = ana_generate_code_sparse(sdata, sdata->algorithm,
+				sdata->sW_trapez, sB);
 
 		if(err)
 		{
-			sdata->critical_column=sdata->code_trapez->critical_column;
-			sdata->critical_row=sdata->code_trapez->critical_line;
 			return(err);
 		}
 
-	} /*if((*sdatap)->algorithm==TRAPEZ)*/
+	} /*if((*sdatap)->algorithm!=EULER)*/
 
 	return err;
 }
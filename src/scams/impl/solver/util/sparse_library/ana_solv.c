@@ -47,6 +47,7 @@
 #include "ma_typedef.h"
 #include "ma_util.h"
 #include "ma_sparse.h"
+#include "linear_analog_solver.h"
 #include <string.h>
 #include <stdio.h> /* for fprintf and stderr */
 #include <stdlib.h>
@@ -54,14 +55,68 @@
 
 /****************************************/
 
+/**
+ * updates the state after the solution in one sweep: the new solution
+ * (stored in <i>x_last</i>) and the solution of the last step (stored in
+ * <i>x</i>) are exchanged and the derivative is computed by
+ * \f$xp = hinv\,(x - x_{last}) - xp_{last}\f$ (or without \f$xp_{last}\f$
+ * if <i>trapez</i> = 0)
+ */
+static void ana_solv_update(
+		double* x,
+		double* x_last,
+		double* xp,
+		const double* xp_last,
+		double hinv,
+		int trapez,
+		unsigned long size
+		)
+{
+	unsigned long i;
+	double x_new, x_old;
+
+	if(trapez)
+	{
+		for(i=0;i<size;++i)
+		{
+			x_new=x_last[i];
+			x_old=x[i];
+			xp[i]=hinv*(x_new-x_old)-xp_last[i];
+			x[i]=x_new;
+			x_last[i]=x_old;
+		}
+	}
+	else
+	{
+		for(i=0;i<size;++i)
+		{
+			x_new=x_last[i];
+			x_old=x[i];
+			xp[i]=(x_new-x_old)*hinv;
+			x[i]=x_new;
+			x_last[i]=x_old;
+		}
+	}
+}
+
+/****************************************/
+
 /**
  * The method <i>ana_solv</i> computes the solution of a linear system of
- * equations by calling the function <i>MA_LequSparseSolut</i>:
+ * equations by calling the function <i>MA_LequSparseSolutFlat</i> (or
+ * <i>MA_LequSparseSolut</i>, if no flat code is available). If a low-rank
+ * update of the factorized matrix is pending, the solution is corrected by
+ * <i>ana_solve_woodbury</i>:
  * <ul>
  * <li> In case of <i>sdata->cur_algorithm = EULER</i>: \f$x\f$ is the solution to
  * \f$Z_{euler} x = W_{euler}\, x_{last} - q\f$
  * <li> In case of <i>sdata->cur_algorithm = TRAPEZ</i>: \f$x\f$ is the solution to
  * \f$Z_{trapez} x = W_{trapez}\, x_{last} + A\,xp - q\f$
+ * <li> In case of <i>sdata->cur_algorithm = BDF2</i>: \f$x\f$ is the solution to
+ * \f$Z_{trapez} x = W_{trapez}\, x_{last} + \frac12 A\,xp - q\f$ with
+ * \f$Z_{trapez} = \frac3{2h} A + B\f$, this is the two step BDF formula
+ * \f$\dot{x} = \frac1{2h}(3x - 4x_{last} + x_{last2})\f$ with
+ * \f$x_{last2} = x_{last} - h\,xp\f$
  * </ul>
  *
  *  Implementation details of the function <i>ana_solv</i>: <br>
@@ -71,8 +126,20 @@
  *	<li> The vector \f$ x \f$ deals as output as solution vector of the current
  *	time step.
  *	<li> The vector \f$xp\f$ is computed by \f$xp = \frac1{h}(x - x_{last})\f$
+ *	(Euler, BDF2) or \f$xp = \frac2{h}(x - x_{last}) - xp\f$ (trapezoidal)
  *	after solving the linear system of equation, \f$xp\f$ is used as input at
- *	the next time step.
+ *	the next time step. Thus the history of BDF2 consists of \f$x_{last}\f$
+ *	and \f$xp\f$ only, it is stored by check points and valid after the Euler
+ *	steps of an initialization.
+ *	<li> The right-hand side is computed in one sweep by
+ *	<i>MA_ResidualSparseVector</i>, the solution is written to the vector
+ *	\f$x_{last}\f$, afterwards <i>ana_solv_update</i> exchanges the values
+ *	of \f$x\f$ and \f$x_{last}\f$ and computes \f$xp\f$ in the same loop.
+ *	Thus the vector \f$x_{last}\f$ has not to be copied before the solution.
+ *	<li> A pending check point (see <i>ana_flip_solver_check_point</i>) takes
+ *	over the vectors \f$x_{last}\f$ and \f$xp\f$ of the previous time step by
+ *	exchanging the pointers, the new \f$xp\f$ is written to the vector of
+ *	the check point.
  *	</ul>
  */
 void ana_solv (
@@ -82,37 +149,75 @@ void ana_solv (
                 )
 {
    double hinv;
-   double *r1, *r2;
+   double *r1;
    unsigned long size;
-   unsigned long i;
-   double *xp, *x_last;
+   double *xp, *xp_last, *x_last;
+   sca_solv_checkpoint_data* cp;
+   int exact_done=0;
 
    r1    = sdata->r1;
-   r2    = sdata->r2;
    size  =sdata->size;
    xp    =sdata->xp;
    x_last=sdata->x_last;
 
-   if(size>0) memcpy(x_last, x, size*sizeof(double));
-
    if(fabs(sdata->h) < 1e-300 ){
 	   printf("%s \n", "Division by zero in ana_solv.c stepsize(1/dt) to small! Aborting...");
    	   exit(EXIT_FAILURE);
    }
 
+   /* a pending check point takes over the vectors of the last step, the new
+    * derivative is written to the vector of the check point */
+   cp=sdata->pending_cp;
+   sdata->pending_cp=NULL;
+   if((cp!=NULL) && (!cp->pending || (cp->x_src!=x) || (cp->xp_src!=xp)))
+   {
+	   if(cp->pending)
+	   {
+		   sdata->pending_cp=cp;
+		   ana_resolve_solver_check_point(sdata);
+	   }
+	   cp=NULL;
+   }
+
+   if(cp!=NULL)
+   {
+	   xp=cp->xp;
+	   cp->xp=sdata->xp;
+	   sdata->xp=xp;
+	   if(sdata->instance!=NULL) sdata->instance->xp=xp;
+   }
+
+   xp_last=(cp!=NULL) ? cp->xp : xp;
+
    /************************************************/
 
-   if(sdata->cur_algorithm==EULER)	/******* Euler backward ********/
+   /* exact discretization for small systems with constant step size */
+   if(sdata->exact.enabled && (sdata->cur_algorithm==TRAPEZ))
    {
-	   MA_ProductSparseVector(sdata->sW_euler, x, r1);
+	   if(size>0) memcpy(x_last, x, size*sizeof(double));
+	   exact_done=(ana_solve_exact(q, x, xp_last, sdata)==0);
+   }
 
-	   for(i=0;i<size;++i) r1[i] -= q[i];
+   if(exact_done)
+   {
+	   /* x and xp are updated by the exact discretization */
+   }
+   else if(sdata->cur_algorithm==EULER)	/******* Euler backward ********/
+   {
+	   MA_ResidualSparseVector(sdata->sW_euler, x, NULL, 0.0, NULL, q, r1);
 
-	   MA_LequSparseSolut(sdata->sZ_euler, sdata->code_euler, r1, x);
+	   /* the solution is written to x_last, x still contains the last step */
+	   if(sdata->flat_euler->n > 0)
+		   MA_LequSparseSolutFlat(sdata->flat_euler, r1, x_last);
+	   else
+		   MA_LequSparseSolut(sdata->sZ_euler, sdata->code_euler, r1, x_last);
+
+	   if(sdata->lowrank_euler.rank > 0)
+		   ana_solve_woodbury(sdata, EULER, x_last);
 
 	   hinv  = 1/sdata->h;
 
-       for(i=0;i<size;++i) xp[i]=(x[i]-x_last[i])*hinv; /*derivation*/
+	   ana_solv_update(x, x_last, xp, xp_last, hinv, 0, size);
 
        if(sdata->reinit_cnt<=0)
        {
@@ -123,20 +228,203 @@ void ana_solv (
     	   sdata->reinit_cnt--;
        }
    }
+   else if(sdata->cur_algorithm==BDF2)	/*** BDF2 (Gear) method ****/
+   {
+	   /* W*x(i-1) + 1/2*A*xp(i-1) - q(i) */
+	   MA_ResidualSparseVector(sdata->sW_trapez, x, sdata->A, 0.5, xp_last, q, r1);
+
+	   if(sdata->flat_trapez->n > 0)
+		   MA_LequSparseSolutFlat(sdata->flat_trapez, r1, x_last);
+	   else
+		   MA_LequSparseSolut(sdata->sZ_trapez, sdata->code_trapez, r1, x_last);
+
+	   if(sdata->lowrank_trapez.rank > 0)
+		   ana_solve_woodbury(sdata, BDF2, x_last);
+
+	   hinv  = 1/sdata->h;
+
+	   ana_solv_update(x, x_last, xp, xp_last, hinv, 0, size); /*backward difference*/
+   }
    else	/*** trapezoidal method ****/
    {
-	   MA_ProductSparseVector(sdata->sW_trapez, x, r1);     /* W*x(i-1) */
-	   MA_ProductSparseVector(sdata->A, xp, r2);            /* A*xp(i-1) */
+	   /* W*x(i-1) + A*xp(i-1) - q(i) */
+	   MA_ResidualSparseVector(sdata->sW_trapez, x, sdata->A, 1.0, xp_last, q, r1);
 
-	   for(i=0;i<size;++i)
-		   r1[i] += r2[i] - q[i];     /* W*x(i-1) + A*xp(i-1) - q(i) */
+	   if(sdata->flat_trapez->n > 0)
+		   MA_LequSparseSolutFlat(sdata->flat_trapez, r1, x_last);
+	   else
+		   MA_LequSparseSolut(sdata->sZ_trapez, sdata->code_trapez, r1, x_last);
 
-	   MA_LequSparseSolut(sdata->sZ_trapez, sdata->code_trapez, r1, x);
+	   if(sdata->lowrank_trapez.rank > 0)
+		   ana_solve_woodbury(sdata, TRAPEZ, x_last);
 
 	   hinv=2.0/sdata->h;
 
-	   for(i=0;i<size;++i) xp[i]=hinv*(x[i]-x_last[i])-xp[i]; /*new derivation*/
+	   ana_solv_update(x, x_last, xp, xp_last, hinv, 1, size); /*new derivation*/
+   }
+
+   /* the solution of the last step becomes the state vector of the check
+    * point, the vector of the check point is used as x_last for the next step */
+   if(cp!=NULL)
+   {
+	   x_last=cp->x;
+	   cp->x=sdata->x_last;
+	   sdata->x_last=x_last;
+	   cp->pending=0;
+   }
+}
+
+/****************************************/
+
+/**
+ * solves \f$Z x = r\f$ for the <i>n_inst</i> vectors of a batch stored by
+ * lines, the low-rank update of \f$Z\f$ is applied to each vector
+ */
+static void ana_solv_batch_lequ(
+		struct sparse* sZ,
+		struct spcode* code,
+		struct spflat* flat,
+		int alg,
+		double* r,
+		double* x,
+		unsigned long n_inst,
+		sca_solv_data* sdata
+		)
+{
+	unsigned long i, c, size;
+	sca_lowrank_update* upd;
+
+	size=sdata->size;
+	upd=(alg==EULER) ? &sdata->lowrank_euler : &sdata->lowrank_trapez;
+
+	if(flat->n > 0) MA_LequSparseSolutFlatBatch(flat, r, x, (count_far)n_inst);
+
+	if((flat->n > 0) && (upd->rank <= 0)) return;
+
+	/* vector by vector */
+	for(c=0;c<n_inst;c++)
+	{
+		if(flat->n > 0)
+		{
+			for(i=0;i<size;i++) sdata->r2[i]=x[i*n_inst+c];
+		}
+		else
+		{
+			for(i=0;i<size;i++) sdata->r1[i]=r[i*n_inst+c];
+			MA_LequSparseSolut(sZ, code, sdata->r1, sdata->r2);
+		}
+
+		if(upd->rank > 0) ana_solve_woodbury(sdata, alg, sdata->r2);
+
+		for(i=0;i<size;i++) x[i*n_inst+c]=sdata->r2[i];
+	}
+}
+
+/****************************************/
+
+/**
+ * The method <i>ana_solv_batch</i> computes the time step of
+ * <i>n_inst</i> instances, which share the solver data, in one sweep. The
+ * vectors \f$q\f$, \f$x\f$ and \f$xp\f$ of the instances are stored by
+ * lines (structure of arrays): the element i of instance c is at index
+ * i*n_inst+c. Thus each element of the matrices and of the substitution
+ * code is loaded once for all instances and the innermost loops over the
+ * instances can be vectorized.
+ *
+ * The instances are in lock step, they use the current method of the solver
+ * data, which is advanced once per batch as by <i>ana_solv</i>. The result
+ * of each instance equals the result of <i>ana_solv</i> with the instance
+ * state up to the rounding of the residual.
+ * Check points and instances attached by <i>ana_attach_solver_instance</i>
+ * are not used by the batch.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        1 - exact discretization active, the instances must be
+ *                  solved by <i>ana_solv</i>
+ *  <li>        2 - not enough memory
+ *  </ul>
+ */
+int ana_solv_batch (
+            double* q,
+            double* x,
+            double* xp,
+            unsigned long n_inst,
+            sca_solv_data* sdata
+                )
+{
+   unsigned long len;
+   double *r, *x_last;
+
+   if(n_inst==0) return 0;
+
+   if(fabs(sdata->h) < 1e-300 ){
+	   printf("%s \n", "Division by zero in ana_solv.c stepsize(1/dt) to small! Aborting...");
+   	   exit(EXIT_FAILURE);
    }
+
+   if(sdata->exact.enabled && (sdata->cur_algorithm==TRAPEZ)) return 1;
+
+   /* work vectors for the batch */
+   len=sdata->size*n_inst;
+   if(sdata->batch_len < len)
+   {
+	   if(sdata->batch_r!=NULL)      free(sdata->batch_r);
+	   if(sdata->batch_x_last!=NULL) free(sdata->batch_x_last);
+	   sdata->batch_r     =(double*)malloc(len*sizeof(double));
+	   sdata->batch_x_last=(double*)malloc(len*sizeof(double));
+	   sdata->batch_len=len;
+
+	   if((sdata->batch_r==NULL) || (sdata->batch_x_last==NULL))
+	   {
+		   if(sdata->batch_r!=NULL)      free(sdata->batch_r);
+		   if(sdata->batch_x_last!=NULL) free(sdata->batch_x_last);
+		   sdata->batch_r=NULL;
+		   sdata->batch_x_last=NULL;
+		   sdata->batch_len=0;
+		   return 2;
+	   }
+   }
+
+   r=sdata->batch_r;
+   x_last=sdata->batch_x_last;
+
+   if(sdata->cur_algorithm==EULER)	/******* Euler backward ********/
+   {
+	   MA_ResidualSparseBatch(sdata->sW_euler, x, NULL, 0.0, NULL, q, r,
+			   (count_far)n_inst);
+
+	   ana_solv_batch_lequ(sdata->sZ_euler, sdata->code_euler,
+			   sdata->flat_euler, EULER, r, x_last, n_inst, sdata);
+
+	   ana_solv_update(x, x_last, xp, xp, 1/sdata->h, 0, len);
+
+       if(sdata->reinit_cnt<=0)
+       {
+    	   sdata->cur_algorithm=sdata->algorithm;
+       }
+       else
+       {
+    	   sdata->reinit_cnt--;
+       }
+   }
+   else	/*** trapezoidal method or BDF2 ****/
+   {
+	   MA_ResidualSparseBatch(sdata->sW_trapez, x, sdata->A,
+			   (sdata->cur_algorithm==BDF2) ? 0.5 : 1.0, xp, q, r,
+			   (count_far)n_inst);
+
+	   ana_solv_batch_lequ(sdata->sZ_trapez, sdata->code_trapez,
+			   sdata->flat_trapez, sdata->cur_algorithm, r, x_last, n_inst,
+			   sdata);
+
+	   if(sdata->cur_algorithm==BDF2)
+		   ana_solv_update(x, x_last, xp, xp, 1/sdata->h, 0, len);
+	   else
+		   ana_solv_update(x, x_last, xp, xp, 2.0/sdata->h, 1, len);
+   }
+
+   return 0;
 }
 
 /****************************************/
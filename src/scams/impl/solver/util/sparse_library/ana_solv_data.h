@@ -45,11 +45,89 @@
 typedef enum sca_algE
 {
    EULER =0,
-   TRAPEZ=1
+   TRAPEZ=1,
+   BDF2  =2		/* uses the matrices of TRAPEZ with Z = 3/(2h) A + B */
 }sca_algT;
 
 /****************************************/
 
+typedef struct sca_fact_cache_entryS
+{
+      int valid;					/* entry contains a usable factorization */
+      unsigned long long key;		/* key of the system state */
+      double h;					/* step size */
+      sca_algT algorithm;			/* method the matrix Z belongs to */
+      unsigned long last_use;		/* for least recently used replacement */
+
+      struct sparse *sZ;			/* factorized matrix Z */
+      struct spcode *code;		/* code for factorization/substitution Z */
+      struct spflat *flat;		/* flat substitution code Z */
+
+      double *values;				/* values of Z before factorization */
+      long nvalues;				/* number of values */
+
+} sca_fact_cache_entry;
+
+/****************************************/
+
+typedef struct sca_lowrank_updateS
+{
+      long rank;					/* number of changed lines, 0: no update */
+      long *lines;				/* changed lines of Z */
+      long *ptr;					/* start of the changes of each line, rank+1 el. */
+      long *col;					/* columns of the changes */
+      double *val;				/* changes of Z */
+      double *zu;					/* Z^-1 applied to unit vectors of changed lines */
+      double *cap;				/* decomposed capacitance matrix */
+      long *piv;					/* pivot lines of capacitance matrix */
+      double *t;					/* temporary vector */
+
+      struct sparse *sZ;			/* updated matrix Z, not factorized */
+      double cost;				/* flops spent for corrections */
+
+      unsigned long long key;		/* key of the updated system state */
+      int key_valid;				/* 0: updated state has no key */
+      double h;					/* step size of updated matrix */
+
+} sca_lowrank_update;
+
+/****************************************/
+
+typedef struct sca_exact_dataS
+{
+      int enabled;				/* 0: exact discretization not used */
+      int valid;					/* coefficients are valid for the step size h */
+      int failed;				/* system can't be discretized exactly */
+      long steps;				/* steps with the current step size */
+      double h;					/* step size of the coefficients */
+      unsigned long size;		/* number of equations */
+
+      double *A;					/* full matrix A, size*size by lines */
+      double *B;					/* full matrix B, size*size by lines */
+
+      long nd;					/* number of differential variables */
+      long *dvar;				/* differential variables, nd el. */
+      long *avar;				/* algebraic variables, size-nd el. */
+      long nu;					/* number of used entries of q */
+      long *qidx;				/* used entries of q, nu el. */
+      int reduced;				/* reduced system M, N is available */
+
+      double *M;					/* dx_d/dt = M x_d + N q, nd*nd */
+      double *N;					/* nd*nu */
+      double *K;					/* x_a = -(K x_d + L q), (size-nd)*nd */
+      double *L;					/* (size-nd)*nu */
+
+      double *phi;				/* transition matrix exp(M h), nd*nd */
+      double *g0;				/* input matrix for q of last step, nd*nu */
+      double *g1;				/* input matrix for q of current step, nd*nu */
+
+      double *t;					/* temporary vectors, 2*size el. */
+      long cnt;					/* number of coefficient computations */
+
+} sca_exact_data;
+
+/****************************************/
+
 typedef struct sca_solv_dataS
 {
       double h;					/* step size */
@@ -76,12 +154,59 @@ typedef struct sca_solv_dataS
       struct sparse *sZ_euler;	/* Z_euler = 1/h A + B */
       struct sparse *sW_euler;	/* W_euler = 1/h A */
       struct spcode *code_euler;	/* code for factorization/substitution Z_euler */
+      struct spflat *flat_euler;	/* flat substitution code Z_euler */
 
-      /***** data for trapez *****/
+      /***** data for trapez (or BDF2) *****/
 
-      struct sparse *sZ_trapez;	/* Z_trapez = 2/h A + B */
-      struct sparse *sW_trapez;	/* W_trapez = 2/h A */
+      struct sparse *sZ_trapez;	/* Z_trapez = 2/h A + B, BDF2: 3/(2h) A + B */
+      struct sparse *sW_trapez;	/* W_trapez = 2/h A, BDF2: 3/(2h) A */
       struct spcode *code_trapez;	/* code for factorization/substitution Z_trapez */
+      struct spflat *flat_trapez;	/* flat substitution code Z_trapez */
+
+      /***** data for numeric refactorization *****/
+
+      struct sparse *sZ_new;	/* newly generated Z before refactorization */
+      long codegen_cnt;			/* number of code generations */
+      long refactor_cnt;		/* number of numeric refactorizations */
+
+      /***** factorization cache *****/
+
+      long cache_size;			/* number of cached factorizations */
+      sca_fact_cache_entry *cache;	/* cached factorizations */
+      sca_fact_cache_entry active_euler;	/* key and values of current Z_euler */
+      sca_fact_cache_entry active_trapez;	/* key and values of current Z_trapez */
+      unsigned long long cache_key;	/* key of the current system state */
+      int cache_key_valid;		/* 0: current system state has no key */
+      unsigned long cache_clock;	/* counter for least recently used */
+      long cache_hits;			/* number of factorizations found in cache */
+      long cache_misses;		/* number of factorizations not found */
+
+      /***** low-rank updates (Woodbury) *****/
+
+      long woodbury_max_rank;	/* max. number of changed lines, 0: disabled */
+      sca_lowrank_update lowrank_euler;	/* update of factorized Z_euler */
+      sca_lowrank_update lowrank_trapez;	/* update of factorized Z_trapez */
+      long woodbury_cnt;		/* number of low-rank updates */
+      long consolidate_cnt;		/* number of updates merged by refactorization */
+
+      int ordering;				/* fill-reducing ordering for code generation */
+
+      /***** exact discretization for small systems *****/
+
+      sca_exact_data exact;
+
+      /***** state of the attached instance, if the solver data are shared *****/
+
+      struct sca_solv_instanceS* instance;	/* attached instance or NULL */
+      double* xp_data;			/* own vector xp, while an instance is attached */
+
+      /***** work vectors of batches of instances (ana_solv_batch) *****/
+      double* batch_r;			/* right-hand sides, stored by lines */
+      double* batch_x_last;		/* last state vectors, stored by lines */
+      unsigned long batch_len;	/* allocated elements of the work vectors */
+      /***** check point, which is not yet copied *****/
+
+      struct sca_solv_checkpoint_dataS* pending_cp;	/* taken over by the next step */
 
       long critical_row;		/* erroneous line in matrix Z which causes singularity */
       long critical_column;		/* erroneous column in matrix Z which causes singularity */
@@ -96,9 +221,55 @@ typedef struct sca_solv_checkpoint_dataS
 	double* x;
 
 	sca_algT   algorithm;
+	long       reinit_cnt;	/* remaining Euler steps */
+
+	/* a pending check point equals the current state, the vectors are not
+	 * copied before the state changes (see ana_flip_solver_check_point) */
+	int     pending;
+	double* x_src;		/* state vector of the pending check point */
+	double* xp_src;		/* first derivative of the pending check point */
 
 }sca_solv_checkpoint_data;
 
+/****************************************/
+
+typedef struct sca_solv_instanceS
+{
+	unsigned long size; 		/* number of equations */
+
+	double* xp;				/* first derivative of the instance */
+
+	sca_algT cur_algorithm;	/* current method of the instance */
+	long reinit_cnt;			/* remaining Euler steps of the instance */
+
+	struct sca_solv_checkpoint_dataS* pending_cp;	/* pending check point */
+
+}sca_solv_instance;
+
+
+/****************************************/
+
+typedef struct sca_substep_dataS
+{
+	double reltol;				/* relative tolerance */
+	double abstol;				/* absolute tolerance */
+
+	double h;					/* next sub-step size, 0: global step */
+	double proposed_h;			/* smallest proposed sub-step size of the last
+								 * global step, <0: none */
+
+	unsigned long size;		/* number of equations */
+	double* q;					/* interpolated q */
+	double* x_full;			/* solution of the full step */
+
+	struct sca_solv_checkpoint_dataS* cp;		/* begin of the sub-step */
+	struct sca_solv_checkpoint_dataS* cp_begin;	/* begin of the global step */
+
+	long steps;				/* accepted sub-steps */
+	long rejections;			/* rejected sub-steps */
+	double min_h;				/* smallest accepted sub-step */
+
+}sca_substep_data;
 
 /****************************************/
 
@@ -0,0 +1,499 @@
+/*****************************************************************************
+
+    Copyright 2010
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+ ana_solve_woodbury.c - description
+
+ Original Author: Karsten Einwich Fraunhofer IIS/EAS Dresden
+
+ Created on: 22.10.2009
+
+ *****************************************************************************/
+
+/**
+ * @file 	ana_solve_woodbury.c
+ * @brief	Source-file to define methods <i>ana_update_woodbury</i>,
+ * <i>ana_solve_woodbury</i> and <i>ana_free_woodbury</i>
+ *
+ * If only a few lines of the matrix \f$Z\f$ change (e.g. by a switch), the
+ * factorization of the last matrix \f$Z_0\f$ is kept and the solution of
+ * \f$Z = Z_0 + E_R\,\Delta Z_R\f$ is computed by the formula of Woodbury:
+ * \f[
+ * Z^{-1} r = y - U\,C^{-1} \Delta Z_R\,y, \quad y = Z_0^{-1} r, \quad
+ * U = Z_0^{-1} E_R, \quad C = I + \Delta Z_R\,U
+ * \f]
+ * Here, \f$R\f$ is the set of the \f$k\f$ changed lines, \f$E_R\f$ the
+ * corresponding unit vectors and \f$\Delta Z_R\f$ the changed lines of
+ * \f$Z - Z_0\f$.
+ */
+
+/*****************************************************************************/
+
+
+#include "ana_solv_data.h"
+#include "ma_typedef.h"
+#include "ma_util.h"
+#include "ma_sparse.h"
+#include "linear_analog_solver.h"
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+/****************************************/
+
+/** relative pivot tolerance for the capacitance matrix */
+#define WOODBURY_PIV_REL_TOL 1.0e-10
+
+/****************************************/
+
+static void ana_lowrank_arrays_free(sca_lowrank_update* upd)
+{
+	if(upd->lines!=NULL) free(upd->lines);
+	if(upd->ptr!=NULL)   free(upd->ptr);
+	if(upd->col!=NULL)   free(upd->col);
+	if(upd->val!=NULL)   free(upd->val);
+	if(upd->zu!=NULL)    free(upd->zu);
+	if(upd->cap!=NULL)   free(upd->cap);
+	if(upd->piv!=NULL)   free(upd->piv);
+	if(upd->t!=NULL)     free(upd->t);
+
+	upd->lines=NULL;
+	upd->ptr=NULL;
+	upd->col=NULL;
+	upd->val=NULL;
+	upd->zu=NULL;
+	upd->cap=NULL;
+	upd->piv=NULL;
+	upd->t=NULL;
+
+	upd->rank=0;
+}
+
+/****************************************/
+
+/**
+ * LU decomposition with partial pivoting of the dense capacitance matrix
+ * (row-major, dimension k), the pivot lines are stored in <i>piv</i>.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>		4 - matrix (nearly) singular
+ *  </ul>
+ */
+static int ana_lowrank_decomp(double* c, long* piv, long k)
+{
+	long i, j, l, p;
+	double cmax, w;
+
+	cmax=0.0;
+	for(i=0;i<k*k;i++) if(fabs(c[i])>cmax) cmax=fabs(c[i]);
+
+	for(l=0;l<k;l++)
+	{
+		p=l;
+		for(i=l+1;i<k;i++)
+			if(fabs(c[i*k+l])>fabs(c[p*k+l])) p=i;
+
+		piv[l]=p;
+
+		if(fabs(c[p*k+l]) <= WOODBURY_PIV_REL_TOL*cmax)
+			return 4;
+
+		if(p!=l)
+		{
+			for(j=0;j<k;j++)
+			{
+				w=c[l*k+j]; c[l*k+j]=c[p*k+j]; c[p*k+j]=w;
+			}
+		}
+
+		w=1.0/c[l*k+l];
+		c[l*k+l]=w;
+
+		for(i=l+1;i<k;i++)
+		{
+			c[i*k+l]*=w;
+			for(j=l+1;j<k;j++)
+				c[i*k+j]-=c[i*k+l]*c[l*k+j];
+		}
+	}
+
+	return 0;
+}
+
+/****************************************/
+
+/**
+ * solves \f$C s = t\f$ with the decomposition of <i>ana_lowrank_decomp</i>,
+ * <i>t</i> is overwritten by the solution
+ */
+static void ana_lowrank_solve(double* c, long* piv, long k, double* t)
+{
+	long i, j;
+	double w;
+
+	for(i=0;i<k;i++)
+	{
+		if(piv[i]!=i)
+		{
+			w=t[i]; t[i]=t[piv[i]]; t[piv[i]]=w;
+		}
+	}
+
+	for(i=1;i<k;i++)
+		for(j=0;j<i;j++) t[i]-=c[i*k+j]*t[j];
+
+	for(i=k-1;i>=0;i--)
+	{
+		for(j=i+1;j<k;j++) t[i]-=c[i*k+j]*t[j];
+		t[i]*=c[i*k+i];
+	}
+}
+
+/****************************************/
+
+/**
+ * The method <i>ana_update_woodbury</i> compares the newly generated matrix
+ * <i>sdata->sZ_new</i> with the values the current factorization of \f$Z\f$
+ * for the method <i>alg</i> was computed for. If the structure is unchanged
+ * and at most <i>sdata->woodbury_max_rank</i> lines differ, the factorization
+ * is kept and a low-rank update is prepared, which is applied by
+ * <i>ana_solve_woodbury</i>. A former update of \f$Z\f$ is replaced, thus
+ * the rank is always the one of the accumulated changes since the last
+ * factorization. The new matrix is taken over from <i>sdata->sZ_new</i>.
+ *
+ *  @return
+ *  <ul><li>    0 - okay, update prepared
+ *  <li>        2 - not enough memory
+ *  <li>		3 - structure changed or too many changed lines
+ *  <li>		4 - capacitance matrix singular
+ *  </ul>
+ *  For a return value unequal 0 a refactorization is required.
+ */
+int ana_update_woodbury(sca_solv_data* sdata, int alg)
+{
+	sca_lowrank_update* upd;
+	sca_fact_cache_entry* active;
+	struct sparse* sZ;
+	struct sparse* sZn;
+	struct spcode* code;
+	struct spflat* flat;
+	long size, k, nch, i, j, l, m;
+	long kk;
+	double* r;
+	double* zu;
+	int err;
+
+	if(alg==EULER)
+	{
+		upd   =&(sdata->lowrank_euler);
+		active=&(sdata->active_euler);
+		sZ    =sdata->sZ_euler;
+		code  =sdata->code_euler;
+		flat  =sdata->flat_euler;
+	}
+	else
+	{
+		upd   =&(sdata->lowrank_trapez);
+		active=&(sdata->active_trapez);
+		sZ    =sdata->sZ_trapez;
+		code  =sdata->code_trapez;
+		flat  =sdata->flat_trapez;
+	}
+
+	sZn =sdata->sZ_new;
+	size=(long)sdata->size;
+
+	if(sdata->woodbury_max_rank<=0 || sZ==NULL || active->values==NULL
+			|| active->nvalues!=sZn->nel
+			|| MA_LequSparseCheckPattern(sZn, code)!=0)
+		return 3;
+
+	/* count changed lines with respect to the factorized values */
+	k=0;
+	nch=0;
+	for(i=0;i<sZn->m;i++)
+	{
+		m=0;
+		for(kk=sZn->ia[i];kk<sZn->ia[i+1];kk++)
+			if(sZn->a[kk]!=active->values[kk]) m++;
+
+		if(m>0)
+		{
+			k++;
+			nch+=m;
+		}
+	}
+
+	if(k>sdata->woodbury_max_rank)
+		return 3;
+
+	ana_lowrank_arrays_free(upd);
+
+	if(k>0)
+	{
+		upd->lines=(long*)malloc((unsigned)k*sizeof(long));
+		upd->ptr  =(long*)malloc((unsigned)(k+1)*sizeof(long));
+		upd->col  =(long*)malloc((unsigned)nch*sizeof(long));
+		upd->val  =(double*)malloc((unsigned)nch*sizeof(double));
+		upd->zu   =(double*)malloc((unsigned)(size*k)*sizeof(double));
+		upd->cap  =(double*)malloc((unsigned)(k*k)*sizeof(double));
+		upd->piv  =(long*)malloc((unsigned)k*sizeof(long));
+		upd->t    =(double*)malloc((unsigned)k*sizeof(double));
+
+		if(upd->lines==NULL || upd->ptr==NULL || upd->col==NULL
+				|| upd->val==NULL || upd->zu==NULL || upd->cap==NULL
+				|| upd->piv==NULL || upd->t==NULL)
+		{
+			ana_lowrank_arrays_free(upd);
+			return 2;
+		}
+
+		/* changed lines of Z - Z_0 */
+		j=0;
+		nch=0;
+		for(i=0;i<sZn->m;i++)
+		{
+			m=nch;
+			for(kk=sZn->ia[i];kk<sZn->ia[i+1];kk++)
+			{
+				if(sZn->a[kk]!=active->values[kk])
+				{
+					upd->col[nch]=sZn->ja[kk];
+					upd->val[nch]=sZn->a[kk]-active->values[kk];
+					nch++;
+				}
+			}
+
+			if(nch>m)
+			{
+				upd->lines[j]=i;
+				upd->ptr[j]=m;
+				j++;
+			}
+		}
+		upd->ptr[k]=nch;
+
+		/* U = Z_0^-1 E_R */
+		r=sdata->r1;
+		for(j=0;j<k;j++)
+		{
+			zu=upd->zu+j*size;
+
+			memset(r,0,size*sizeof(double));
+			r[upd->lines[j]]=1.0;
+
+			if(flat->n > 0)
+				MA_LequSparseSolutFlat(flat, r, zu);
+			else
+				MA_LequSparseSolut(sZ, code, r, zu);
+		}
+
+		/* C = I + dZ_R U */
+		for(i=0;i<k;i++)
+		{
+			for(j=0;j<k;j++)
+			{
+				zu=upd->zu+j*size;
+
+				upd->cap[i*k+j] = (i==j) ? 1.0 : 0.0;
+				for(l=upd->ptr[i];l<upd->ptr[i+1];l++)
+					upd->cap[i*k+j]+=upd->val[l]*zu[upd->col[l]];
+			}
+		}
+
+		err=ana_lowrank_decomp(upd->cap, upd->piv, k);
+		if(err)
+		{
+			ana_lowrank_arrays_free(upd);
+			return err;
+		}
+	}
+
+	/* take over the updated matrix, the old one becomes the scratch matrix */
+	if(upd->sZ==NULL)
+	{
+		upd->sZ=(struct sparse*)calloc(1,(unsigned)sizeof(struct sparse));
+		if(upd->sZ==NULL)
+		{
+			ana_lowrank_arrays_free(upd);
+			return 2;
+		}
+		MA_InitSparse(upd->sZ);
+	}
+
+	sdata->sZ_new=upd->sZ;
+	upd->sZ      =sZn;
+
+	upd->rank     =k;
+	upd->cost     =0.0;
+	upd->key      =sdata->cache_key;
+	upd->key_valid=sdata->cache_key_valid;
+	upd->h        =sdata->h;
+
+	return 0;
+}
+
+/****************************************/
+
+/**
+ * The method <i>ana_consolidate_woodbury</i> refactorizes the updated matrix
+ * of the method <i>alg</i> with the code of the current factorization, thus
+ * the low-rank correction becomes obsolete. If a pivot is rejected the
+ * current factorization and the update are kept.
+ */
+static void ana_consolidate_woodbury(sca_solv_data* sdata, int alg)
+{
+	sca_lowrank_update* upd;
+	sca_fact_cache_entry* active;
+	struct sparse** sZp;
+	struct sparse* sZ_tmp;
+	struct spcode* code;
+	struct spflat* flat;
+
+	if(alg==EULER)
+	{
+		upd   =&(sdata->lowrank_euler);
+		active=&(sdata->active_euler);
+		sZp   =&(sdata->sZ_euler);
+		code  =sdata->code_euler;
+		flat  =sdata->flat_euler;
+	}
+	else
+	{
+		upd   =&(sdata->lowrank_trapez);
+		active=&(sdata->active_trapez);
+		sZp   =&(sdata->sZ_trapez);
+		code  =sdata->code_trapez;
+		flat  =sdata->flat_trapez;
+	}
+
+	/* the current factorization must survive a rejected pivot */
+	if(MA_CopySparse(sdata->sZ_new, *sZp)!=0
+			|| MA_LequSparseRefactor(sdata->sZ_new, upd->sZ, code)!=0)
+	{
+		upd->cost=-HUGE_VAL; /* no further attempt for this update */
+		return;
+	}
+
+	sZ_tmp        = *sZp;
+	*sZp          = sdata->sZ_new;
+	sdata->sZ_new = sZ_tmp;
+
+	MA_LequSparseLowerValues(*sZp, flat);
+
+	if(active->values!=NULL && active->nvalues==upd->sZ->nel)
+		memcpy(active->values, upd->sZ->a, upd->sZ->nel*sizeof(double));
+	else
+		active->nvalues=0; /* values lost by resize of the cache */
+
+	if(active->valid)
+	{
+		active->valid=upd->key_valid;
+		active->key  =upd->key;
+		active->h    =upd->h;
+	}
+
+	sdata->refactor_cnt++;
+	sdata->consolidate_cnt++;
+
+	ana_lowrank_arrays_free(upd);
+}
+
+/****************************************/
+
+/**
+ * The method <i>ana_solve_woodbury</i> corrects the solution \f$x = Z_0^{-1} r\f$
+ * computed with the current factorization of the method <i>alg</i> to the
+ * solution of the updated matrix prepared by <i>ana_update_woodbury</i>.
+ * If the flops spent for corrections exceed the flops of a decomposition,
+ * the updated matrix is refactorized.
+ */
+void ana_solve_woodbury(
+		sca_solv_data* sdata,
+		int alg,
+		double* x
+		)
+{
+	sca_lowrank_update* upd;
+	struct spcode* code;
+	long size, k, i, j, l;
+	double* zu;
+	double* t;
+
+	upd =(alg==EULER) ? &(sdata->lowrank_euler) : &(sdata->lowrank_trapez);
+	code=(alg==EULER) ? sdata->code_euler : sdata->code_trapez;
+
+	k   =upd->rank;
+	size=(long)sdata->size;
+	t   =upd->t;
+
+	if(k<=0) return;
+
+	/* t = dZ_R x */
+	for(i=0;i<k;i++)
+	{
+		t[i]=0.0;
+		for(l=upd->ptr[i];l<upd->ptr[i+1];l++)
+			t[i]+=upd->val[l]*x[upd->col[l]];
+	}
+
+	ana_lowrank_solve(upd->cap, upd->piv, k, t);
+
+	/* x = x - U t */
+	for(j=0;j<k;j++)
+	{
+		zu=upd->zu+j*size;
+		for(i=0;i<size;i++) x[i]-=zu[i]*t[j];
+	}
+
+	upd->cost+=2.0*(double)(upd->ptr[k] + k*k + size*k);
+
+	if(upd->cost > (double)code->dec_flop)
+		ana_consolidate_woodbury(sdata, alg);
+}
+
+/****************************************/
+
+/**
+ * The method <i>ana_free_woodbury</i> removes the low-rank updates.
+ */
+void ana_free_woodbury(sca_solv_data* sdata)
+{
+	ana_lowrank_arrays_free(&(sdata->lowrank_euler));
+	ana_lowrank_arrays_free(&(sdata->lowrank_trapez));
+
+	if(sdata->lowrank_euler.sZ!=NULL)
+	{
+		MA_FreeSparse(sdata->lowrank_euler.sZ);
+		free(sdata->lowrank_euler.sZ);
+		sdata->lowrank_euler.sZ=NULL;
+	}
+
+	if(sdata->lowrank_trapez.sZ!=NULL)
+	{
+		MA_FreeSparse(sdata->lowrank_trapez.sZ);
+		free(sdata->lowrank_trapez.sZ);
+		sdata->lowrank_trapez.sZ=NULL;
+	}
+}
+
+/****************************************/
@@ -0,0 +1,389 @@
+/*****************************************************************************
+
+    Copyright 2010
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+ ana_substeps.c - description
+
+ Original Author: Karsten Einwich Fraunhofer IIS/EAS Dresden
+
+ Created on: 22.10.2009
+
+ *****************************************************************************/
+
+/**
+ * @file 	ana_substeps.c
+ * @brief	Source-file to define method <i>ana_solv_substeps</i>
+ *
+ * A global timestep is solved by error controlled sub-steps. The local error
+ * of a sub-step is estimated by step doubling: one step of size \f$h\f$ is
+ * compared with two steps of size \f$h/2\f$, the result of the two steps is
+ * kept. Both start from the same check point, which contains the current
+ * method and the remaining Euler steps, thus the full step and the half steps
+ * are calculated with the same method.
+ */
+
+/*****************************************************************************/
+
+
+#include "ana_solv_data.h"
+#include "ma_typedef.h"
+#include "ma_util.h"
+#include "ma_sparse.h"
+#include "linear_analog_solver.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* the sub-step sizes are dt/2^level, sub-steps of the maximum level
+ * (dt/1024) are accepted without error control */
+#define SCA_SUBSTEP_MAX_LEVEL 10
+
+/* limits of the step size change per sub-step */
+#define SCA_SUBSTEP_MAX_FACTOR 2.0
+#define SCA_SUBSTEP_MIN_FACTOR 0.25
+
+/****************************************/
+
+int ana_alloc_substep_data(sca_substep_data** ssdatap)
+{
+	sca_substep_data* ss;
+
+	ss=(sca_substep_data*)calloc(1,sizeof(sca_substep_data));
+	if(ss==NULL) return 2;
+
+	ss->abstol=1e-6;
+	ss->proposed_h=-1.0;
+	ss->min_h=1e64;
+
+	(*ssdatap)=ss;
+
+	return 0;
+}
+
+/****************************************/
+
+void ana_free_substep_data(sca_substep_data** ssdatap)
+{
+	if((*ssdatap)==NULL) return;
+
+	if((*ssdatap)->q!=NULL)      free((*ssdatap)->q);
+	if((*ssdatap)->x_full!=NULL) free((*ssdatap)->x_full);
+	free_checkpoint_data(&(*ssdatap)->cp);
+	free_checkpoint_data(&(*ssdatap)->cp_begin);
+
+	free(*ssdatap);
+	(*ssdatap)=NULL;
+}
+
+/****************************************/
+
+void ana_set_substep_tolerances(
+		sca_substep_data* ssdata,
+		double reltol,
+		double abstol)
+{
+	ssdata->reltol=reltol;
+	ssdata->abstol=abstol;
+}
+
+/****************************************/
+
+double ana_get_substep_timestep(sca_substep_data* ssdata)
+{
+	return ssdata->h;
+}
+
+/****************************************/
+
+void ana_set_substep_timestep(sca_substep_data* ssdata, double h)
+{
+	ssdata->h=h;
+}
+
+/****************************************/
+
+double ana_get_substep_proposed_timestep(sca_substep_data* ssdata)
+{
+	return ssdata->proposed_h;
+}
+
+/****************************************/
+
+void ana_get_substep_statistics(
+		sca_substep_data* ssdata,
+		long* steps,
+		long* rejections,
+		double* min_h)
+{
+	(*steps)=ssdata->steps;
+	(*rejections)=ssdata->rejections;
+	(*min_h)=ssdata->min_h;
+}
+
+/****************************************/
+
+/**
+ * returns the level of the largest sub-step size \f$dt/2^{level}\f$, which
+ * is not larger than <i>h</i>
+ */
+static int ana_substep_level(double h, double dt)
+{
+	int level=0;
+
+	while((level<SCA_SUBSTEP_MAX_LEVEL) && (ldexp(dt,-level)>h*(1.0+1e-12)))
+	{
+		level++;
+	}
+
+	return level;
+}
+
+/****************************************/
+
+/**
+ * Solves one sub-step of size <i>h</i> ending at <i>t</i> (related to the
+ * begin of the global step). The sub-step sizes are \f$dt/2^{level}\f$,
+ * thus with an enabled factorization cache (a few entries for the step
+ * sizes \f$h\f$ and \f$h/2\f$ and their neighbors) the factorization of
+ * the step size is found in the cache. The current method and the remaining
+ * Euler steps are kept - <i>ana_reinit_sparse</i> restarts with the Euler
+ * method, if the current method is Euler.
+ */
+static int ana_solv_substep(
+		sparse_matrix* sA,
+		sparse_matrix* sB,
+		double* q_last,
+		double* q_end,
+		double* x,
+		double t,
+		double h,
+		double dt,
+		sca_solv_data** sdatap,
+		sca_substep_data* ss)
+{
+	unsigned long i;
+	double w;
+	int err;
+
+	if((*sdatap)->h!=h)
+	{
+		if((*sdatap)->cur_algorithm==EULER)
+			err=ana_init_sparse(sA, sB, h, sdatap, 2);
+		else
+			err=ana_reinit_sparse(sA, sB, h, sdatap, 2);
+
+		if(err) return err;
+	}
+
+	/* linear interpolation of q between the global timepoints */
+	w=t/dt;
+	for(i=0;i<ss->size;i++)
+	{
+		ss->q[i]=q_last[i]+(q_end[i]-q_last[i])*w;
+	}
+
+	ana_solv(ss->q, x, *sdatap);
+
+	return 0;
+}
+
+/****************************************/
+
+/**
+ * The method <i>ana_solv_substeps</i> solves the global timestep <i>dt</i>
+ * of \f$A\,\dot{x} + B\,x + q = 0\f$ by sub-steps, the vector \f$q\f$ is
+ * interpolated linearly between <i>q_last</i> (begin of the global step) and
+ * <i>q</i> (end of the global step).
+ *
+ * The sub-step size follows from the error related to the tolerances
+ * \f$err\f$ and the order \f$p\f$ of the method of the sub-step (1 for
+ * Euler, 2 for the trapezoidal method and BDF2) by
+ * \f$h_{new} = 0.9\,h\,err^{-1/(p+1)}\f$, limited to a change of 0.25..2,
+ * and is rounded down to \f$dt/2^{level}\f$ (level 0..10). The sub-steps
+ * before the global timepoint are reduced to the largest of these sizes
+ * fitting into the rest of the global step. Thus only a few step sizes
+ * occur and their factorizations are reused from the factorization cache
+ * (see <i>ana_set_factorization_cache_size</i>).
+ * The last accepted sub-step size is used for the next global step.
+ *
+ * If a reinitialization fails, the state at the begin of the global step is
+ * restored and the error is returned, the position of the error is available
+ * by <i>ana_get_error_position</i>.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        1 - reallocation of NULL pointer
+ *  <li>        2 - not enough memory
+ *  <li>		3 - dimension erroneous
+ *  <li>		4 - matrix singular
+ *  <li>		6 - no sparse matrix
+ *  </ul>
+ */
+int ana_solv_substeps(
+		sparse_matrix* sA,
+		sparse_matrix* sB,
+		double* q_last,
+		double* q,
+		double* x,
+		double dt,
+		sca_solv_data** sdatap,
+		sca_substep_data* ssdata)
+{
+	sca_substep_data* ss=ssdata;
+	unsigned long size;
+	unsigned long i;
+	long total, reached, units;
+	double h_cur;
+	double err, e, tol, fac;
+	int level, level_cur;
+	int order;
+	int last, shortened;
+	int rerr;
+
+	if(((*sdatap)==NULL) || (ss==NULL)) return 1;
+
+	size=(*sdatap)->size;
+
+	if(ss->size!=size)
+	{
+		if(ss->q!=NULL)      free(ss->q);
+		if(ss->x_full!=NULL) free(ss->x_full);
+		ss->q=NULL;
+		ss->x_full=NULL;
+		ss->size=0;
+
+		if(size>0)
+		{
+			ss->q=(double*)malloc(size*sizeof(double));
+			ss->x_full=(double*)malloc(size*sizeof(double));
+			if((ss->q==NULL) || (ss->x_full==NULL)) return 2;
+		}
+		ss->size=size;
+	}
+
+	level=0;
+	if((ss->h>0.0) && (ss->h<dt)) level=ana_substep_level(ss->h, dt);
+
+	/* the time within the global step is counted in units of the smallest
+	 * sub-step, thus the global timepoint is reached exactly */
+	total=1L<<SCA_SUBSTEP_MAX_LEVEL;
+	reached=0;
+	rerr=0;
+	ss->proposed_h=-1.0;
+
+	if(ana_store_solver_check_point(*sdatap, x, &ss->cp_begin)) return 2;
+	if(ana_store_solver_check_point(*sdatap, x, &ss->cp))       return 2;
+
+	while(reached<total)
+	{
+		/* the sub-steps before the global timepoint are reduced to fit */
+		level_cur=level;
+		while((1L<<(SCA_SUBSTEP_MAX_LEVEL-level_cur)) > total-reached)
+		{
+			level_cur++;
+		}
+
+		units=1L<<(SCA_SUBSTEP_MAX_LEVEL-level_cur);
+		h_cur=ldexp(dt,-level_cur);
+		shortened=(level_cur!=level);
+		last=(reached+units==total);
+
+		/* order of the method, which starts the sub-step */
+		order=((*sdatap)->cur_algorithm==EULER) ? 1 : 2;
+
+		/* one step of size h */
+		rerr=ana_solv_substep(sA, sB, q_last, q, x,
+				dt*(double)(reached+units)/(double)total, h_cur, dt,
+				sdatap, ss);
+		if(rerr) break;
+
+		if(size>0) memcpy(ss->x_full, x, size*sizeof(double));
+
+		/* two steps of size h/2 from the same state and method */
+		ana_restore_solver_check_point(*sdatap, x, &ss->cp);
+
+		rerr=ana_solv_substep(sA, sB, q_last, q, x,
+				dt*(double)(2*reached+units)/(double)(2*total), 0.5*h_cur, dt,
+				sdatap, ss);
+		if(rerr) break;
+
+		rerr=ana_solv_substep(sA, sB, q_last, q, x,
+				dt*(double)(reached+units)/(double)total, 0.5*h_cur, dt,
+				sdatap, ss);
+		if(rerr) break;
+
+		/* error related to the tolerances */
+		err=0.0;
+		for(i=0;i<size;i++)
+		{
+			tol=ss->abstol+ss->reltol*fabs(x[i]);
+			e=fabs(x[i]-ss->x_full[i])/tol;
+			if(e>err) err=e;
+		}
+
+		/* the local error is of the order p+1 */
+		fac=SCA_SUBSTEP_MAX_FACTOR;
+		if(err>0.0) fac=0.9*pow(err,-1.0/(double)(order+1));
+		if(fac>SCA_SUBSTEP_MAX_FACTOR) fac=SCA_SUBSTEP_MAX_FACTOR;
+		if(fac<SCA_SUBSTEP_MIN_FACTOR) fac=SCA_SUBSTEP_MIN_FACTOR;
+
+		if((err<=1.0) || (level_cur>=SCA_SUBSTEP_MAX_LEVEL))
+		{
+			ss->steps++;
+			if(h_cur<ss->min_h) ss->min_h=h_cur;
+
+			/* a shortened step says nothing about larger steps */
+			if(!shortened)
+			{
+				if((ss->proposed_h<0.0) || (h_cur*fac<ss->proposed_h))
+				{
+					ss->proposed_h=h_cur*fac;
+				}
+				level=ana_substep_level(h_cur*fac, dt);
+			}
+
+			if(last) break;
+
+			reached+=units;
+			ana_store_solver_check_point(*sdatap, x, &ss->cp);
+		}
+		else
+		{
+			ss->rejections++;
+			ana_restore_solver_check_point(*sdatap, x, &ss->cp);
+
+			/* fac < 0.9, thus the level is increased */
+			level=ana_substep_level(h_cur*fac, dt);
+		}
+	}
+
+	if(rerr)
+	{
+		/* the global step is aborted */
+		ana_restore_solver_check_point(*sdatap, x, &ss->cp_begin);
+		ss->proposed_h=-1.0;
+		return rerr;
+	}
+
+	ss->h=ldexp(dt,-level);
+
+	return 0;
+}
@@ -41,10 +41,12 @@
  * @date	November 07, 2012
  * @brief	Source-file to define methods <i>ana_get_error_position</i>,
  * <i>ana_get_algorithm</i>, <i>ana_set_algorithm</i>, <i>ana_get_dimension</i>,
+ * <i>ana_get_timestep</i>,
  * <i>ana_get_pivot_flop</i>, <i>ana_get_dec_flop</i>, <i>ana_get_sol_flop</i>,
  * <i>ana_set_variable_step_size</i>, <i>ana_store_check_point</i>,
- * <i>ana_restore_check_point</i>,  <i>ana_store_intermediate_check_point</i>
- * and <i>ana_restore_intermediate_check_point</i>
+ * <i>ana_restore_check_point</i>,  <i>ana_store_intermediate_check_point</i>,
+ * <i>ana_restore_intermediate_check_point</i>, the copy-free check points
+ * and the methods for instances sharing the solver data
  */
 
 /*****************************************************************************/
@@ -54,6 +56,7 @@
 #include "ma_typedef.h"
 #include "ma_util.h"
 #include "ma_sparse.h"
+#include "linear_analog_solver.h"
 #include <string.h>
 #include <stdlib.h>
 
@@ -71,6 +74,7 @@ void ana_get_error_position(sca_solv_data* data,long* row,long* column)
 int ana_get_algorithm(sca_solv_data* data)
 {
 	if (data->cur_algorithm == TRAPEZ) return 2;
+	else if (data->cur_algorithm == BDF2) return 3;
 	else return 1;
 }
 
@@ -80,6 +84,7 @@ void ana_set_algorithm(sca_solv_data* data, int alg)
 {
 	if (alg == 0) data->algorithm = EULER;
 	else if (alg == 1) data->algorithm = TRAPEZ;
+	else if (alg == 2) data->algorithm = BDF2;
 }
 
 /****************************************/
@@ -101,6 +106,13 @@ long int ana_get_dimension(sca_solv_data* data)
 
 /****************************************/
 
+double ana_get_timestep(sca_solv_data* data)
+{
+	return data->h;
+}
+
+/****************************************/
+
 long int ana_get_pivot_flop(sca_solv_data* data, int alg)
 {
 	if (alg == 1) return data->code_euler->pivot_flop;
@@ -125,6 +137,167 @@ long int ana_get_sol_flop(sca_solv_data* data, int alg)
 
 /****************************************/
 
+void ana_get_fill_ins(sca_solv_data* data, int alg, long* fill_ins,
+		long* fill_ins_after_dec)
+{
+	struct spcode* code;
+
+	if (alg == 1) code=data->code_euler;
+	else code=data->code_trapez;
+
+	(*fill_ins)=code->fill_ins;
+	(*fill_ins_after_dec)=code->fill_ins_after_dec;
+}
+
+/****************************************/
+
+void ana_get_diagonal_blocks(sca_solv_data* data, int alg, long* nblocks,
+		long* nsingle)
+{
+	struct spcode* code;
+
+	if (alg == 1) code=data->code_euler;
+	else code=data->code_trapez;
+
+	(*nblocks)=code->nblocks;
+	(*nsingle)=code->nsingle;
+}
+
+/****************************************/
+
+void ana_set_ordering(sca_solv_data* data, int ordering)
+{
+	if(ordering==data->ordering) return;
+
+	data->ordering=ordering;
+
+	/* the next generation must not reuse the codes */
+	if(data->code_euler!=NULL)  data->code_euler->pattern_nd=0;
+	if(data->code_trapez!=NULL) data->code_trapez->pattern_nd=0;
+}
+
+/****************************************/
+
+void ana_set_factorization_cache_size(sca_solv_data* data, long size)
+{
+	sca_fact_cache_entry* cache;
+
+	if(size<0) size=0;
+	if(size==data->cache_size) return;
+
+	ana_free_factorization_cache(data);
+
+	if(data->cache!=NULL) free(data->cache);
+	data->cache=NULL;
+	data->cache_size=0;
+
+	if(size==0) return;
+
+	cache=(sca_fact_cache_entry*)calloc((unsigned)size,
+			sizeof(sca_fact_cache_entry));
+	if(cache==NULL) return;  /* cache disabled */
+
+	data->cache=cache;
+	data->cache_size=size;
+}
+
+/****************************************/
+
+void ana_set_factorization_key(
+		sca_solv_data* data,
+		unsigned long long key,
+		int valid)
+{
+	data->cache_key=key;
+	data->cache_key_valid=valid;
+}
+
+/****************************************/
+
+void ana_free_factorization_cache(sca_solv_data* data)
+{
+	sca_fact_cache_entry* entry;
+	long i;
+
+	for(i=0;i<data->cache_size;i++)
+	{
+		entry=&(data->cache[i]);
+
+		if(entry->sZ!=NULL)
+		{
+			MA_FreeSparse(entry->sZ);
+			free(entry->sZ);
+		}
+
+		if(entry->code!=NULL)
+		{
+			MA_FreeCode(entry->code);
+			free(entry->code);
+		}
+
+		if(entry->flat!=NULL)
+		{
+			MA_FreeFlatCode(entry->flat);
+			free(entry->flat);
+		}
+
+		if(entry->values!=NULL) free(entry->values);
+
+		memset(entry,0,sizeof(sca_fact_cache_entry));
+	}
+
+	if(data->active_euler.values!=NULL)  free(data->active_euler.values);
+	if(data->active_trapez.values!=NULL) free(data->active_trapez.values);
+
+	memset(&(data->active_euler),0,sizeof(sca_fact_cache_entry));
+	memset(&(data->active_trapez),0,sizeof(sca_fact_cache_entry));
+}
+
+/****************************************/
+
+void ana_get_factorization_cache_statistics(
+		sca_solv_data* data,
+		long* hits,
+		long* misses)
+{
+	(*hits)=data->cache_hits;
+	(*misses)=data->cache_misses;
+}
+
+/****************************************/
+
+void ana_set_woodbury_max_rank(sca_solv_data* data, long rank)
+{
+	if(rank<0) rank=0;
+
+	/* a pending update is kept until the next reinitialization */
+	data->woodbury_max_rank=rank;
+}
+
+/****************************************/
+
+void ana_get_woodbury_statistics(
+		sca_solv_data* data,
+		long* updates,
+		long* consolidations)
+{
+	(*updates)=data->woodbury_cnt;
+	(*consolidations)=data->consolidate_cnt;
+}
+
+/****************************************/
+
+void ana_get_factorization_statistics(
+		sca_solv_data* data,
+		long* codegen_cnt,
+		long* refactor_cnt)
+{
+	(*codegen_cnt)=data->codegen_cnt;
+	(*refactor_cnt)=data->refactor_cnt;
+}
+
+/****************************************/
+
 
 int ana_store_solver_check_point(
 		  sca_solv_data* sdata,		            /**< internal solver data */
@@ -140,11 +313,17 @@ int ana_store_solver_check_point(
 	size=sdata->size;
 	dsize=size*sizeof(double);
 
+	/*the copy replaces a pending check point*/
+	if(sdata->pending_cp==(*cp_data)) sdata->pending_cp=NULL;
+
 	if(*cp_data==NULL)
 	{
 		(*cp_data)=(sca_solv_checkpoint_data*)malloc(sizeof(sca_solv_checkpoint_data));
 		if((*cp_data)==NULL) return 2;
 		(*cp_data)->size=size;
+		(*cp_data)->pending=0;
+		(*cp_data)->x_src=NULL;
+		(*cp_data)->xp_src=NULL;
 
 		if(size>0)
 		{
@@ -200,9 +379,11 @@ int ana_store_solver_check_point(
 	/*store x and xp */
 	memcpy((*cp_data)->x,  x,         dsize);
 	memcpy((*cp_data)->xp, sdata->xp, dsize);
+	(*cp_data)->pending=0;
 
 	/*store cur_algorithm state*/
 	(*cp_data)->algorithm=sdata->cur_algorithm;
+	(*cp_data)->reinit_cnt=sdata->reinit_cnt;
 
 	return 0;
 }
@@ -225,11 +406,26 @@ int ana_restore_solver_check_point(
 	/*sizes incompatible*/
 	if(((*cp_data)==NULL) || (size!=(*cp_data)->size)) return 2;
 
+	/*the current state is changed - a pending check point must be copied*/
+	if(sdata->pending_cp!=(*cp_data)) ana_resolve_solver_check_point(sdata);
+
 	/*restore xp and x*/
-	memcpy(x,        (*cp_data)->x,  size*sizeof(double));
-	memcpy(sdata->xp,(*cp_data)->xp, size*sizeof(double));
+	if((*cp_data)->pending)
+	{
+		/*the check point is not yet copied*/
+		if(x!=(*cp_data)->x_src)
+			memcpy(x,        (*cp_data)->x_src,  size*sizeof(double));
+		if(sdata->xp!=(*cp_data)->xp_src)
+			memcpy(sdata->xp,(*cp_data)->xp_src, size*sizeof(double));
+	}
+	else
+	{
+		memcpy(x,        (*cp_data)->x,  size*sizeof(double));
+		memcpy(sdata->xp,(*cp_data)->xp, size*sizeof(double));
+	}
 
 	sdata->cur_algorithm=(*cp_data)->algorithm;
+	sdata->reinit_cnt=(*cp_data)->reinit_cnt;
 
 	/*printf("Restore solver checkpoint   alg: %i\n",(*cp_data)->cur_algorithm);*/
 
@@ -257,6 +453,10 @@ int ana_copy_solver_check_point(
 		(*cp_data_dest)->x=(double*)malloc(size*sizeof(double));
 		(*cp_data_dest)->xp=(double*)malloc(size*sizeof(double));
 		(*cp_data_dest)->algorithm=cp_data_source->algorithm;
+		(*cp_data_dest)->reinit_cnt=cp_data_source->reinit_cnt;
+		(*cp_data_dest)->pending=0;
+		(*cp_data_dest)->x_src=NULL;
+		(*cp_data_dest)->xp_src=NULL;
 
 		if((*cp_data_dest)->x==NULL) return 1;
 		if((*cp_data_dest)->xp==NULL) return 1;
@@ -264,10 +464,21 @@ int ana_copy_solver_check_point(
 
 	if(size!=(*cp_data_dest)->size)                 return 2;
 
-	memcpy((*cp_data_dest)->x ,cp_data_source->x, size*sizeof(double));
-	memcpy((*cp_data_dest)->xp,cp_data_source->xp,size*sizeof(double));
+	if(cp_data_source->pending)
+	{
+		/*the source is not yet copied - it equals the current state*/
+		memcpy((*cp_data_dest)->x ,cp_data_source->x_src, size*sizeof(double));
+		memcpy((*cp_data_dest)->xp,cp_data_source->xp_src,size*sizeof(double));
+	}
+	else
+	{
+		memcpy((*cp_data_dest)->x ,cp_data_source->x, size*sizeof(double));
+		memcpy((*cp_data_dest)->xp,cp_data_source->xp,size*sizeof(double));
+	}
 
 	(*cp_data_dest)->algorithm=cp_data_source->algorithm;
+	(*cp_data_dest)->reinit_cnt=cp_data_source->reinit_cnt;
+	(*cp_data_dest)->pending=0;
 
 	return 0;
 }
@@ -301,11 +512,134 @@ int ana_allocate_solver_check_point(
 
 	(*cp_data)->size=size;
 	(*cp_data)->algorithm=EULER;
+	(*cp_data)->reinit_cnt=0;
+	(*cp_data)->pending=0;
+	(*cp_data)->x_src=NULL;
+	(*cp_data)->xp_src=NULL;
 
 	return 0;
 }
 
 
+/**************************************************************************/
+
+int ana_flip_solver_check_point(
+		  sca_solv_data* sdata,		            /**< internal solver data */
+		  double* x,					        /**< solution vector */
+		  sca_solv_checkpoint_data** cp_data    /**< internal check point data */
+		  )
+{
+	sca_solv_checkpoint_data* cp;
+
+	if(sdata==NULL) return 1;
+
+	/*the first store allocates the check point*/
+	if(((*cp_data)==NULL) || ((*cp_data)->size!=sdata->size) || (sdata->size==0))
+	{
+		return ana_store_solver_check_point(sdata,x,cp_data);
+	}
+
+	cp=*cp_data;
+
+	/*only one check point can refer to the current state*/
+	if(sdata->pending_cp!=cp) ana_resolve_solver_check_point(sdata);
+
+	cp->x_src=x;
+	cp->xp_src=sdata->xp;
+	cp->algorithm=sdata->cur_algorithm;
+	cp->reinit_cnt=sdata->reinit_cnt;
+	cp->pending=1;
+
+	sdata->pending_cp=cp;
+
+	return 0;
+}
+
+/**************************************************************************/
+
+int ana_swap_solver_check_point(
+		  sca_solv_data* sdata,		            /**< internal solver data */
+		  double* x,					        /**< solution vector */
+		  sca_solv_checkpoint_data** cp_data    /**< internal check point data */
+		  )
+{
+	sca_solv_checkpoint_data* cp;
+	unsigned long size;
+	double* tmp;
+
+	if(sdata==NULL) return 1;
+
+	size=sdata->size;
+
+	/*sizes incompatible*/
+	if(((*cp_data)==NULL) || (size!=(*cp_data)->size)) return 2;
+
+	if((*cp_data)->pending || (size==0))
+	{
+		return ana_restore_solver_check_point(sdata,x,cp_data);
+	}
+
+	cp=*cp_data;
+
+	ana_resolve_solver_check_point(sdata);
+
+	/*the state vector belongs to the caller*/
+	memcpy(x,cp->x,size*sizeof(double));
+
+	/*the derivative of the check point becomes the current derivative,
+	 * the check point refers to the current state until the next step*/
+	tmp=sdata->xp;
+	sdata->xp=cp->xp;
+	cp->xp=tmp;
+	if(sdata->instance!=NULL) sdata->instance->xp=sdata->xp;
+
+	sdata->cur_algorithm=cp->algorithm;
+	sdata->reinit_cnt=cp->reinit_cnt;
+
+	cp->x_src=x;
+	cp->xp_src=sdata->xp;
+	cp->pending=1;
+
+	sdata->pending_cp=cp;
+
+	return 0;
+}
+
+/**************************************************************************/
+
+void ana_resolve_solver_check_point(
+		  sca_solv_data* sdata		            /**< internal solver data */
+		  )
+{
+	sca_solv_checkpoint_data* cp;
+
+	if((sdata==NULL) || (sdata->pending_cp==NULL)) return;
+
+	cp=sdata->pending_cp;
+	sdata->pending_cp=NULL;
+
+	if(!cp->pending) return;
+
+	if(cp->size>0)
+	{
+		memcpy(cp->x, cp->x_src, cp->size*sizeof(double));
+		memcpy(cp->xp,cp->xp_src,cp->size*sizeof(double));
+	}
+
+	cp->pending=0;
+}
+
+/**************************************************************************/
+
+void ana_drop_solver_check_point(
+		  sca_solv_checkpoint_data** cp_data    /**< pending check point */
+		  )
+{
+	if((*cp_data)!=NULL) (*cp_data)->pending=0;
+	(*cp_data)=NULL;
+}
+
+
 /**************************************************************************/
 
 void free_checkpoint_data(sca_solv_checkpoint_data** cp_data)
@@ -323,4 +657,114 @@ void free_checkpoint_data(sca_solv_checkpoint_data** cp_data)
 }
 
 
+/**************************************************************************/
+
+int ana_allocate_solver_instance(
+		  unsigned long size,                   /**< number of state variables */
+		  sca_solv_instance** inst              /**< instance state */
+		  )
+{
+	(*inst)=(sca_solv_instance*)malloc(sizeof(sca_solv_instance));
+	if((*inst)==NULL) return 1;
+
+	(*inst)->xp=NULL;
+	if(size>0)
+	{
+		(*inst)->xp=(double*)calloc(size,sizeof(double));
+		if((*inst)->xp==NULL)
+		{
+			free(*inst);
+			(*inst)=NULL;
+			return 1;
+		}
+	}
+
+	(*inst)->size=size;
+	(*inst)->cur_algorithm=EULER;
+	(*inst)->reinit_cnt=0;
+	(*inst)->pending_cp=NULL;
+
+	return 0;
+}
+
+/**************************************************************************/
+
+void ana_free_solver_instance(sca_solv_instance** inst)
+{
+	if((*inst)!=NULL)
+	{
+		ana_drop_solver_check_point(&(*inst)->pending_cp);
+		if((*inst)->xp!=NULL) free((*inst)->xp);
+
+		free(*inst);
+		(*inst)=NULL;
+	}
+}
+
+/**************************************************************************/
+
+void ana_attach_solver_instance(
+		  sca_solv_data* sdata,		            /**< internal solver data */
+		  sca_solv_instance* inst               /**< instance state */
+		  )
+{
+	if((sdata==NULL) || (inst==NULL) || (sdata->instance==inst)) return;
+
+	if(sdata->instance!=NULL)
+	{
+		/*store state of the previous instance*/
+		sdata->instance->cur_algorithm=sdata->cur_algorithm;
+		sdata->instance->reinit_cnt=sdata->reinit_cnt;
+		sdata->instance->pending_cp=sdata->pending_cp;
+	}
+	else
+	{
+		ana_resolve_solver_check_point(sdata);
+		sdata->xp_data=sdata->xp;
+	}
+
+	sdata->xp=inst->xp;
+	sdata->cur_algorithm=inst->cur_algorithm;
+	sdata->reinit_cnt=inst->reinit_cnt;
+	sdata->pending_cp=inst->pending_cp;
+	inst->pending_cp=NULL;
+	sdata->instance=inst;
+}
+
+/**************************************************************************/
+
+void ana_detach_solver_instance(
+		  sca_solv_data* sdata,		            /**< internal solver data */
+		  sca_solv_instance* inst               /**< instance state */
+		  )
+{
+	if((sdata==NULL) || (sdata->instance!=inst) || (inst==NULL)) return;
+
+	inst->cur_algorithm=sdata->cur_algorithm;
+	inst->reinit_cnt=sdata->reinit_cnt;
+	inst->pending_cp=sdata->pending_cp;
+	sdata->pending_cp=NULL;
+
+	sdata->xp=sdata->xp_data;
+	sdata->xp_data=NULL;
+	sdata->instance=NULL;
+}
+
+/**************************************************************************/
+
+void ana_restart_solver_instance(
+		  sca_solv_data* sdata,		            /**< internal solver data */
+		  sca_solv_instance* inst               /**< instance state */
+		  )
+{
+	ana_attach_solver_instance(sdata,inst);
+
+	if(sdata==NULL) return;
+
+	/* start/restart with Euler backward method */
+	sdata->cur_algorithm=EULER;
+	sdata->reinit_cnt=sdata->reinit_steps;
+}
+
+
 /****************************************/
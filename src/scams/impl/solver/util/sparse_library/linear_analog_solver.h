@@ -53,12 +53,22 @@ extern "C"
 
   struct sca_solv_data;				/**< internal solver data */
   struct sca_solv_checkpoint_data;  /**< internal checkpoint data */
+  struct sca_solv_instance;			/**< state of an instance sharing solver data */
   struct sca_coefficients;			/**< stored matrix B and vector q */
+  struct sca_substep_data;			/**< error controlled sub-stepping */
 
   typedef struct  sparse sparse_matrix;  /**< sparse matrix */
 
   /* ana_init.c */
 
+  /**
+   * \brief allocates internal solver data with default settings, the
+   * settings can be changed before the first ana_init/ana_init_sparse
+   */
+  int ana_alloc_solver_data (
+          sca_solv_data **sdatap /**< internal solver data */
+               );
+
   /**
    * \brief initializes internal solver data, generates code for
    * factorization/substitution for matrices \f$A\f$ and \f$B\f$ in 
@@ -86,6 +96,24 @@ extern "C"
             int reinit             	/**< integer for allocating memory */
                );
 
+  /**
+   * \brief generates matrix \f$Z = W + B\f$ and its factorization, reuses
+   * the code of the last code generation if the structure is unchanged
+   */
+  int ana_generate_code_sparse (
+		    sca_solv_data* sdata,		/**< internal solver data */
+		    int alg,					/**< method: 0(Euler), 1(Trapez) */
+		    sparse_matrix* sW,			/**< sparse matrix \f$W\f$ */
+		    sparse_matrix* sB			/**< sparse matrix \f$B\f$ */
+		    );
+
+  /**
+   * \brief frees the internal solver data
+   */
+  void ana_free_solver_data (
+          sca_solv_data **sdatap /**< internal solver data */
+               );
+
   /* ana_reinit.c */
 
   /**
@@ -125,24 +153,191 @@ extern "C"
           sca_solv_data* sdata 	/**< internal solver data */
                 );
 
+  /**
+   * \brief computes the time step of a batch of instances sharing the
+   * solver data in one sweep, the vectors are stored by lines (element i of
+   * instance c at i*n_inst+c)
+   */
+  int ana_solv_batch (
+          double* q,      		/**< time dependent vectors */
+          double* x,     			/**< state vectors */
+          double* xp,     		/**< first derivatives of the state vectors */
+          unsigned long n_inst,	/**< number of instances */
+          sca_solv_data* sdata 	/**< internal solver data */
+                );
+
   /* ana_solve_woodbury.c */
 
   /**
-   * \brief generates solution of linear system of equations using the
-   * formula of Woodbury
+   * \brief prepares a low-rank update of the factorized matrix \f$Z\f$
+   * for the formula of Woodbury, if only a few lines of \f$Z\f$ changed
+   */
+  int ana_update_woodbury (
+          sca_solv_data* sdata, 	/**< internal solver data */
+          int alg					/**< method: EULER, TRAPEZ or BDF2 */
+      );
+
+  /**
+   * \brief corrects the solution of the factorized matrix \f$Z\f$ to the
+   * solution of the updated matrix using the formula of Woodbury
    */
-  int ana_solve_woodbury (
-          double* q,      			/**< time dependent vector */
-          double* x,      			/**< state vector */
+  void ana_solve_woodbury (
           sca_solv_data* sdata, 	/**< internal solver data */
-          long k,					/**< number of modifications in matrix*/
-          int* mode, 				/**< kind of modifications in matrix*/
-          long* n,					/**< indices of modifications in matrix*/
-          double* s,				/**< values of modifications in matrix*/
-          int first_call			/**< integer for first call of
-          	  	  	  	  	  	  	  <i>ana_solve_woodbury</i> */
+          int alg,					/**< method: EULER, TRAPEZ or BDF2 */
+          double* x      			/**< solution vector */
       );
 
+  /**
+   * \brief removes all low-rank updates
+   */
+  void ana_free_woodbury (
+          sca_solv_data* sdata 	/**< internal solver data */
+      );
+
+  /* ana_exact.c */
+
+  /*
+   * The exact discretization assumes a first order hold (piecewise linear)
+   * input q and has no discretization error for such inputs, the results
+   * differ from the trapezoidal rule by the discretization error of the
+   * trapezoidal rule (e.g. no damping error and no frequency warping). It
+   * is only used if enabled by the caller (sca_tdf solver parameter
+   * exact_discretization).
+   */
+
+  /**
+   * \brief enables the exact discretization of small systems with
+   * constant step size for matrices \f$A\f$ and \f$B\f$ in sparse matrix
+   * representation
+   */
+  int ana_init_exact_sparse (
+		  sparse_matrix* sA, 		/**< sparse matrix A */
+          sparse_matrix* sB,		/**< sparse matrix B */
+          double  h,              /**< time step */
+          sca_solv_data* sdata    /**< internal solver data */
+          );
+
+  /**
+   * \brief enables the exact discretization of small systems with
+   * constant step size for matrices \f$A\f$ and \f$B\f$ in full matrix
+   * representation
+   */
+  int ana_init_exact (
+          double* A,             /**< square matrix A */
+          double* B,             /**< square matrix B */
+          unsigned long size,    /**< number of equations -> dim of A and B */
+          double  h,             /**< time step */
+          sca_solv_data* sdata   /**< internal solver data */
+                 );
+
+  /**
+   * \brief performs a step with the exact discretization, returns 0 if
+   * the step was performed
+   */
+  int ana_solve_exact (
+          double* q,      		/**< time dependent vector */
+          double* x,     			/**< state vector */
+          double* xp_last,		/**< derivative of the last step */
+          sca_solv_data* sdata 	/**< internal solver data */
+                );
+
+  /**
+   * \brief removes the data of the exact discretization
+   */
+  void ana_free_exact (
+          sca_solv_data* sdata 	/**< internal solver data */
+      );
+
+  /* ana_dc.c */
+
+  /**
+   * \brief solves the DC equation system \f$B\,x = -q\f$ for <i>h</i> <= 0
+   * or an Euler backward step with the pseudo step size <i>h</i> for
+   * matrices \f$A\f$ and \f$B\f$ in sparse matrix representation
+   */
+  int ana_solve_dc (
+		  sparse_matrix* sA, 		/**< sparse matrix A */
+          sparse_matrix* sB,		/**< sparse matrix B */
+          double  h,              /**< pseudo step size, <= 0: DC */
+          double* q,      		/**< time dependent vector */
+          double* x,     			/**< state vector */
+          sca_solv_data* sdata    /**< internal solver data */
+          );
+
+  /* ana_substeps.c */
+
+  /**
+   * \brief allocates the data of the error controlled sub-stepping
+   */
+  int ana_alloc_substep_data(
+		  sca_substep_data** ssdatap	/**< sub-stepping data */
+		  );
+
+  /**
+   * \brief frees the data of the error controlled sub-stepping
+   */
+  void ana_free_substep_data(
+		  sca_substep_data** ssdatap	/**< sub-stepping data */
+		  );
+
+  /**
+   * \brief sets the tolerances of the sub-stepping
+   */
+  void ana_set_substep_tolerances(
+		  sca_substep_data* ssdata,		/**< sub-stepping data */
+		  double reltol,				/**< relative tolerance */
+		  double abstol					/**< absolute tolerance */
+		  );
+
+  /**
+   * \brief returns the size of the next sub-step, 0 for the global step
+   */
+  double ana_get_substep_timestep(
+		  sca_substep_data* ssdata		/**< sub-stepping data */
+		  );
+
+  /**
+   * \brief sets the size of the next sub-step (e.g. for check points)
+   */
+  void ana_set_substep_timestep(
+		  sca_substep_data* ssdata,		/**< sub-stepping data */
+		  double h						/**< sub-step size */
+		  );
+
+  /**
+   * \brief returns the smallest sub-step size proposed during the last
+   * global step, a value <0 if unknown
+   */
+  double ana_get_substep_proposed_timestep(
+		  sca_substep_data* ssdata		/**< sub-stepping data */
+		  );
+
+  /**
+   * \brief returns the number of accepted and rejected sub-steps and the
+   * smallest accepted sub-step size
+   */
+  void ana_get_substep_statistics(
+		  sca_substep_data* ssdata,		/**< sub-stepping data */
+		  long* steps,					/**< accepted sub-steps */
+		  long* rejections,				/**< rejected sub-steps */
+		  double* min_h					/**< smallest accepted sub-step */
+		  );
+
+  /**
+   * \brief solves the global timestep by error controlled sub-steps, the
+   * state of the begin of the global step is restored on error
+   */
+  int ana_solv_substeps(
+		  sparse_matrix* sA, 			/**< sparse matrix \f$A\f$ */
+		  sparse_matrix* sB,			/**< sparse matrix \f$B\f$ */
+		  double* q_last,				/**< q at the begin of the global step */
+		  double* q,					/**< q at the end of the global step */
+		  double* x,					/**< state vector */
+		  double dt,					/**< global timestep */
+		  sca_solv_data** sdatap,		/**< internal solver data */
+		  sca_substep_data* ssdata		/**< sub-stepping data */
+		  );
+
   /* ana_LUdecomposition.c */
 
   /**
@@ -203,6 +398,7 @@ extern "C"
    * <ul>
    * <li> 1 - backward Euler method
    * <li> 2 - trapezoidal method
+   * <li> 3 - BDF2 (Gear) method
    * </ul>
    */
   int ana_get_algorithm(
@@ -211,15 +407,18 @@ extern "C"
 
   /**
    * The method <i>ana_set_algorithm</i> sets the solution method
-   * <i>data->cur_algorithm</i>:
+   * <i>data->algorithm</i> used after the Euler steps of an initialization:
    * <ul>
-   * <li> <i>alg</i> = 1 - backward Euler method: <i>data->cur_algorithm = EULER</i>
-   * <li> <i>alg</i> = 2 - trapezoidal method: <i>data->cur_algorithm = TRAPEZ</i>
+   * <li> <i>alg</i> = 0 - backward Euler method: <i>data->algorithm = EULER</i>
+   * <li> <i>alg</i> = 1 - trapezoidal method: <i>data->algorithm = TRAPEZ</i>
+   * <li> <i>alg</i> = 2 - BDF2 (Gear) method: <i>data->algorithm = BDF2</i>
    * </ul>
+   * The matrices of the trapezoidal and the BDF2 method differ, thus a
+   * change between them requires a reinitialization with <i>reinit</i> < 2.
    */
   void ana_set_algorithm(
 		  sca_solv_data* data,		/**< internal solver data */
-		  int alg					/**< cur_algorithm: 1(Euler), 2(Trapez) */
+		  int alg					/**< algorithm: 0(Euler), 1(Trapez), 2(BDF2) */
 		  );
 
 
@@ -239,6 +438,14 @@ extern "C"
 		  sca_solv_data* data		/**< internal solver data */
 		  );
 
+  /**
+   * The method <i>ana_get_timestep</i> outputs the step size <i>data->h</i>
+   * of the current initialization.
+   */
+  double ana_get_timestep(
+		  sca_solv_data* data		/**< internal solver data */
+		  );
+
   /**
    * The method <i>ana_get_pivot_flop</i> outputs the number of flops needed for
    * pivotal search during factorization of the coefficient matrix of the system
@@ -270,6 +477,125 @@ extern "C"
 		  );
 
 
+  /**
+   * The method <i>ana_get_fill_ins</i> outputs the number of non-zero
+   * elements of the coefficient matrix before and after factorization.
+   */
+  void ana_get_fill_ins(
+		  sca_solv_data* data,		/**< internal solver data */
+		  int alg,					/**< cur_algorithm: 1(Euler), 2(Trapez) */
+		  long* fill_ins,			/**< non-zeros before factorization */
+		  long* fill_ins_after_dec	/**< non-zeros after factorization */
+		  );
+
+  /**
+   * The method <i>ana_get_diagonal_blocks</i> outputs the number of diagonal
+   * blocks of the block triangular form and the number of blocks of size 1
+   * (both 0, if the ordering is not 3).
+   */
+  void ana_get_diagonal_blocks(
+		  sca_solv_data* data,		/**< internal solver data */
+		  int alg,					/**< cur_algorithm: 1(Euler), 2(Trapez) */
+		  long* nblocks,			/**< number of diagonal blocks */
+		  long* nsingle				/**< number of blocks of size 1 */
+		  );
+
+  /**
+   * The method <i>ana_set_ordering</i> sets the fill-reducing ordering used
+   * by the next code generations:
+   * <ul>
+   * <li> <i>ordering</i> = 0 - Markowitz pivotal search only
+   * <li> <i>ordering</i> = 1 - approximate minimum degree
+   * <li> <i>ordering</i> = 2 - nested dissection
+   * <li> <i>ordering</i> = 3 - block triangular form (maximum transversal and
+   *      strongly connected components), the diagonal blocks are decomposed
+   *      and solved one after the other, blocks of size 1 become direct
+   *      assignments
+   * </ul>
+   * If the ordering changes, the next reinitialization generates new code.
+   */
+  void ana_set_ordering(
+		  sca_solv_data* data,		/**< internal solver data */
+		  int ordering				/**< fill-reducing ordering */
+		  );
+
+
+  /**
+   * The method <i>ana_get_factorization_statistics</i> outputs the number of
+   * code generations with pivotal search and the number of numeric
+   * refactorizations reusing an existing code.
+   */
+  void ana_get_factorization_statistics(
+		  sca_solv_data* data,		/**< internal solver data */
+		  long* codegen_cnt,		/**< number of code generations */
+		  long* refactor_cnt		/**< number of refactorizations */
+		  );
+
+
+  /**
+   * The method <i>ana_set_factorization_cache_size</i> sets the number of
+   * factorizations, which are kept for reuse after a reinitialization.
+   * A size of 0 disables the cache.
+   */
+  void ana_set_factorization_cache_size(
+		  sca_solv_data* data,		/**< internal solver data */
+		  long size					/**< number of cached factorizations */
+		  );
+
+  /**
+   * The method <i>ana_set_factorization_key</i> sets the key of the system
+   * state used for the next reinitialization to look up the factorization
+   * cache.
+   */
+  void ana_set_factorization_key(
+		  sca_solv_data* data,		/**< internal solver data */
+		  unsigned long long key,	/**< key of system state */
+		  int valid					/**< 0: state has no key, no caching */
+		  );
+
+  /**
+   * The method <i>ana_free_factorization_cache</i> removes all cached
+   * factorizations.
+   */
+  void ana_free_factorization_cache(
+		  sca_solv_data* data		/**< internal solver data */
+		  );
+
+  /**
+   * The method <i>ana_get_factorization_cache_statistics</i> outputs the
+   * number of reinitializations which found or not found a factorization
+   * in the cache.
+   */
+  void ana_get_factorization_cache_statistics(
+		  sca_solv_data* data,		/**< internal solver data */
+		  long* hits,				/**< number of cache hits */
+		  long* misses				/**< number of cache misses */
+		  );
+
+
+  /**
+   * The method <i>ana_set_woodbury_max_rank</i> sets the maximum number of
+   * changed lines of the matrix \f$Z\f$, which are handled by a low-rank
+   * update of the current factorization instead of a refactorization.
+   * A rank of 0 disables low-rank updates.
+   */
+  void ana_set_woodbury_max_rank(
+		  sca_solv_data* data,		/**< internal solver data */
+		  long rank					/**< maximum rank of updates */
+		  );
+
+  /**
+   * The method <i>ana_get_woodbury_statistics</i> outputs the number of
+   * low-rank updates and the number of updates, which have been merged into
+   * the factorization by a refactorization.
+   */
+  void ana_get_woodbury_statistics(
+		  sca_solv_data* data,		/**< internal solver data */
+		  long* updates,			/**< number of low-rank updates */
+		  long* consolidations		/**< number of merged updates */
+		  );
+
+
   /************************************/
 
   /**
@@ -313,6 +639,96 @@ extern "C"
 
   void free_checkpoint_data(sca_solv_checkpoint_data** cp_data);
 
+  /**
+   * The method <i>ana_flip_solver_check_point</i> stores a check point
+   * without copying - the check point refers to the current state and takes
+   * over the vectors of the last step by the next call of <i>ana_solv</i>.
+   * Until then the vector \f$x\f$ must not be changed or removed by the
+   * caller (see <i>ana_resolve_solver_check_point</i>) and the check point
+   * must not be freed. Only one check point can be pending.
+   */
+  int ana_flip_solver_check_point(
+		  sca_solv_data* sdata,		            /**< internal solver data */
+		  double* x,					        /**< solution vector */
+		  sca_solv_checkpoint_data** cp_data    /**< internal check point data */
+		  );
+
+  /**
+   * The method <i>ana_swap_solver_check_point</i> restores a check point by
+   * exchanging the derivative vectors, the check point becomes pending (see
+   * <i>ana_flip_solver_check_point</i>).
+   */
+  int ana_swap_solver_check_point(
+		  sca_solv_data* sdata,		            /**< internal solver data */
+		  double* x,					        /**< solution vector */
+		  sca_solv_checkpoint_data** cp_data    /**< internal check point data */
+		  );
+
+  /**
+   * The method <i>ana_resolve_solver_check_point</i> copies a pending
+   * check point - required before the state vector is changed outside of
+   * <i>ana_solv</i>.
+   */
+  void ana_resolve_solver_check_point(
+		  sca_solv_data* sdata		            /**< internal solver data */
+		  );
+
+  /**
+   * The method <i>ana_drop_solver_check_point</i> removes the reference to
+   * a pending check point without copying, if the state is removed.
+   */
+  void ana_drop_solver_check_point(
+		  sca_solv_checkpoint_data** cp_data    /**< pending check point */
+		  );
+
+  /************************************/
+
+  /**
+   * The method <i>ana_allocate_solver_instance</i> allocates the state of an
+   * instance (the first derivative <i>xp</i> and the current method), which
+   * shares the internal solver data with other instances of identical
+   * equation systems and time steps.
+   */
+  int ana_allocate_solver_instance(
+  		  unsigned long size,                   /**< number of state variables */
+  		  sca_solv_instance** inst              /**< instance state */
+  		  );
+
+  /**
+   * The method <i>ana_free_solver_instance</i> frees the instance state.
+   */
+  void ana_free_solver_instance(sca_solv_instance** inst);
+
+  /**
+   * The method <i>ana_attach_solver_instance</i> makes the state of the
+   * instance the current state of the solver data, the state of the
+   * previously attached instance is stored. All following calls of
+   * <i>ana_solv</i> and of the check point methods use the instance state.
+   */
+  void ana_attach_solver_instance(
+		  sca_solv_data* sdata,		            /**< internal solver data */
+		  sca_solv_instance* inst               /**< instance state */
+		  );
+
+  /**
+   * The method <i>ana_detach_solver_instance</i> stores the current state in
+   * the instance and releases it from the solver data.
+   */
+  void ana_detach_solver_instance(
+		  sca_solv_data* sdata,		            /**< internal solver data */
+		  sca_solv_instance* inst               /**< instance state */
+		  );
+
+  /**
+   * The method <i>ana_restart_solver_instance</i> attaches the instance and
+   * restarts it with the Euler backward method, like a reinitialization
+   * of the solver data does.
+   */
+  void ana_restart_solver_instance(
+		  sca_solv_data* sdata,		            /**< internal solver data */
+		  sca_solv_instance* inst               /**< instance state */
+		  );
+
 
 #ifdef __cplusplus
 }
@@ -78,6 +78,14 @@
  * \f]
  * gives the index of the first entry in each line (<i>sm->ia</i> with line
  * index \f$i\f$).
+ *
+ * To avoid the search along the line for each access by position, the
+ * positions are hashed into the slot map <i>sm->slot</i>, which gives the
+ * index of the entry in constant time. Moreover <i>sm->slottail</i> gives the
+ * last entry of each line, thus new entries are appended without search.
+ * The slot map is built by the first access and maintained by
+ * <i>sparse_write_value</i>, functions rearranging the entries free it by
+ * <i>MA_FreeSlotMap</i>.
  */
 
 /*****************************************************************************/
@@ -91,6 +99,128 @@
 
 /*****************************************************************************/
 
+/** minimum size of the slot map */
+#define SLOT_MAP_MIN_SIZE 64
+
+static count_far slot_hash(count_far nslot, unsigned x, unsigned y)
+{
+	unsigned long h;
+
+	h = (unsigned long) x * 2654435761UL + (unsigned long) y;
+	h ^= h >> 15;
+	h *= 2246822519UL;
+	h ^= h >> 13;
+
+	return (count_far) (h & (unsigned long) (nslot - 1));
+}
+
+/*****************************************************************************/
+
+static void slot_insert(sparse_matrix *sm, unsigned x, count_far k)
+{
+	count_far h;
+
+	h = slot_hash(sm->nslot, x, (unsigned) sm->ja[k]);
+	while (sm->slot[h] > -1)
+		h = (h + 1) & (sm->nslot - 1);
+
+	sm->slot[h] = k;
+	sm->slotline[h] = (count_near) x;
+}
+
+/*****************************************************************************/
+
+/**
+ *  (Re)builds the slot map for all entries of the matrix, the size is chosen
+ *  such that at most half of the slots are occupied.
+ *
+ *  @return
+ *  <ul><li>    0 - okay
+ *  <li>        2 - not enough memory
+ *  </ul>
+ */
+static int slot_build(sparse_matrix *sm)
+{
+	count_far k, nslot;
+	count_near x;
+
+	MA_FreeSlotMap(sm);
+
+	nslot = SLOT_MAP_MIN_SIZE;
+	while (nslot < 2 * (sm->nel + 1))
+		nslot *= 2;
+
+	sm->slot = (count_far *) malloc((size_t) nslot * sizeof(count_far));
+	sm->slotline = (count_near *) malloc((size_t) nslot * sizeof(count_near));
+	sm->slottail = (count_far *) malloc((size_t) (sm->m + 1) * sizeof(count_far));
+
+	if (sm->slot == NULL || sm->slotline == NULL || sm->slottail == NULL)
+	{
+		MA_FreeSlotMap(sm);
+		return 2;
+	}
+
+	sm->nslot = nslot;
+	for (k = 0; k < nslot; ++k)
+		sm->slot[k] = -1;
+
+	for (x = 0; x < sm->m; ++x)
+	{
+		sm->slottail[x] = -1;
+
+		if (sm->a == NULL)
+			continue;
+
+		k = sm->ia[x]; /* first element in line x */
+		while (k > -1 && (sm->ia[x] != sm->ia[x+1]))
+		{
+			slot_insert(sm, (unsigned) x, k);
+			sm->slottail[x] = k;
+			k = sm->fa[k];
+		}
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+
+/**
+ *  Returns the index of the entry at position (x,y), -1 if the position is not
+ *  occupied. If no slot map can be allocated, the line is searched.
+ */
+static count_far slot_find(sparse_matrix *sm, unsigned x, unsigned y)
+{
+	count_far h, k;
+
+	if (sm->ia == NULL || sm->a == NULL)
+		return -1;
+
+	if (sm->nslot == 0 && slot_build(sm) != 0)
+	{
+		k = sm->ia[x]; /* first element in line x */
+		while (k > -1 && (sm->ia[x] != sm->ia[x+1]))
+		{
+			if (sm->ja[k] == y) /* element k is in column y */
+				return k;
+			k = sm->fa[k];
+		}
+		return -1;
+	}
+
+	h = slot_hash(sm->nslot, x, y);
+	while ((k = sm->slot[h]) > -1)
+	{
+		if (sm->slotline[h] == (count_near) x && sm->ja[k] == y)
+			return k;
+		h = (h + 1) & (sm->nslot - 1);
+	}
+
+	return -1;
+}
+
+/*****************************************************************************/
+
 sparse_matrix* sparse_generate(unsigned m, unsigned n)
 {
 	count_near i;
@@ -175,17 +305,25 @@ int sparse_write_value(sparse_matrix *sm, unsigned x, unsigned y,double val)
 		}
 	}
 
-	k = sm->ia[x]; /* first element in line x */
-	while (k > -1  && (sm->ia[x] != sm->ia[x+1]))
-	{	/* k = -1 in case of line empty or k is last element in line */
-		if (sm->ja[k] == y)  /* position (x,y) exists */
+	k = slot_find(sm, x, y);
+	if (k > -1)  /* position (x,y) exists */
+	{
+		sm->a[k] = val;
+		return 0;  /* successful: write to existing position */
+	}
+
+	if (sm->nslot > 0)
+	{
+		last_k = sm->slottail[x];
+	}
+	else
+	{	/* no slot map available - search last element in line x */
+		k = sm->ia[x];
+		while (k > -1  && (sm->ia[x] != sm->ia[x+1]))
 		{
-			sm->a[k] = val;
-			return 0;  /* successful: write to existing position */
+			last_k = k;
+			k = sm->fa[k];
 		}
-
-		last_k = k;
-		k = sm->fa[k]; /* go to next element in line x */
 	}
 
 	/* insert new position */
@@ -208,6 +346,19 @@ int sparse_write_value(sparse_matrix *sm, unsigned x, unsigned y,double val)
 
 	sm->sparse_list_ordered = 0; /* sparse list unordered */
 
+	if (sm->nslot > 0)
+	{
+		if (2 * (sm->nel + 1) > sm->nslot)
+		{
+			slot_build(sm);	/* enlarge slot map */
+		}
+		else
+		{
+			slot_insert(sm, x, sm->nel - 1);
+			sm->slottail[x] = sm->nel - 1;
+		}
+	}
+
 	return 0;
 }
 
@@ -220,20 +371,9 @@ double* sparse_get_value_ref(sparse_matrix *sm, unsigned x, unsigned y)
 	if ((count_near)x >= sm->m || (count_near)y >= sm->n)
 		return NULL;
 
-	if (sm->ia != NULL && sm->a != NULL)
-	{
-		k = sm->ia[x]; /* first element in line x */
-		while (k > -1 && (sm->ia[x] != sm->ia[x+1]))
-		{
-			if (sm->ja[k] == y) /* element k is in column y */
-			{
-				return &(sm->a[k]);
-				break;
-			}
-
-			k = sm->fa[k];
-		}
-	}
+	k = slot_find(sm, x, y);
+	if (k > -1)
+		return &(sm->a[k]);
 
 	return NULL;
 }
@@ -256,22 +396,13 @@ unsigned sparse_get_ncolumns(sparse_matrix *sm)
 
 double sparse_get_value(sparse_matrix *sm, unsigned x, unsigned y)
 {
-	double val = 0.0;
 	count_far k;
 
-	k = sm->ia[x]; /* first element in line x */
-	while (k > -1 && (sm->ia[x] != sm->ia[x+1]))
-	{
-		if (sm->ja[k] == y) /* element k is in column y */
-		{
-			val = sm->a[k];
-			break;
-		}
-
-		k = sm->fa[k];
-	}
+	k = slot_find(sm, x, y);
+	if (k > -1)
+		return sm->a[k];
 
-	return val; /* val = 0.0 in case of (x,y) is not occupied in sm */
+	return 0.0; /* (x,y) is not occupied in sm */
 }
 
 /*****************************************************************************/
@@ -292,6 +423,8 @@ int sparse_resize(sparse_matrix *sm, unsigned m, unsigned n)
 	sm->n = n;
 	sm->nd = MA_min(sm->m, sm->n);	/* dimension of matrix */
 
+	MA_FreeSlotMap(sm); /* number of lines changed */
+
 	if (sm->ia != NULL) /* reallocate memory for sm->ia */
 	{
 		ia = (count_far *)realloc((char *)sm->ia,
@@ -439,6 +572,8 @@ int sparse_convert_full_to_sparse(double *A, sparse_matrix *sa,
 	nmax = (size_t)(anz + (count_far) anz/10 + 20); /* prophylactical */
 	sa->nmax = (count_far)nmax;
 
+	MA_FreeSlotMap(sa);
+
 	sa->a = (value *) calloc(nmax, vsize);
 	sa->ja = (count_near *) calloc(nmax, cnsize);
 	sa->fa = (count_far *) calloc(nmax,  cfsize);
@@ -112,6 +112,15 @@ typedef struct sparse
       unsigned   sparse_list_ordered; /**< = 1: list is ordered line by line and
       	  	  	  	  	  	  	  column by column; = 0: list is unordered */
 
+      /* slot map for the access by position (linear_direct_sparse.c) */
+      count_far  nslot;      /**< size of slot map (power of 2),
+                                0 if no slot map available       */
+      count_far  *slot;      /**< element of hashed position,
+                                -1 in case of free slot          */
+      count_near *slotline;  /**< line of element in slot        */
+      count_far  *slottail;  /**< last element of each line,
+                                m elements, -1 if line empty     */
+
       unsigned   full : 1;   /**< if 1 then a and nd used for full
                                 matrix representation
                                 if 0 then sparse representation  */
@@ -128,7 +137,9 @@ struct spcode
       count_far  nsol;       /**< length code for solution         */
       count_far  nsoldec;    /**< length code for solution, decom-
                                 position steps only,
-                                without backward substitution    */
+                                without backward substitution,
+                                nsol for the block triangular
+                                form (ordering 3)                */
       count_far  ndecmax;    /**< maximum length of decomp. code   */
       count_far  nsolmax;    /**< maximum length of solution code  */
       count_far  rank;       /**< rank of matrix                   */
@@ -162,6 +173,52 @@ struct spcode
       count_far dec_ma;			/**< intermediate number of flops for
       	  	  	  	  	  	  	  decomposition*/
       count_far sol_flop;		/**< number of flops for solution */
+
+      /* structure of the matrix the code was generated for */
+      count_far  pattern_nd;	/**< dimension of matrix, 0 if no valid code */
+      count_far  *pattern_ia;	/**< start of lines, nd+1 elements */
+      count_near *pattern_ja;	/**< column positions, fill_ins elements */
+
+      /* fill-reducing ordering */
+      int        ordering;		/**< 0: Markowitz pivotal search only,
+      	  	  	  	  	  	  	  1: approximate minimum degree, 2: nested dissection,
+      	  	  	  	  	  	  	  3: block triangular form, decomposed and solved
+      	  	  	  	  	  	  	  block by block */
+      count_far  *order;		/**< pivot priority of lines, nd elements,
+      	  	  	  	  	  	  	  the diagonal block of the line for ordering 3 */
+      count_far  nblocks;		/**< number of diagonal blocks (ordering 3) */
+      count_far  nsingle;		/**< number of diagonal blocks of size 1 */
+};
+
+/**
+ * solution code lowered to flat arrays (struct of arrays), the L-solve is
+ * stored per pivot step, the U-solve per line - the code consists of
+ * segments of pivot steps followed by U-groups (one segment, if the matrix
+ * is decomposed as a whole, one per diagonal block for the block triangular
+ * form)
+ */
+struct spflat
+{
+      count_far  n;          /**< dimension, 0 if no valid flat code */
+      count_far  nl;         /**< number of operations of L-solve */
+      count_far  nu;         /**< number of operations of U-solve */
+      count_far  nug;        /**< number of lines of U-solve */
+      count_far  nseg;       /**< number of segments */
+      count_far  *seg_step;  /**< first pivot step of segment s, nseg+1 el. */
+      count_far  *seg_group; /**< first U-group of segment s, nseg+1 el. */
+      count_far  *diag_line; /**< pivot line of step k */
+      count_far  *diag_pos;  /**< position of inverse pivot in sparse list */
+      value      *diag_val;  /**< inverse pivot of step k */
+      count_far  *l_ptr;     /**< first L-operation of step k, n+1 el. */
+      count_far  *l_line;    /**< line modified by L-operation */
+      count_far  *l_pos;     /**< position of factor in sparse list */
+      value      *l_val;     /**< factor of L-operation */
+      count_far  *u_line;    /**< line modified by U-group g */
+      count_far  *u_ptr;     /**< first U-operation of group g, nug+1 el. */
+      count_far  *u_src;     /**< line of solution used by U-operation */
+      count_far  *u_pos;     /**< position of factor in sparse list */
+      value      *u_val;     /**< factor of U-operation */
+      count_far  *isort;     /**< vector for back permutation of solution */
 };
 
 /**
@@ -191,6 +248,14 @@ exportMA_Sparse void MA_FreeSparse(
 		struct sparse* sA	/**< sparse matrix */
 		);
 
+/**
+ * \brief frees the slot map of the sparse matrix, it is rebuilt by the next
+ * access by position - has to be called if the elements are rearranged
+ */
+exportMA_Sparse void MA_FreeSlotMap(
+		struct sparse* sA	/**< sparse matrix */
+		);
+
 /**
  * \brief reallocates memory for sparse matrix
  */
@@ -207,6 +272,36 @@ exportMA_Sparse err_code MA_ProductSparseVector(
 		value* pc			/**< solution vector */
 		);
 
+/**
+ * \brief gets the residual \f$pr = A\,pa + vb\,B\,pb - pq\f$ in one sweep
+ * over the lines of \f$A\f$ and \f$B\f$, \f$B\f$ may be NULL
+ */
+exportMA_Sparse err_code MA_ResidualSparseVector(
+		struct sparse* sA,	/**< sparse matrix */
+		value* pa,			/**< multiplier vector of A */
+		struct sparse* sB,	/**< sparse matrix or NULL */
+		value vb,			/**< factor of B */
+		value* pb,			/**< multiplier vector of B */
+		value* pq,			/**< subtrahend vector */
+		value* pr			/**< residual vector */
+		);
+
+/**
+ * \brief gets the residuals \f$pr = A\,pa + vb\,B\,pb - pq\f$ of
+ * <i>nb</i> vectors stored by lines (element i of vector c at i*nb+c) in
+ * one sweep over the lines of \f$A\f$ and \f$B\f$, \f$B\f$ may be NULL
+ */
+exportMA_Sparse err_code MA_ResidualSparseBatch(
+		struct sparse* sA,	/**< sparse matrix */
+		value* pa,			/**< multiplier vectors of A */
+		struct sparse* sB,	/**< sparse matrix or NULL */
+		value vb,			/**< factor of B */
+		value* pb,			/**< multiplier vectors of B */
+		value* pq,			/**< subtrahend vectors */
+		value* pr,			/**< residual vectors */
+		count_far nb		/**< number of vectors */
+		);
+
 /**
  * sorts indices of columns in sparse matrix within each line
  */
@@ -235,6 +330,20 @@ exportMA_Sparse void MA_FreeCode(
 		struct spcode *code	/**< code */
 		);
 
+/**
+ * initializes flat solution code
+ */
+exportMA_Sparse void MA_InitFlatCode(
+		struct spflat* flat	/**< flat code */
+		);
+
+/**
+ * destructs flat solution code, sets pointers to zero
+ */
+exportMA_Sparse void MA_FreeFlatCode(
+		struct spflat* flat	/**< flat code */
+		);
+
 /*MA_generate_sparse.c*/
 
 /**
@@ -299,6 +408,120 @@ exportMA_Sparse err_code MA_LequSparseSolut(
 		value* x			/**< solution vector */
 		);
 
+/**
+ * \brief checks whether a matrix has the structure the code has been
+ * generated for
+ */
+exportMA_Sparse err_code MA_LequSparseCheckPattern(
+		struct sparse* sB,	/**< sparse matrix */
+		struct spcode* code	/**< code */
+		);
+
+/**
+ * \brief numeric refactorization of a matrix with unchanged structure by
+ * replaying the decomposition code of a previous code generation
+ */
+exportMA_Sparse err_code MA_LequSparseRefactor(
+		struct sparse* sA,	/**< sparse matrix decomposed by code generation */
+		struct sparse* sB,	/**< new sparse matrix with same structure */
+		struct spcode* code	/**< code */
+		);
+
+/**
+ * \brief lowers the solution code of a regular matrix to flat arrays for
+ * L-solve, diagonal scaling and U-solve
+ */
+exportMA_Sparse err_code MA_LequSparseLower(
+		struct sparse* sA,	/**< decomposed sparse matrix */
+		struct spcode* code,/**< code */
+		struct spflat* flat	/**< flat code */
+		);
+
+/**
+ * \brief updates the values of the flat code after a numeric
+ * refactorization
+ */
+exportMA_Sparse void MA_LequSparseLowerValues(
+		struct sparse* sA,	/**< decomposed sparse matrix */
+		struct spflat* flat	/**< flat code */
+		);
+
+/**
+ * \brief solves linear system of equations with the aid of the flat code
+ */
+exportMA_Sparse void MA_LequSparseSolutFlat(
+		struct spflat* flat,/**< flat code */
+		value* r,			/**< righthandside vector */
+		value* x			/**< solution vector */
+		);
+
+/**
+ * \brief solves linear system of equations for <i>nb</i> righthandside
+ * vectors stored by lines (element i of vector c at i*nb+c) with the aid of
+ * the flat code
+ */
+exportMA_Sparse void MA_LequSparseSolutFlatBatch(
+		struct spflat* flat,/**< flat code */
+		value* r,			/**< righthandside vectors */
+		value* x,			/**< solution vectors */
+		count_far nb		/**< number of vectors */
+		);
+
+/**
+ * \brief numeric decomposition of a complex matrix (values interleaved) by
+ * replaying the decomposition code of a real matrix with the same structure
+ */
+exportMA_Sparse err_code MA_LequSparseRefactorComplex(
+		value* ca,			/**< complex values of the sorted sparse list */
+		value* lu,			/**< decomposed complex matrix */
+		struct spcode* code	/**< code */
+		);
+
+/**
+ * \brief solves complex linear system of equations (vectors interleaved)
+ * with the aid of the solution code
+ */
+exportMA_Sparse err_code MA_LequSparseSolutComplex(
+		value* lu,			/**< decomposed complex matrix */
+		struct spcode* code,/**< code */
+		value* r,			/**< complex righthandside vector */
+		value* x			/**< complex solution vector */
+		);
+
+/**
+ * \brief solves complex linear system of equations for several
+ * righthandsides (stored by lines) in one pass over the solution code
+ */
+exportMA_Sparse err_code MA_LequSparseSolutComplexMulti(
+		value* lu,			/**< decomposed complex matrix */
+		struct spcode* code,/**< code */
+		count_far nrhs,		/**< number of righthandsides */
+		value* r,			/**< complex righthandside vectors */
+		value* x			/**< complex solution vectors */
+		);
+
+/**
+ * \brief solves the transposed linear system of equations with the aid of
+ * the solution code
+ */
+exportMA_Sparse err_code MA_LequSparseSolutTrans(
+		struct sparse* sA,	/**< sparse matrix */
+		struct spcode* code,/**< code */
+		value* r,			/**< righthandside vector */
+		value* x			/**< solution vector */
+		);
+
+/**
+ * \brief solves the transposed complex linear system of equations (vectors
+ * interleaved) with the aid of the solution code
+ */
+exportMA_Sparse err_code MA_LequSparseSolutComplexTrans(
+		value* lu,			/**< decomposed complex matrix */
+		struct spcode* code,/**< code */
+		value* r,			/**< complex righthandside vector */
+		value* x			/**< complex solution vector */
+		);
+
 /*MA_LUdecomposition.c*/
 
 /**
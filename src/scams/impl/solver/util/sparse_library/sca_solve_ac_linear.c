@@ -42,6 +42,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include <assert.h>
 
 #include "scams/impl/solver/util/sparse_library/ma_typedef.h"
@@ -57,6 +58,16 @@ struct sca_solve_ac_linear_data
     long critical_row;
     long critical_column;
 
+    /* native complex solution of the matrix Spa with 2x2 real blocks */
+    int            complex_mode; /* 1: Cod has been generated for Mag */
+    struct sparse  Mag;          /* magnitudes of the complex entries */
+    double*        cval;         /* complex entries of Mag, interleaved */
+    double*        clu;          /* decomposed complex matrix, interleaved */
+    long           clu_size;     /* allocated complex elements of clu */
+
+    /* statistics of the reuse of the code over several frequency points */
+    long           codegen_cnt;  /* number of code generations */
+    long           reuse_cnt;    /* number of numeric refactorizations */
 };
 
 void sca_solve_ac_get_error_position(struct sca_solve_ac_linear_data* data,long* row,long* column)
@@ -65,53 +76,314 @@ void sca_solve_ac_get_error_position(struct sca_solve_ac_linear_data* data,long*
 	(*column)=data->critical_column;
 }
 
+void sca_solve_ac_get_statistics(struct sca_solve_ac_linear_data* data,long* codegen_cnt,long* reuse_cnt)
+{
+	(*codegen_cnt)=data->codegen_cnt;
+	(*reuse_cnt)=data->reuse_cnt;
+}
+
+
+/**
+ * compresses the real matrix A of dimension 2n, where each complex entry
+ * z is stored as 2x2 block ( Re(z) -Im(z) ; Im(z) Re(z) ), to the complex
+ * matrix of dimension n - the values are stored interleaved in cval, the
+ * structure is stored in M with the magnitudes as values
+ *
+ * the lines 2i+1 must contain ( Im(z) Re(z) ) in the same block columns as
+ * the lines 2i, otherwise A is not a complex matrix and is solved as real
+ * matrix
+ *
+ * returns 0 - okay, 2 - not enough memory, 3 - A has not the block structure
+ */
+static int sca_solve_ac_compress(struct sparse* A, struct sparse* M,
+		double** cval)
+{
+	count_far i, k, p, nel, nodd, nz, last;
+	count_near n, j;
+	double re, im;
+
+	if(A->m != A->n || A->m < 2 || (A->m % 2) != 0 || A->a == NULL)
+		return 3;
+
+	/* get correct order of entries in sparse list */
+	MA_SortSparseList(A);
+
+	n = A->m / 2;
+
+	/* number of complex entries, lines 2i contain Re and -Im */
+	nel = nodd = 0;
+	for(i = 0; i < n; i++)
+	{
+		last = -1;
+		for(k = A->ia[2 * i]; k < A->ia[2 * i + 1]; k++)
+		{
+			if(A->ja[k] / 2 != last) nel++;
+			last = A->ja[k] / 2;
+		}
+		nodd += A->ia[2 * i + 2] - A->ia[2 * i + 1];
+	}
+
+	/* each entry of the lines 2i has a counterpart in line 2i+1 */
+	if(nodd != A->nel - nodd)
+		return 3;
+
+	MA_FreeSparse(M);
+
+	M->m = M->n = M->nd = n;
+	M->nel = nel;
+	M->nmax = nel + 1;
+	M->a  = (value *) calloc((unsigned) M->nmax, sizeof(value));
+	M->ja = (count_near *) calloc((unsigned) M->nmax, sizeof(count_near));
+	M->fa = (count_far *) calloc((unsigned) M->nmax, sizeof(count_far));
+	M->ia = (count_far *) calloc((unsigned) (n + 1), sizeof(count_far));
+
+	if((*cval) != NULL) free(*cval);
+	(*cval) = (double *) calloc((unsigned) (2 * M->nmax), sizeof(double));
+
+	if(M->a == NULL || M->ja == NULL || M->fa == NULL || M->ia == NULL
+			|| (*cval) == NULL)
+	{
+		MA_FreeSparse(M);
+		return 2;
+	}
+
+	nel = 0;
+	for(i = 0; i < n; i++)
+	{
+		M->ia[i] = nel;
+		for(k = A->ia[2 * i]; k < A->ia[2 * i + 1]; k++)
+		{
+			j = A->ja[k] / 2;
+			if(nel == M->ia[i] || M->ja[nel - 1] != j)
+			{
+				M->ja[nel] = j;
+				M->fa[nel] = nel + 1;
+				nel++;
+			}
+
+			if(A->ja[k] % 2 == 0) (*cval)[2 * (nel - 1)]     =  A->a[k];
+			else                  (*cval)[2 * (nel - 1) + 1] = -A->a[k];
+		}
+
+		if(nel > M->ia[i]) M->fa[nel - 1] = -1;
+
+		/* non-zero values of the line 2i */
+		nz = 0;
+		for(p = M->ia[i]; p < nel; p++)
+		{
+			if((*cval)[2 * p] != 0.0)     nz++;
+			if((*cval)[2 * p + 1] != 0.0) nz++;
+		}
+
+		/* line 2i+1 must be ( Im Re ) in the same block columns, both
+		 * lines are sorted by columns */
+		p = M->ia[i];
+		for(k = A->ia[2 * i + 1]; k < A->ia[2 * i + 2]; k++)
+		{
+			j = A->ja[k] / 2;
+			while(p < nel && M->ja[p] < j) p++;
+
+			if(p < nel && M->ja[p] == j)
+			{
+				re = (*cval)[2 * p];
+				im = (*cval)[2 * p + 1];
+			}
+			else
+			{
+				re = im = 0.0;
+			}
+
+			if(A->a[k] != ((A->ja[k] % 2 == 0) ? im : re)) break;
+			if(A->a[k] != 0.0) nz--;
+		}
+
+		/* nz > 0: non-zero values of line 2i without counterpart */
+		if(k < A->ia[2 * i + 2] || nz != 0)
+		{
+			MA_FreeSparse(M);
+			return 3;
+		}
+	}
+	M->ia[n] = nel;
+
+	for(k = 0; k < nel; k++)
+	{
+		M->a[k] = sqrt((*cval)[2 * k] * (*cval)[2 * k]
+				+ (*cval)[2 * k + 1] * (*cval)[2 * k + 1]);
+	}
+
+	M->sparse_list_ordered = 1;
+
+	return 0;
+}
+
+
+/**
+ * generates the code for the matrix of the magnitudes of the complex
+ * entries and decomposes the complex matrix with the same pivot order -
+ * returns 0, if the complex matrix can be solved this way
+ *
+ * if compressed is set, Mag and cval contain already the compressed matrix
+ * Spa
+ */
+static int sca_solve_ac_linear_init_complex(struct sca_solve_ac_linear_data* sdata,
+		int compressed)
+{
+	long size;
+
+	if(!compressed &&
+		(sca_solve_ac_compress(sdata->Spa, &(sdata->Mag), &(sdata->cval)) != 0))
+		return 1;
+
+	if(MA_LequSparseCodegen(&(sdata->Mag), &(sdata->Cod)) != 0
+			|| sdata->Cod.rank != sdata->Mag.nd)
+	{
+		MA_FreeCode(&(sdata->Cod));
+		return 1;
+	}
+
+	size = (long)sdata->Cod.fill_ins_after_dec + 1;
+	if(size > sdata->clu_size)
+	{
+		if(sdata->clu != NULL) free(sdata->clu);
+		sdata->clu = (double *) malloc((unsigned) (2 * size) * sizeof(double));
+		sdata->clu_size = (sdata->clu != NULL) ? size : 0;
+	}
+
+	if(sdata->clu == NULL
+			|| MA_LequSparseRefactorComplex(sdata->cval, sdata->clu,
+					&(sdata->Cod)) != 0)
+	{
+		/* pivot order of magnitudes not stable for complex values */
+		MA_FreeCode(&(sdata->Cod));
+		return 1;
+	}
+
+	sdata->complex_mode = 1;
+
+	return 0;
+}
+
+
+/**
+ * decomposes the complex matrix with the code of the previous initialization
+ * without pivot search - returns 0, if the matrix has the same structure and
+ * all pivots are still acceptable, 1 if the matrix can't be compressed and
+ * 2 if the compressed matrix (Mag, cval) requires a new code generation
+ */
+static int sca_solve_ac_linear_refactor_complex(struct sca_solve_ac_linear_data* sdata)
+{
+	if(sca_solve_ac_compress(sdata->Spa, &(sdata->Mag), &(sdata->cval)) != 0)
+		return 1;
+
+	if(MA_LequSparseCheckPattern(&(sdata->Mag), &(sdata->Cod)) != 0)
+		return 2;
+
+	if(MA_LequSparseRefactorComplex(sdata->cval, sdata->clu,
+			&(sdata->Cod)) != 0)
+		return 2;
+
+	return 0;
+}
+
+
+/**
+ * generates the code for the matrix A with the 2x2 real blocks of the complex
+ * entries - the complex matrix of half dimension is solved directly, if
+ * possible, otherwise the real matrix A is solved
+ *
+ * if data has been initialized before (e.g. for the previous frequency point)
+ * and the complex matrix has the same structure, the pivot order of the
+ * previous code generation is reused and only the numeric decomposition is
+ * performed - a new code generation is only carried out, if a pivot becomes
+ * unacceptable
+ */
 int sca_solve_ac_linear_init(  struct sparse* A,
                                struct sca_solve_ac_linear_data** data
                            )
 {
 	   struct sca_solve_ac_linear_data* sdata=NULL;
+	   int compressed=-1;  /* -1: not compressed, 1: Mag contains A, 0: A is no complex matrix */
 
     if((*data)==NULL)
     {
         (*data)=malloc(sizeof(struct sca_solve_ac_linear_data));
         assert((*data)!=NULL);
         MA_InitCode(&((*data)->Cod));
+        MA_InitSparse(&((*data)->Mag));
+        (*data)->cval=NULL;
+        (*data)->clu=NULL;
+        (*data)->clu_size=0;
+        (*data)->critical_column=-1;
+        (*data)->critical_row=-1;
+        (*data)->codegen_cnt=0;
+        (*data)->reuse_cnt=0;
     }
     else
     {
-        MA_FreeCode(&((*data)->Cod));
-
         (*data)->critical_column=-1;
         (*data)->critical_row=-1;
+
+        if((*data)->complex_mode)
+        {
+        	(*data)->Spa=A;
+        	compressed=sca_solve_ac_linear_refactor_complex(*data);
+        	if(compressed == 0)
+        	{
+        		(*data)->reuse_cnt++;
+        		return 0;
+        	}
+
+        	/* the compressed matrix is reused by the code generation */
+        	compressed = (compressed == 2) ? 1 : 0;
+        }
+
+        MA_FreeCode(&((*data)->Cod));
     }
 
     (*data)->Spa=A;
+    (*data)->complex_mode=0;
+    (*data)->codegen_cnt++;
 
     sdata=(*data);
 
+    if((compressed != 0) &&
+    		(sca_solve_ac_linear_init_complex(sdata, compressed == 1) == 0))
+    {
+    	return 0;
+    }
 
     if (MA_LequSparseCodegen((struct sparse*)A, &(sdata->Cod)) != 0)
     {
         /*printf("solveLSG reports: Error in creating SparseCode!\n");*/
-
     	(*data)->critical_column=sdata->Cod.critical_column;
     	(*data)->critical_row=sdata->Cod.critical_line;
-
-
         return 2;
     }
 
     return 0;
-
 }
 
+
+/**
+ * solves the equation system - B and x are stored as real vectors of
+ * dimension 2n with interleaved real and imaginary parts, B is destroyed
+ */
 int sca_solve_ac_linear(
 		               double* B,
                        double* x,
                        struct sca_solve_ac_linear_data** data
                     )
 {
-	int errc=MA_LequSparseSolut((struct sparse*)((*data)->Spa), &((*data)->Cod), B, x);
+	int errc;
+
+	if((*data)->complex_mode)
+	{
+		return MA_LequSparseSolutComplex((*data)->clu, &((*data)->Cod), B, x);
+	}
+
+	errc=MA_LequSparseSolut((struct sparse*)((*data)->Spa), &((*data)->Cod), B, x);
+
 	if(errc!=0)
 	{
 		(*data)->critical_row=(*data)->Cod.critical_line;
@@ -120,13 +392,117 @@ int sca_solve_ac_linear(
     return errc;
 }
 
+/**
+ * solves the equation system for nrhs right hand sides - B and x are stored
+ * by lines, the real part of line i of the right hand side m is located at
+ * 2*(i*nrhs+m) followed by the imaginary part, B is destroyed - the result
+ * of each right hand side is identical to the result of sca_solve_ac_linear
+ *
+ * n_failed returns the number of right hand sides, which couldn't be solved
+ */
+int sca_solve_ac_linear_multi(
+		               double* B,
+                       double* x,
+                       long nrhs,
+                       long* n_failed,
+                       struct sca_solve_ac_linear_data** data
+                    )
+{
+	int errc, err;
+	long n, i, m;
+	double *b, *y;
+
+	if((*data)->complex_mode)
+	{
+		/* the block is solved with one pass over the factorization */
+		errc = MA_LequSparseSolutComplexMulti((*data)->clu, &((*data)->Cod),
+				nrhs, B, x);
+		(*n_failed) = (errc != 0) ? nrhs : 0;
+		return errc;
+	}
+
+	/* the real system is solved for each right hand side */
+	n = (long)(*data)->Spa->nd / 2;
+
+	(*n_failed) = nrhs;
+
+	b = (double *) malloc((unsigned) (4 * n) * sizeof(double));
+	if(b == NULL) return 2;
+	y = b + 2 * n;
+
+	errc = 0;
+	(*n_failed) = 0;
+	for(m = 0; m < nrhs; m++)
+	{
+		for(i = 0; i < n; i++)
+		{
+			b[2 * i]     = B[2 * (i * nrhs + m)];
+			b[2 * i + 1] = B[2 * (i * nrhs + m) + 1];
+		}
+
+		err = sca_solve_ac_linear(b, y, data);
+		if(err != 0)
+		{
+			errc = err;
+			(*n_failed)++;
+		}
+
+		for(i = 0; i < n; i++)
+		{
+			x[2 * (i * nrhs + m)]     = y[2 * i];
+			x[2 * (i * nrhs + m) + 1] = y[2 * i + 1];
+		}
+	}
+
+	free(b);
+
+	return errc;
+}
+
+
+/**
+ * solves the transposed (not conjugated) equation system A^T x = B, B and x
+ * are stored as sca_solve_ac_linear, B is destroyed
+ */
+int sca_solve_ac_linear_transposed(
+		               double* B,
+                       double* x,
+                       struct sca_solve_ac_linear_data** data
+                    )
+{
+	int errc;
+	long i, n;
+
+	if((*data)->complex_mode)
+	{
+		return MA_LequSparseSolutComplexTrans((*data)->clu, &((*data)->Cod),
+				B, x);
+	}
+
+	/* the transposed real matrix represents the conjugated transposed complex
+	 * matrix, thus conj(x) is the solution for conj(B) */
+	n = (long)(*data)->Spa->nd;
+
+	for(i = 1; i < n; i += 2) B[i] = -B[i];
+
+	errc = MA_LequSparseSolutTrans((struct sparse*)((*data)->Spa),
+			&((*data)->Cod), B, x);
+
+	for(i = 1; i < n; i += 2) x[i] = -x[i];
+
+	return errc;
+}
 
 void sca_solve_ac_linear_free(struct sca_solve_ac_linear_data** data)
 {
     if((*data)!=NULL)
     {
         MA_FreeCode(&((*data)->Cod));
+        MA_FreeSparse(&((*data)->Mag));
+        if((*data)->cval!=NULL) free((*data)->cval);
+        if((*data)->clu!=NULL)  free((*data)->clu);
     }
+
     free (*data);
     (*data)=NULL;
 }
@@ -51,8 +51,11 @@ struct sca_solve_ac_linear_data;
 int sca_solve_ac_linear_init(struct  sparse* A,
                                struct sca_solve_ac_linear_data** data);
 int sca_solve_ac_linear(double* B, double* x,struct sca_solve_ac_linear_data** data);
+int sca_solve_ac_linear_multi(double* B, double* x, long nrhs, long* n_failed, struct sca_solve_ac_linear_data** data);
+int sca_solve_ac_linear_transposed(double* B, double* x,struct sca_solve_ac_linear_data** data);
 void sca_solve_ac_linear_free(struct sca_solve_ac_linear_data** data);
 void sca_solve_ac_get_error_position(struct sca_solve_ac_linear_data* data,long* row,long* column);
+void sca_solve_ac_get_statistics(struct sca_solve_ac_linear_data* data,long* codegen_cnt,long* reuse_cnt);
 
 #ifdef __cplusplus
 }
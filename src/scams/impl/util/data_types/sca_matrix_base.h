@@ -150,6 +150,8 @@ inline void sca_matrix_base<T>::remove()
         {
             sizes[i] =0;
         }
+
+        accessed=true;
     }
 }
 
@@ -281,6 +283,8 @@ inline sca_matrix_base<T>& sca_matrix_base<T>::operator= (const sca_matrix_base<
 template<class T>
 inline T* sca_matrix_base<T>::get_flat()
 {
+	//the values may be changed via the pointer
+	accessed=true;
 	return &matrix[0];
 }
 
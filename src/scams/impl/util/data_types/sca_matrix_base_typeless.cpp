@@ -39,12 +39,16 @@
 /*****************************************************************************/
 
 #include "sca_matrix_base_typeless.h"
+#include <atomic>
 
 namespace sca_util
 {
 namespace sca_implementation
 {
 
+//matrices are also modified by the threads of the AC sweeps
+static std::atomic<unsigned long long> version_counter(0);
+
 
 
 sca_matrix_base_typeless::sca_matrix_base_typeless()       //default matrix
@@ -57,6 +61,7 @@ sca_matrix_base_typeless::sca_matrix_base_typeless()       //default matrix
     auto_sizable=0;
     last_val = -1;
     accessed = true;    //after creation matrix is assumed as changed
+    version  = 0;
     ignore_negative=1;
 }
 
@@ -73,6 +78,7 @@ sca_matrix_base_typeless::sca_matrix_base_typeless(unsigned long x)       //vect
     last_val = x-1;
     ignore_negative=1;
     accessed = true;    //after creation matrix is assumed as changed
+    version  = 0;
 }
 
 
@@ -86,6 +92,7 @@ sca_matrix_base_typeless::sca_matrix_base_typeless(unsigned long y, unsigned lon
     auto_dim = 0;
     ignore_negative=1;
     accessed = true;    //after creation matrix is assumed as changed
+    version  = 0;
     auto_sizable=0;
     last_val = x-1;
 }
@@ -106,6 +113,7 @@ sca_matrix_base_typeless::sca_matrix_base_typeless(const sca_matrix_base_typeles
     auto_sizable=m.auto_sizable;
     last_val = m.last_val;
     accessed = true;
+    version  = 0;
     ignore_negative=m.ignore_negative;
 }
 
@@ -168,9 +176,9 @@ void sca_matrix_base_typeless::set_ignore_negative()
 }
 
 
-void sca_matrix_base_typeless::reset_access_flag()
+void sca_matrix_base_typeless::reset_access_flag() const
 {
-	accessed=false;
+	get_version();
 }
 
 
@@ -179,6 +187,21 @@ bool sca_matrix_base_typeless::get_access_flag() const
 	return accessed;
 }
 
+
+unsigned long long sca_matrix_base_typeless::get_version() const
+{
+	//a non-const access since the last call gets a new version - the access
+	//flag is consumed here, thus any number of users comparing the version
+	//see the change
+	if(accessed)
+	{
+		version=++version_counter;
+		accessed=false;
+	}
+
+	return version;
+}
+
 }
 }
 
@@ -115,7 +115,11 @@ protected:
     bool                square;
     mutable long                last_val;
     unsigned long       dim;      //currently dimension is set to 2 or 1
-    bool                accessed;
+    mutable bool        accessed;
+
+    //modification version, a new version is assigned by get_version
+    //if the matrix was accessed since the last call
+    mutable unsigned long long version;
 
 protected:
 
@@ -138,9 +142,15 @@ protected:
     void reset_ignore_negative();
     void set_ignore_negative();
 
-    void reset_access_flag();
+    //assigns a new version if the matrix was accessed and resets the flag
+    void reset_access_flag() const;
     bool get_access_flag() const;
 
+    //returns the version, a non-const access since the last call assigns a
+    //new version, which is unique for the content of all matrices - a
+    //changed version indicates a non-const access
+    unsigned long long get_version() const;
+
 
 
     friend class sca_core::sca_implementation::sca_linear_solver;
@@ -134,6 +134,13 @@ protected:
 
 	double& B_wr(long a, long b);
 
+	/**
+	 * write access to B - if request_reinitialization is false, the change
+	 * is recorded only and the module requests the reinitialization or the
+	 * Woodbury update itself (e.g. by set_pre_solve_methods)
+	 */
+	double& B_wr(long a, long b, bool request_reinitialization);
+
 
 	const double& A(long a, long b) const;
 	const double& B(long a, long b) const;
@@ -0,0 +1,211 @@
+/*****************************************************************************
+
+    Copyright 2010
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+    Copyright 2015-2020
+    COSEDA Technologies GmbH
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+ netlist_reduction_ladder.cpp - description
+
+ Original Author: Karsten Einwich COSEDA Technologies GmbH
+
+ *****************************************************************************/
+
+/*
+ * R ladder driven by a current source at node 0
+ *
+ *   0 -R- 1 -R- 2 =R= 3 -R- 4 -R- 5 -R|wire- 6 -R- ... -R- 11
+ *   |     |     |     |     |     |          |            |
+ *   R     R     R     R     R     R          R            R
+ *   |     |     |     |     |     |          |            |
+ *  gnd   gnd   gnd   gnd   gnd   gnd        gnd          gnd
+ *
+ * Node 0 (source), node 4 (traced) and node 11 (output) are fixed, the
+ * nodes 5 and 6 are merged by an ideal wire, nodes 2 and 3 are connected
+ * by two parallel resistors. The voltages of the fixed nodes of the reduced
+ * netlist must agree with the modified nodal analysis of the full netlist.
+ */
+
+/*****************************************************************************/
+
+#include "scams/impl/predefined_moc/eln/sca_eln_netlist_reduction.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+using sca_eln::sca_implementation::sca_eln_netlist_reduction;
+
+static const long N=12;
+
+struct resistor
+{
+	long   a;
+	long   b;
+	double r;
+};
+
+//Gaussian elimination with partial pivoting of the dense system A x = b
+static std::vector<double> solve(std::vector<std::vector<double> > A,
+		std::vector<double> b)
+{
+	std::size_t n=b.size();
+
+	for(std::size_t k=0;k<n;++k)
+	{
+		std::size_t p=k;
+		for(std::size_t i=k+1;i<n;++i)
+		{
+			if(std::fabs(A[i][k])>std::fabs(A[p][k])) p=i;
+		}
+		std::swap(A[k],A[p]);
+		std::swap(b[k],b[p]);
+
+		for(std::size_t i=k+1;i<n;++i)
+		{
+			double f=A[i][k]/A[k][k];
+			for(std::size_t j=k;j<n;++j) A[i][j]-=f*A[k][j];
+			b[i]-=f*b[k];
+		}
+	}
+
+	std::vector<double> x(n,0.0);
+	for(std::size_t k=n;k-->0;)
+	{
+		double s=b[k];
+		for(std::size_t j=k+1;j<n;++j) s-=A[k][j]*x[j];
+		x[k]=s/A[k][k];
+	}
+
+	return x;
+}
+
+//conductance stamp (negative nodes: reference)
+static void stamp(std::vector<std::vector<double> >& G, long a, long b,
+		double g)
+{
+	if(a>=0) G[a][a]+=g;
+	if(b>=0) G[b][b]+=g;
+	if((a>=0) && (b>=0))
+	{
+		G[a][b]-=g;
+		G[b][a]-=g;
+	}
+}
+
+int main()
+{
+	std::vector<resistor> res;
+	for(long i=0;i<N;++i)
+	{
+		resistor rp={i,-1,10.0+i};
+		res.push_back(rp);
+
+		if(i+1<N)
+		{
+			resistor rs={i,i+1,1.0+0.1*i};
+			res.push_back(rs);
+		}
+	}
+
+	resistor rpar={2,3,4.0};
+	res.push_back(rpar);
+
+	const long wire_a=5, wire_b=6;
+	const long fixed[]={0,4,N-1};
+	const double isrc=1.0;
+
+	//modified nodal analysis of the full netlist, the wire current is an
+	//additional unknown
+	std::vector<std::vector<double> > A(N+1,std::vector<double>(N+1,0.0));
+	std::vector<double> b(N+1,0.0);
+	for(std::size_t i=0;i<res.size();++i)
+	{
+		stamp(A,res[i].a,res[i].b,1.0/res[i].r);
+	}
+	A[wire_a][N]+=1.0;
+	A[wire_b][N]-=1.0;
+	A[N][wire_a]+=1.0;
+	A[N][wire_b]-=1.0;
+	b[0]=isrc;
+
+	std::vector<double> x=solve(A,b);
+
+	//reduced netlist
+	sca_eln_netlist_reduction reduction(N);
+	for(std::size_t i=0;i<sizeof(fixed)/sizeof(fixed[0]);++i)
+	{
+		reduction.set_fixed(fixed[i]);
+	}
+	reduction.add_wire(wire_a,wire_b);
+	for(std::size_t i=0;i<res.size();++i)
+	{
+		reduction.add_conductance(res[i].a,res[i].b,1.0/res[i].r);
+	}
+	reduction.reduce(3);
+
+	long nr=reduction.get_number_of_nodes();
+
+	std::cout << "netlist reduction: " << N << " nodes, "
+			<< reduction.get_number_of_eliminated_nodes() << " eliminated, "
+			<< nr << " remain, " << reduction.get_conductances().size()
+			<< " conductances" << std::endl;
+
+	int err=0;
+
+	if(nr!=(long)(sizeof(fixed)/sizeof(fixed[0])))
+	{
+		std::cout << "only the fixed nodes must remain" << std::endl;
+		err=1;
+	}
+
+	if(reduction.get_node_number(wire_a)!=reduction.get_node_number(wire_b))
+	{
+		std::cout << "the nodes of the wire must be merged" << std::endl;
+		err=1;
+	}
+
+	std::vector<std::vector<double> > Gr(nr,std::vector<double>(nr,0.0));
+	std::vector<double> br(nr,0.0);
+	const std::vector<sca_eln_netlist_reduction::conductance>& cond(
+			reduction.get_conductances());
+	for(std::size_t i=0;i<cond.size();++i)
+	{
+		stamp(Gr,cond[i].node_a,cond[i].node_b,cond[i].value);
+	}
+	br[reduction.get_node_number(0)]=isrc;
+
+	std::vector<double> xr=solve(Gr,br);
+
+	for(long i=0;i<N;++i)
+	{
+		long k=reduction.get_node_number(i);
+		if(k<0) continue;
+
+		if(std::fabs(xr[k]-x[i])>1e-12*(1.0+std::fabs(x[i])))
+		{
+			std::cout << "node " << i << ": " << xr[k]
+					<< " differs from the full netlist " << x[i] << std::endl;
+			err=1;
+		}
+	}
+
+	return err;
+}
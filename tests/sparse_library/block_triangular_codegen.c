@@ -0,0 +1,223 @@
+/*****************************************************************************
+
+    Copyright 2010
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+ block_triangular_codegen.c - description
+
+ Original Author: Karsten Einwich Fraunhofer IIS/EAS Dresden
+
+ *****************************************************************************/
+
+/*
+ * Feed forward system with the diagonal blocks (dependencies first)
+ *
+ *   {x3} by e4, {x0,x6} by e1,e5, {x2} by e0, {x5} by e6, {x1,x4} by e2,e3
+ *
+ * Equation e0 depends on x0 only, the elimination of the whole matrix would
+ * create a fill-in in column x6. The block by block decomposition (ordering
+ * 3) must not create fill-ins, its solution must agree with the solution of
+ * the Markowitz ordering, also after a refactorization, for the flat code
+ * and for the transposed system.
+ */
+
+/*****************************************************************************/
+
+#include "ma_typedef.h"
+#include "ma_util.h"
+#include "ma_sparse.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define N 7
+
+/*                       x0    x1    x2    x3    x4    x5    x6  */
+static double A0[N*N]={ -1.0,  0.0,  2.0,  0.0,  0.0,  0.0,  0.0,   /* e0 */
+                         4.0,  0.0,  0.0, -1.0,  0.0,  0.0,  1.0,   /* e1 */
+                         0.0,  3.0,  0.0,  0.0,  1.0, -1.0,  0.0,   /* e2 */
+                         0.0, -1.0,  0.0,  0.0,  2.0,  0.0,  1.0,   /* e3 */
+                         0.0,  0.0,  0.0,  3.0,  0.0,  0.0,  0.0,   /* e4 */
+                         1.0,  0.0,  0.0,  0.0,  0.0,  0.0, -5.0,   /* e5 */
+                         0.0,  0.0,  1.0,  1.0,  0.0,  6.0,  0.0 }; /* e6 */
+
+static const double rhs[N]={ 1.0, -2.0, 0.5, 3.0, -1.5, 2.5, 4.0 };
+
+/* maximum of |A x - r| (transposed: |A^T x - r|) */
+static double residual(const double* A, const double* x, int trans)
+{
+	double res=0.0, s;
+	int i, j;
+
+	for(i=0;i<N;i++)
+	{
+		s=-rhs[i];
+		for(j=0;j<N;j++)
+			s+=(trans ? A[j*N+i] : A[i*N+j])*x[j];
+		if(fabs(s)>res) res=fabs(s);
+	}
+
+	return res;
+}
+
+/* sparse matrix of A (stored by lines, MA_ConvertFullToSparse expects the
+ * full matrix stored by columns) */
+static void to_sparse(const double* A, sparse_matrix* sA)
+{
+	double At[N*N];
+	int i, j;
+
+	for(i=0;i<N;i++)
+		for(j=0;j<N;j++)
+			At[j*N+i]=A[i*N+j];
+
+	MA_InitSparse(sA);
+	MA_ConvertFullToSparse(At, N, sA, 0);
+}
+
+/* code generation for A with the ordering, solution x - returns 0 on success */
+static int solve(const double* A, int ordering, sparse_matrix* sA,
+		struct spcode* code, double* x)
+{
+	double r[N];
+
+	to_sparse(A, sA);
+	MA_InitCode(code);
+
+	code->ordering=ordering;
+	if(MA_LequSparseCodegen(sA, code)) return 1;
+
+	memcpy(r, rhs, sizeof(r));
+	return MA_LequSparseSolut(sA, code, r, x);
+}
+
+int main(void)
+{
+	sparse_matrix sA, sM, sB;
+	struct spcode code, mcode;
+	struct spflat flat;
+	double A1[N*N];
+	double x[N], xm[N], xf[N], r[N];
+	int i, err=0;
+
+	/* block by block and Markowitz ordering */
+	if(solve(A0, 3, &sA, &code, x) || solve(A0, 0, &sM, &mcode, xm))
+	{
+		printf("code generation failed\n");
+		return 1;
+	}
+
+	printf("%li diagonal blocks, %li of size 1, %li non-zeros before and "
+			"%li after factorization\n", code.nblocks, code.nsingle,
+			code.fill_ins, code.fill_ins_after_dec);
+
+	if((code.nblocks!=5) || (code.nsingle!=3))
+	{
+		printf("wrong block triangular form\n");
+		err=1;
+	}
+
+	if(code.fill_ins_after_dec!=code.fill_ins)
+	{
+		printf("fill-ins outside of the diagonal blocks\n");
+		err=1;
+	}
+
+	for(i=0;i<N;i++)
+	{
+		if(fabs(x[i]-xm[i])>1e-12*(1.0+fabs(xm[i])))
+		{
+			printf("x%i: %e differs from the Markowitz solution %e\n",
+					i, x[i], xm[i]);
+			err=1;
+		}
+	}
+
+	if(residual(A0, x, 0)>1e-12)
+	{
+		printf("residual of the block solution too large\n");
+		err=1;
+	}
+
+	/* flat code of the blocks must give the same result */
+	MA_InitFlatCode(&flat);
+	if(MA_LequSparseLower(&sA, &code, &flat))
+	{
+		printf("the block code can't be lowered\n");
+		err=1;
+	}
+	else
+	{
+		memcpy(r, rhs, sizeof(r));
+		MA_LequSparseSolutFlat(&flat, r, xf);
+		if(memcmp(x, xf, sizeof(x))!=0)
+		{
+			printf("the flat code differs from the solution code\n");
+			err=1;
+		}
+	}
+
+	/* transposed system */
+	if(MA_LequSparseSolutTrans(&sA, &code, (double*)rhs, x)
+			|| residual(A0, x, 1)>1e-12)
+	{
+		printf("transposed solution of the block code failed\n");
+		err=1;
+	}
+
+	/* refactorization with new values of the same structure */
+	for(i=0;i<N*N;i++)
+		A1[i]=(A0[i]!=0.0) ? A0[i]*(1.0+0.1*(i%5)) : 0.0;
+
+	to_sparse(A1, &sB);
+	if(MA_LequSparseRefactor(&sA, &sB, &code))
+	{
+		printf("refactorization of the block code failed\n");
+		err=1;
+	}
+	else
+	{
+		memcpy(r, rhs, sizeof(r));
+		MA_LequSparseSolut(&sA, &code, r, x);
+		if(residual(A1, x, 0)>1e-12)
+		{
+			printf("residual after refactorization too large\n");
+			err=1;
+		}
+
+		MA_LequSparseLowerValues(&sA, &flat);
+		memcpy(r, rhs, sizeof(r));
+		MA_LequSparseSolutFlat(&flat, r, xf);
+		if(memcmp(x, xf, sizeof(x))!=0)
+		{
+			printf("the flat code differs after refactorization\n");
+			err=1;
+		}
+	}
+
+	MA_FreeFlatCode(&flat);
+	MA_FreeCode(&code);
+	MA_FreeCode(&mcode);
+	MA_FreeSparse(&sA);
+	MA_FreeSparse(&sM);
+	MA_FreeSparse(&sB);
+
+	return err;
+}
@@ -0,0 +1,167 @@
+/*****************************************************************************
+
+    Copyright 2010
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+ factorization_cache_pwl.c - description
+
+ Original Author: Karsten Einwich Fraunhofer IIS/EAS Dresden
+
+ *****************************************************************************/
+
+/*
+ * RC ladder with a piece-wise linear conductance between the nodes. The
+ * reinitializations of the pwl sub-intervals are repeated with recurring
+ * pairs of step size and segment, like the pwl iteration of the linear
+ * solver does (key of the active segments, see reinit_pwl). The recurring
+ * sub-intervals must be found in the factorization cache and the results
+ * must be identical to the results without cache.
+ */
+
+/*****************************************************************************/
+
+#include "ana_solv_data.h"
+#include "ma_typedef.h"
+#include "ma_util.h"
+#include "ma_sparse.h"
+#include "linear_analog_solver.h"
+#include <stdio.h>
+#include <string.h>
+
+#define N_SUBINTERVALS 10
+
+/* sequence of sub-intervals: active segment and step size */
+static const int    segments[N_SUBINTERVALS]=
+	{ 0,      0,      0,      1,      0,      1,      1,      0,      0,      1 };
+static const double steps[N_SUBINTERVALS]=
+	{ 1.0e-6, 0.5e-6, 1.0e-6, 1.0e-6, 1.0e-6, 0.5e-6, 1.0e-6, 0.5e-6, 1.0e-6, 0.5e-6 };
+
+/* conductance of the pwl element per segment */
+static const double g_pwl[2]={ 1.0e-3, 1.0e-1 };
+
+static void setup_B(double* B, int segment)
+{
+	double g1=1.0e-3;
+	double g2=2.0e-3;
+	double g=g_pwl[segment];
+
+	B[0]=g1+g;  B[1]=-g;
+	B[2]=-g;    B[3]=g+g2;
+}
+
+/* solves the sequence of sub-intervals, the results of all steps are
+ * written to x_res (2*N_SUBINTERVALS el.) - returns 0 on success */
+static int solve_sequence(long cache_size, double* x_res, long* hits, long* misses)
+{
+	double A[4]={ 1.0e-9, 0.0, 0.0, 2.0e-9 };
+	double B[4];
+	double q[2]={ -1.0e-3, 0.0 };
+	double x[2]={ 0.0, 0.0 };
+	sparse_matrix sA, sB;
+	sca_solv_data* sdata=NULL;
+	int i, err;
+
+	setup_B(B,segments[0]);
+
+	MA_InitSparse(&sA);
+	MA_InitSparse(&sB);
+	MA_ConvertFullToSparse(A, 2, &sA, 0);
+	MA_ConvertFullToSparse(B, 2, &sB, 0);
+
+	err=ana_alloc_solver_data(&sdata);
+	if(err) return err;
+
+	ana_set_factorization_cache_size(sdata, cache_size);
+	ana_set_factorization_key(sdata, (unsigned long long)segments[0]+1, 1);
+
+	err=ana_init_sparse(&sA, &sB, steps[0], &sdata, 0);
+
+	for(i=0;(i<N_SUBINTERVALS) && !err;i++)
+	{
+		if(i>0)
+		{
+			setup_B(B,segments[i]);
+			MA_FreeSparse(&sB);
+			MA_InitSparse(&sB);
+			MA_ConvertFullToSparse(B, 2, &sB, 0);
+
+			ana_set_factorization_key(sdata, (unsigned long long)segments[i]+1, 1);
+			err=ana_reinit_sparse(&sA, &sB, steps[i], &sdata, 2);
+			if(err) break;
+		}
+
+		ana_solv(q, x, sdata);
+
+		x_res[2*i]=x[0];
+		x_res[2*i+1]=x[1];
+	}
+
+	ana_get_factorization_cache_statistics(sdata, hits, misses);
+
+	ana_free_solver_data(&sdata);
+	MA_FreeSparse(&sA);
+	MA_FreeSparse(&sB);
+
+	return err;
+}
+
+int main(void)
+{
+	double x_cached[2*N_SUBINTERVALS];
+	double x_uncached[2*N_SUBINTERVALS];
+	long hits, misses, hits_uncached, misses_uncached;
+	int err;
+
+	err=solve_sequence(0, x_uncached, &hits_uncached, &misses_uncached);
+	if(err)
+	{
+		printf("solving without cache failed with code: %i\n", err);
+		return 1;
+	}
+
+	err=solve_sequence(8, x_cached, &hits, &misses);
+	if(err)
+	{
+		printf("solving with cache failed with code: %i\n", err);
+		return 1;
+	}
+
+	printf("cache hits: %li misses: %li\n", hits, misses);
+
+	if(hits_uncached!=0)
+	{
+		printf("the disabled cache reports %li hits\n", hits_uncached);
+		return 1;
+	}
+
+	if(hits==0)
+	{
+		printf("the recurring sub-intervals are not found in the cache\n");
+		return 1;
+	}
+
+	if(memcmp(x_cached, x_uncached, sizeof(x_cached))!=0)
+	{
+		printf("the results with cache differ from the results without cache\n");
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,178 @@
+/*****************************************************************************
+
+    Copyright 2010
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+ solv_batch_instances.c - description
+
+ Original Author: Karsten Einwich Fraunhofer IIS/EAS Dresden
+
+ *****************************************************************************/
+
+/*
+ * RLC band pass driven by a sine source, N_INST instances with different
+ * amplitudes and phases share one solver data:
+ *
+ *   x0: voltage of the capacitor, x1: current of the inductor,
+ *   x2: output voltage at the load resistor
+ *
+ * The batch solution (ana_solv_batch, vectors stored by lines) of all
+ * instances must agree with the solution of each instance by ana_solv for
+ * the methods trapezoidal rule and BDF2, including the initial Euler steps.
+ */
+
+/*****************************************************************************/
+
+#include "ana_solv_data.h"
+#include "ma_typedef.h"
+#include "ma_util.h"
+#include "ma_sparse.h"
+#include "linear_analog_solver.h"
+#include <stdio.h>
+#include <math.h>
+
+#define N 3
+#define N_INST 5
+#define STEPS 50
+#define DT 1.0e-6
+
+/*                     x0      x1     x2  */
+static double A[N*N]={ 1.0e-9, 0.0,   0.0,		/* C x0' - x1 = 0 */
+                       0.0,    1.0e-6, 0.0,		/* L x1' + x0 + x2 = u */
+                       0.0,    0.0,   0.0 };	/* x2/R - x1 = 0 */
+
+static double B[N*N]={ 0.0,    -1.0,  0.0,
+                       1.0,    0.0,   1.0,
+                       0.0,    -1.0,  1.0e-2 };
+
+/* sparse matrix of the full matrix M stored by lines */
+static void to_sparse(const double* M, sparse_matrix* sM)
+{
+	double Mt[N*N];
+	int i, j;
+
+	for(i=0;i<N;i++)
+		for(j=0;j<N;j++)
+			Mt[j*N+i]=M[i*N+j];
+
+	MA_InitSparse(sM);
+	MA_ConvertFullToSparse(Mt, N, sM, 0);
+}
+
+/* source of instance c at step k */
+static double source(int c, int k)
+{
+	return (1.0+c)*sin(2.0*M_PI*5.0e4*k*DT+0.7*c);
+}
+
+/* returns the maximum relative difference of the batch and the instance
+ * solutions or a value <0 on error */
+static double compare(int alg)
+{
+	sparse_matrix sA, sB;
+	sca_solv_data* batch=NULL;
+	sca_solv_data* single[N_INST];
+	double q[N*N_INST], x[N*N_INST], xp[N*N_INST];
+	double qs[N], xs[N_INST][N];
+	double d, diff=0.0;
+	int i, c, k, err=0;
+
+	to_sparse(A, &sA);
+	to_sparse(B, &sB);
+
+	err=ana_alloc_solver_data(&batch);
+	if(!err) ana_set_algorithm(batch, alg);
+	if(!err) err=ana_init_sparse(&sA, &sB, DT, &batch, 0);
+
+	for(c=0;c<N_INST;c++)
+	{
+		single[c]=NULL;
+		if(!err) err=ana_alloc_solver_data(&single[c]);
+		if(!err) ana_set_algorithm(single[c], alg);
+		if(!err) err=ana_init_sparse(&sA, &sB, DT, &single[c], 0);
+
+		for(i=0;i<N;i++)
+		{
+			xs[c][i]=0.0;
+			x[i*N_INST+c]=0.0;
+			xp[i*N_INST+c]=0.0;
+		}
+	}
+
+	for(k=1;(k<=STEPS) && !err;k++)
+	{
+		for(c=0;c<N_INST;c++)
+		{
+			/* the source is the right-hand side of the inductor equation */
+			qs[0]=0.0;
+			qs[1]=-source(c,k);
+			qs[2]=0.0;
+
+			for(i=0;i<N;i++) q[i*N_INST+c]=qs[i];
+
+			ana_solv(qs, xs[c], single[c]);
+		}
+
+		err=ana_solv_batch(q, x, xp, N_INST, batch);
+
+		for(c=0;(c<N_INST) && !err;c++)
+		{
+			for(i=0;i<N;i++)
+			{
+				d=fabs(x[i*N_INST+c]-xs[c][i])/(1e-6+fabs(xs[c][i]));
+				if(d>diff) diff=d;
+			}
+		}
+	}
+
+	for(c=0;c<N_INST;c++) ana_free_solver_data(&single[c]);
+	ana_free_solver_data(&batch);
+	MA_FreeSparse(&sA);
+	MA_FreeSparse(&sB);
+
+	if(err)
+	{
+		printf("solving the batch failed with code: %i\n", err);
+		return -1.0;
+	}
+
+	return diff;
+}
+
+int main(void)
+{
+	double diff_trapez, diff_bdf2;
+
+	diff_trapez=compare(1);
+	diff_bdf2=compare(2);
+
+	printf("maximum difference of batch and instance solution: "
+			"trapezoidal %e  BDF2 %e\n", diff_trapez, diff_bdf2);
+
+	if((diff_trapez<0.0) || (diff_bdf2<0.0)) return 1;
+
+	if((diff_trapez>1e-12) || (diff_bdf2>1e-12))
+	{
+		printf("the batch solution differs from the instance solution\n");
+		return 1;
+	}
+
+	return 0;
+}
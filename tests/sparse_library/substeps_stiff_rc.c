@@ -0,0 +1,179 @@
+/*****************************************************************************
+
+    Copyright 2010
+    Fraunhofer-Gesellschaft zur Foerderung der angewandten Forschung e.V.
+
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+ *****************************************************************************/
+
+/*****************************************************************************
+
+ substeps_stiff_rc.c - description
+
+ Original Author: Karsten Einwich Fraunhofer IIS/EAS Dresden
+
+ *****************************************************************************/
+
+/*
+ * RC low pass with a time constant far below the global timestep:
+ *
+ *   C v' + v/R - u/R = 0,  u ramps from 0 to 1 during the first global step
+ *
+ * The full global step must be rejected and refined by ana_solv_substeps,
+ * the result must be more accurate than a single step. The sub-step sizes
+ * are dt/2^k, thus their factorizations must be found in the cache.
+ */
+
+/*****************************************************************************/
+
+#include "ana_solv_data.h"
+#include "ma_typedef.h"
+#include "ma_util.h"
+#include "ma_sparse.h"
+#include "linear_analog_solver.h"
+#include <stdio.h>
+#include <math.h>
+
+#define RC_R   1.0e3
+#define RC_C   1.0e-9	/* tau = 1 us */
+#define RC_DT  1.0e-4	/* global timestep = 100 tau */
+#define RC_STEPS 3
+
+/* exact solution for the input u(t) = min(t/dt,1), v(0)=0 */
+static double rc_exact(double t)
+{
+	double tau=RC_R*RC_C;
+
+	if(t<=RC_DT)
+		return (t-tau+tau*exp(-t/tau))/RC_DT;
+
+	return 1.0-(1.0-rc_exact(RC_DT))*exp(-(t-RC_DT)/tau);
+}
+
+/* solves RC_STEPS global steps, with sub-steps if ss!=NULL, returns the
+ * maximum error at the global timepoints or a value <0 on error and the
+ * statistics of the factorization cache */
+static double rc_solve(sca_substep_data* ss, long* hits, long* misses)
+{
+	double A[1]={ RC_C };
+	double B[1]={ 1.0/RC_R };
+	double q_last[1]={ 0.0 };
+	double q[1]={ -1.0/RC_R };
+	double x[1]={ 0.0 };
+	double max_err=0.0;
+	sparse_matrix sA, sB;
+	sca_solv_data* sdata=NULL;
+	int i, err;
+
+	MA_InitSparse(&sA);
+	MA_InitSparse(&sB);
+	MA_ConvertFullToSparse(A, 1, &sA, 0);
+	MA_ConvertFullToSparse(B, 1, &sB, 0);
+
+	/* the factorizations of the sub-step sizes are reused from the cache */
+	err=ana_alloc_solver_data(&sdata);
+	if(!err)
+	{
+		ana_set_factorization_cache_size(sdata, 4);
+		ana_set_factorization_key(sdata, 0, 1);
+		err=ana_init_sparse(&sA, &sB, RC_DT, &sdata, 0);
+	}
+
+	for(i=0;(i<RC_STEPS) && !err;i++)
+	{
+		double e;
+
+		if(ss!=NULL)
+		{
+			err=ana_solv_substeps(&sA, &sB, q_last, q, x, RC_DT, &sdata, ss);
+		}
+		else
+		{
+			ana_solv(q, x, sdata);
+		}
+
+		e=fabs(x[0]-rc_exact((i+1)*RC_DT));
+		if(e>max_err) max_err=e;
+
+		q_last[0]=q[0];
+	}
+
+	(*hits)=0;
+	(*misses)=0;
+	if(sdata!=NULL) ana_get_factorization_cache_statistics(sdata, hits, misses);
+
+	ana_free_solver_data(&sdata);
+	MA_FreeSparse(&sA);
+	MA_FreeSparse(&sB);
+
+	if(err)
+	{
+		printf("solving the RC low pass failed with code: %i\n", err);
+		return -1.0;
+	}
+
+	return max_err;
+}
+
+int main(void)
+{
+	sca_substep_data* ss=NULL;
+	long steps, rejections;
+	long hits, misses;
+	double min_h;
+	double err_single, err_substeps;
+
+	err_single=rc_solve(NULL, &hits, &misses);
+
+	if(ana_alloc_substep_data(&ss)) return 1;
+	ana_set_substep_tolerances(ss, 1e-4, 1e-6);
+
+	err_substeps=rc_solve(ss, &hits, &misses);
+	ana_get_substep_statistics(ss, &steps, &rejections, &min_h);
+	ana_free_substep_data(&ss);
+
+	printf("single step error: %e  sub-step error: %e\n", err_single, err_substeps);
+	printf("%li sub-steps, %li rejected, minimum sub-step: %e\n", steps, rejections, min_h);
+	printf("factorization cache: %li hits, %li misses\n", hits, misses);
+
+	if((err_single<0.0) || (err_substeps<0.0)) return 1;
+
+	if(rejections==0)
+	{
+		printf("the global step of the stiff RC was not rejected\n");
+		return 1;
+	}
+
+	if((steps<=RC_STEPS) || (min_h>=RC_DT))
+	{
+		printf("the global step of the stiff RC was not refined\n");
+		return 1;
+	}
+
+	if(err_substeps>1e-3 || err_substeps>=err_single)
+	{
+		printf("the sub-steps are not more accurate than a single step\n");
+		return 1;
+	}
+
+	/* the sub-step sizes are dt/2^k, thus the factorizations are reused */
+	if(hits<=misses)
+	{
+		printf("the factorizations of the sub-steps are not reused\n");
+		return 1;
+	}
+
+	return 0;
+}